@@ -0,0 +1,19 @@
+#include "time.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <chrono>
+
+namespace v1util::bench {
+
+void tscStampOverhead() {
+  for(int i = 0; i < 1000; ++i) sltbench::DoNotOptimize(tscStamp());
+}
+SLTBENCH_FUNCTION(tscStampOverhead);
+
+void steadyClockOverhead() {
+  for(int i = 0; i < 1000; ++i) sltbench::DoNotOptimize(std::chrono::steady_clock::now());
+}
+SLTBENCH_FUNCTION(steadyClockOverhead);
+
+}  // namespace v1util::bench
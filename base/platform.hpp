@@ -46,3 +46,18 @@
 #else
 #  error unknown CPU architecture
 #endif
+
+
+/* instruction sets: */
+// clang only knows target_clones from version 14 on
+#if defined(V1_ARCH_AMD64) && defined(V1_OS_LINUX) && defined(__has_attribute)
+#  if __has_attribute(target_clones)
+#    define V1_HAS_TARGET_CLONES 1
+#  endif
+#endif
+#if defined(V1_HAS_TARGET_CLONES)
+//! Compile a function for several instruction sets; the loader picks one for the CPU
+#  define V1_TARGET_CLONES __attribute__((target_clones("default", "avx2", "avx512f")))
+#else
+#  define V1_TARGET_CLONES
+#endif
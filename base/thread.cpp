@@ -16,6 +16,7 @@
 #    include <pthread.h>
 #  elif defined(V1_OS_FREEBSD)
 #    include <pthread_np.h>
+#    include <sys/cpuset.h>
 #  endif
 #  include <sched.h>
 #  include <unistd.h>
@@ -39,6 +40,17 @@ void yield() {
   ::Sleep(0);
 }
 
+bool setCurrentThreadAffinity(unsigned int cpuIndex) {
+  if(cpuIndex >= 8 * sizeof(DWORD_PTR)) return false;
+  return ::SetThreadAffinityMask(::GetCurrentThread(), DWORD_PTR(1) << cpuIndex) != 0;
+}
+
+bool setCurrentThreadPriority(ThreadPriority priority) {
+  const auto winPriority =
+      priority == ThreadPriority::kHigh ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_NORMAL;
+  return ::SetThreadPriority(::GetCurrentThread(), winPriority) != 0;
+}
+
 void Thread::setName(std::string_view name) {
   if(name.empty()) {
     ::SetThreadDescription(::GetCurrentThread(), L"");
@@ -63,6 +75,29 @@ void yield() {
   ::sched_yield();
 }
 
+bool setCurrentThreadAffinity(unsigned int cpuIndex) {
+#  if defined(V1_OS_LINUX)
+  cpu_set_t cpuSet;
+#  elif defined(V1_OS_FREEBSD)
+  cpuset_t cpuSet;
+#  endif
+  if(cpuIndex >= CPU_SETSIZE) return false;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(cpuIndex, &cpuSet);
+  return ::pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+}
+
+bool setCurrentThreadPriority(ThreadPriority priority) {
+  sched_param param;
+  memset(&param, 0, sizeof(param));
+  auto policy = SCHED_OTHER;
+  if(priority == ThreadPriority::kHigh) {
+    policy = SCHED_FIFO;
+    param.sched_priority = (sched_get_priority_min(policy) + sched_get_priority_max(policy)) / 2;
+  }
+  return ::pthread_setschedparam(pthread_self(), policy, &param) == 0;
+}
+
 void Thread::setName(std::string_view name) {
   auto pBuf = (char*)V1_ALLOCA(name.size() + 1);
   memcpy(pBuf, name.data(), name.size());
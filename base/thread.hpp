@@ -10,6 +10,16 @@ namespace v1util {
 V1_PUBLIC void sleepMs(unsigned int dT);
 V1_PUBLIC void yield();
 
+enum class ThreadPriority {
+  kNormal,
+  kHigh,  //!< Real-time scheduling where supported; usually requires elevated privileges
+};
+
+//! Pin the calling thread to the logical CPU @p cpuIndex. Returns false on failure.
+V1_PUBLIC bool setCurrentThreadAffinity(unsigned int cpuIndex);
+//! Returns false on failure, e.g. lacking privileges.
+V1_PUBLIC bool setCurrentThreadPriority(ThreadPriority priority);
+
 //! The thread without pitfalls
 class Thread : public std::thread {
  public:
@@ -33,7 +43,5 @@ class Thread : public std::thread {
   }
 
   void setName(std::string_view name);
-
-  // TODO: Add support for priorities
 };
 }  // namespace v1util
@@ -0,0 +1,102 @@
+#include "thread_pool.hpp"
+
+#include "debug.hpp"
+
+#include <thread>
+
+namespace v1util {
+
+namespace {
+thread_local bool tIsInTask = false;
+}
+
+ThreadPool::ThreadPool(unsigned int numWorkers) {
+  if(numWorkers == ~0U) {
+    const auto numCpus = std::thread::hardware_concurrency();
+    numWorkers = numCpus > 1 ? numCpus - 1 : 0;
+  }
+
+  mWorkers.reserve(numWorkers);
+  for(unsigned int i = 0; i < numWorkers; ++i) mWorkers.emplace_back([this]() { workerMain(); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mQuit = true;
+  }
+  mWakeUp.notify_all();
+  for(auto& worker : mWorkers) worker.join();
+}
+
+void ThreadPool::parallelFor(size_t numTasks, Delegate<void(size_t)> task) {
+  if(!numTasks) return;
+  if(mWorkers.empty() || numTasks == 1 || tIsInTask) {
+    for(size_t i = 0; i < numTasks; ++i) task(i);
+    return;
+  }
+
+  std::lock_guard<std::mutex> jobLock(mJobMutex);
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mTask = task;
+    mNumTasks = numTasks;
+    mNextTask.store(0);
+    mNumDone.store(0);
+    ++mJobGeneration;
+  }
+  mWakeUp.notify_all();
+
+  runTasks(task, numTasks);
+
+  // workers that joined late must not see the next job's task with this job's size:
+  std::unique_lock<std::mutex> lock(mMutex);
+  mJobDone.wait(lock, [&]() { return mNumDone.load() == numTasks && !mNumActiveWorkers; });
+  mTask = {};
+  mNumTasks = 0;
+}
+
+ThreadPool& ThreadPool::global() {
+  static ThreadPool sPool;
+  return sPool;
+}
+
+void ThreadPool::workerMain() {
+  uint64_t seenGeneration = 0;
+  while(true) {
+    Delegate<void(size_t)> task;
+    size_t numTasks = 0;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mWakeUp.wait(lock, [&]() { return mQuit || mJobGeneration != seenGeneration; });
+      if(mQuit) return;
+      seenGeneration = mJobGeneration;
+      if(!mNumTasks) continue;  // that job is over already
+
+      ++mNumActiveWorkers;
+      task = mTask;
+      numTasks = mNumTasks;
+    }
+
+    runTasks(task, numTasks);
+
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      --mNumActiveWorkers;
+    }
+    mJobDone.notify_all();
+  }
+}
+
+void ThreadPool::runTasks(Delegate<void(size_t)> task, size_t numTasks) noexcept {
+  tIsInTask = true;
+  size_t numDone = 0;
+  for(auto iTask = mNextTask++; iTask < numTasks; iTask = mNextTask++) {
+    task(iTask);
+    ++numDone;
+  }
+  tIsInTask = false;
+  mNumDone += numDone;
+}
+
+}  // namespace v1util
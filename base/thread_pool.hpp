@@ -0,0 +1,61 @@
+#pragma once
+
+#include "cpppainrelief.hpp"
+#include "platform.hpp"
+
+#include "v1util/callable/delegate.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace v1util {
+
+/** Fork-join pool for data-parallel loops
+ *
+ * The calling thread participates in the work, so a pool with 0 workers runs everything
+ * serially. Calls of parallelFor() from different threads are serialized; calls from within a
+ * task run serially on the calling worker.
+ */
+class ThreadPool {
+ public:
+  //! @p numWorkers additional threads; ~0U for one less than the number of logical CPUs
+  V1_PUBLIC explicit ThreadPool(unsigned int numWorkers = ~0U);
+  V1_PUBLIC ~ThreadPool();
+  V1_NO_CP_NO_MV(ThreadPool);
+
+  //! The workers plus the calling thread
+  unsigned int concurrency() const noexcept { return unsigned(mWorkers.size()) + 1; }
+
+  //! Call @p task for every index in [0, numTasks) and wait until all are done
+  V1_PUBLIC void parallelFor(size_t numTasks, Delegate<void(size_t)> task);
+
+  //! A shared pool, created on first use
+  V1_PUBLIC static ThreadPool& global();
+
+ private:
+  void workerMain();
+  void runTasks(Delegate<void(size_t)> task, size_t numTasks) noexcept;
+
+  std::vector<std::thread> mWorkers;
+
+  std::mutex mJobMutex;  // serializes parallelFor()
+  std::mutex mMutex;
+  std::condition_variable mWakeUp;
+  std::condition_variable mJobDone;
+  uint64_t mJobGeneration = 0;
+  bool mQuit = false;
+
+  // the current job, guarded by mMutex:
+  Delegate<void(size_t)> mTask;
+  size_t mNumTasks = 0;
+  unsigned int mNumActiveWorkers = 0;
+
+  std::atomic<size_t> mNextTask = 0;
+  std::atomic<size_t> mNumDone = 0;
+};
+
+}  // namespace v1util
@@ -0,0 +1,44 @@
+#include "thread_pool.hpp"
+
+#include "doctest/doctest.h"
+
+#include <atomic>
+#include <vector>
+
+namespace v1util { namespace test {
+
+TEST_CASE("ThreadPool-parallelFor") {
+  ThreadPool pool(3);
+  CHECK(pool.concurrency() == 4);
+
+  for(size_t numTasks : {0, 1, 2, 7, 1000}) {
+    std::vector<int> calls(numTasks, 0);
+    pool.parallelFor(numTasks, [&](size_t iTask) { calls[iTask]++; });
+    for(auto numCalls : calls) CHECK(numCalls == 1);
+  }
+
+  // back to back jobs of different sizes must not leak tasks into each other
+  std::atomic<size_t> sum = 0;
+  for(size_t iJob = 0; iJob < 200; ++iJob)
+    pool.parallelFor(iJob % 5 + 1, [&](size_t iTask) { sum += iTask + 1; });
+  size_t expected = 0;
+  for(size_t iJob = 0; iJob < 200; ++iJob) expected += (iJob % 5 + 1) * (iJob % 5 + 2) / 2;
+  CHECK(sum.load() == expected);
+}
+
+TEST_CASE("ThreadPool-nested_and_serial") {
+  ThreadPool pool(2);
+  std::atomic<int> numCalls = 0;
+  pool.parallelFor(4, [&](size_t) {
+    pool.parallelFor(3, [&](size_t) { numCalls++; });
+  });
+  CHECK(numCalls.load() == 12);
+
+  ThreadPool serialPool(0);
+  CHECK(serialPool.concurrency() == 1);
+  int serialCalls = 0;
+  serialPool.parallelFor(5, [&](size_t) { serialCalls++; });
+  CHECK(serialCalls == 5);
+}
+
+}}  // namespace v1util::test
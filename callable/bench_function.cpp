@@ -0,0 +1,160 @@
+#include "delegate.hpp"
+#include "function-allocator.hpp"
+#include "function.hpp"
+#include "static-dispatch.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace v1util::bench {
+
+namespace {
+constexpr const int kNumCalls = 1000;
+
+class Accumulator {
+ public:
+  int add(int x) { return mSum += x; }
+
+ private:
+  int mSum = 0;
+};
+
+int sFreeFunction(int x) {
+  return x + 1;
+}
+
+Accumulator sAccumulator;
+
+//! Per-sample processing stages, as in a fixed DSP graph
+class Stage {
+ public:
+  void process(float& sample) { sample = sample * mGain + mOffset; }
+
+ private:
+  float mGain = 0.5F;
+  float mOffset = 0.25F;
+};
+
+Stage sStages[4];
+}  // namespace
+
+/*
+ * The callables are created once, outside of the timed loops, and passed through DoNotOptimize()
+ * so that the compiler cannot devirtualise the call.
+ */
+
+void functionCallMemFn() {
+  auto fn = Function<int(int)>::bind<&Accumulator::add>(&sAccumulator);
+  sltbench::DoNotOptimize(fn);
+  for(int i = 0; i < kNumCalls; ++i) sltbench::DoNotOptimize(fn(i));
+}
+SLTBENCH_FUNCTION(functionCallMemFn);
+
+void stdFunctionCallMemFn() {
+  auto fn = std::function<int(int)>([](int x) { return sAccumulator.add(x); });
+  sltbench::DoNotOptimize(fn);
+  for(int i = 0; i < kNumCalls; ++i) sltbench::DoNotOptimize(fn(i));
+}
+SLTBENCH_FUNCTION(stdFunctionCallMemFn);
+
+void delegateCallMemFn() {
+  auto fn = Delegate<int(int)>::bind<&Accumulator::add>(&sAccumulator);
+  sltbench::DoNotOptimize(fn);
+  for(int i = 0; i < kNumCalls; ++i) sltbench::DoNotOptimize(fn(i));
+}
+SLTBENCH_FUNCTION(delegateCallMemFn);
+
+void functionCallFreeFn() {
+  auto fn = Function<int(int)>(&sFreeFunction);
+  sltbench::DoNotOptimize(fn);
+  for(int i = 0; i < kNumCalls; ++i) sltbench::DoNotOptimize(fn(i));
+}
+SLTBENCH_FUNCTION(functionCallFreeFn);
+
+void stdFunctionCallFreeFn() {
+  auto fn = std::function<int(int)>(&sFreeFunction);
+  sltbench::DoNotOptimize(fn);
+  for(int i = 0; i < kNumCalls; ++i) sltbench::DoNotOptimize(fn(i));
+}
+SLTBENCH_FUNCTION(stdFunctionCallFreeFn);
+
+void delegateCallFreeFn() {
+  auto fn = Delegate<int(int)>(&sFreeFunction);
+  sltbench::DoNotOptimize(fn);
+  for(int i = 0; i < kNumCalls; ++i) sltbench::DoNotOptimize(fn(i));
+}
+SLTBENCH_FUNCTION(delegateCallFreeFn);
+
+
+//! Construction + destruction of a callable that doesn't fit the small buffer
+void functionCreateHeapBased() {
+  std::array<int, 8> state = {};
+  for(int i = 0; i < kNumCalls; ++i) {
+    state[0] = i;
+    auto fn = Function<int(int)>([state](int x) { return x + state[0]; });
+    sltbench::DoNotOptimize(fn);
+  }
+}
+SLTBENCH_FUNCTION(functionCreateHeapBased);
+
+void stdFunctionCreateHeapBased() {
+  std::array<int, 8> state = {};
+  for(int i = 0; i < kNumCalls; ++i) {
+    state[0] = i;
+    auto fn = std::function<int(int)>([state](int x) { return x + state[0]; });
+    sltbench::DoNotOptimize(fn);
+  }
+}
+SLTBENCH_FUNCTION(stdFunctionCreateHeapBased);
+
+void functionCreateHeapBasedPooled() {
+  static FunctionPoolAllocator sPool(16);
+  FunctionAllocatorScope scope(&sPool);
+  std::array<int, 8> state = {};
+  for(int i = 0; i < kNumCalls; ++i) {
+    state[0] = i;
+    auto fn = Function<int(int)>([state](int x) { return x + state[0]; });
+    sltbench::DoNotOptimize(fn);
+  }
+}
+SLTBENCH_FUNCTION(functionCreateHeapBasedPooled);
+
+//! The same callable, stored in a Function with enough inline capacity
+void functionCreateInline() {
+  std::array<int, 8> state = {};
+  for(int i = 0; i < kNumCalls; ++i) {
+    state[0] = i;
+    auto fn = Function<int(int), sizeof(state)>([state](int x) { return x + state[0]; });
+    sltbench::DoNotOptimize(fn);
+  }
+}
+SLTBENCH_FUNCTION(functionCreateInline);
+
+
+void staticDispatchListPerSample() {
+  const auto graph = StaticDispatchList<void(float&), &Stage::process, &Stage::process,
+      &Stage::process, &Stage::process>(&sStages[0], &sStages[1], &sStages[2], &sStages[3]);
+  float sample = 1.F;
+  for(int i = 0; i < kNumCalls; ++i) {
+    graph(sample);
+    sltbench::DoNotOptimize(sample);
+  }
+}
+SLTBENCH_FUNCTION(staticDispatchListPerSample);
+
+void delegateListPerSample() {
+  std::vector<Delegate<void(float&)>> graph;
+  for(auto& stage : sStages) graph.push_back(Delegate<void(float&)>::bind<&Stage::process>(&stage));
+  sltbench::DoNotOptimize(graph);
+  float sample = 1.F;
+  for(int i = 0; i < kNumCalls; ++i) {
+    for(const auto& stage : graph) stage(sample);
+    sltbench::DoNotOptimize(sample);
+  }
+}
+SLTBENCH_FUNCTION(delegateListPerSample);
+
+}  // namespace v1util::bench
@@ -0,0 +1,70 @@
+#include "signal-slot.hpp"
+
+#include "v1util/base/warnings.hpp"
+
+V1_NO_WARNINGS
+#include "v1util/third-party/nano-signal-slot/nano_function.hpp"
+#include "v1util/third-party/nano-signal-slot/nano_mutex.hpp"
+#include "v1util/third-party/nano-signal-slot/nano_observer.hpp"
+#include "v1util/third-party/nano-signal-slot/nano_signal_slot.hpp"
+V1_RESTORE_WARNINGS
+
+#include "sltbench/Bench.h"
+
+#include <memory>
+#include <vector>
+
+namespace v1util::bench {
+
+namespace {
+constexpr const int kNumEmissions = 100;
+
+class Listener {
+ public:
+  void onBlock(int x) { sltbench::DoNotOptimize(mSum += x); }
+
+ private:
+  int mSum = 0;
+};
+
+template <typename SignalT>
+class SignalFixture {
+ public:
+  using Type = SignalT;
+
+  Type& SetUp(const size_t& numListeners) {
+    mpSignal = std::make_unique<Type>();
+    mListeners.resize(numListeners);
+    for(auto& listener : mListeners)
+      mpSignal->template connect<&Listener::onBlock>(&listener);
+    return *mpSignal;
+  }
+
+  void TearDown() {
+    mpSignal.reset();
+    mListeners.clear();
+  }
+
+ private:
+  std::unique_ptr<Type> mpSignal;
+  std::vector<Listener> mListeners;
+};
+
+using NanoSignal = Nano::Signal<void(int), Nano::ST_Policy>;
+using NativeSignalFixture = SignalFixture<Signal<void(int)>>;
+using NanoSignalFixture = SignalFixture<NanoSignal>;
+
+const std::vector<size_t> sNumListeners = {1, 8, 64};
+}  // namespace
+
+void signalFire(Signal<void(int)>& signal, const size_t&) {
+  for(int i = 0; i < kNumEmissions; ++i) signal.fire(i);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(signalFire, NativeSignalFixture, sNumListeners);
+
+void nanoSignalFire(NanoSignal& signal, const size_t&) {
+  for(int i = 0; i < kNumEmissions; ++i) signal.fire(i);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(nanoSignalFire, NanoSignalFixture, sNumListeners);
+
+}  // namespace v1util::bench
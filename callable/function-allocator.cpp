@@ -0,0 +1,200 @@
+#include "function-allocator.hpp"
+
+#include "v1util/base/bitop.hpp"
+#include "v1util/base/debug.hpp"
+#include "v1util/base/platform.hpp"
+
+#ifdef V1_OS_WIN
+#  include <malloc.h>
+#else
+#  include <cstdlib>
+#endif
+
+namespace v1util {
+
+namespace {
+
+std::atomic<IFunctionAllocator*> gDefaultAllocator = nullptr;
+thread_local IFunctionAllocator* tThreadAllocator = nullptr;
+thread_local FunctionAllocationStats tStats;
+
+void* systemAlignedAlloc(size_t size, size_t alignment) noexcept {
+#ifdef V1_OS_WIN
+  return _aligned_malloc(size, alignment);
+#else
+  return std::aligned_alloc(alignment, alignUp(uint64_t(size), uint64_t(alignment)));
+#endif
+}
+
+void systemAlignedFree(void* pBlock) noexcept {
+#ifdef V1_OS_WIN
+  _aligned_free(pBlock);
+#else
+  std::free(pBlock);
+#endif
+}
+
+}  // namespace
+
+
+FunctionAllocationStats functionAllocationStats() noexcept {
+  return tStats;
+}
+
+void setDefaultFunctionAllocator(IFunctionAllocator* pAllocator) noexcept {
+  gDefaultAllocator.store(pAllocator);
+}
+
+IFunctionAllocator* setThreadFunctionAllocator(IFunctionAllocator* pAllocator) noexcept {
+  auto pPrevious = tThreadAllocator;
+  tThreadAllocator = pAllocator;
+  return pPrevious;
+}
+
+
+namespace detail {
+
+void* allocateFunctionHeapBlock(
+    size_t size, size_t alignment, IFunctionAllocator** ppAllocator) noexcept {
+  auto pAllocator = tThreadAllocator ? tThreadAllocator : gDefaultAllocator.load();
+  auto pBlock = pAllocator ? pAllocator->allocate(size, alignment) : nullptr;
+  if(!pBlock) {
+    pAllocator = nullptr;
+    pBlock = systemAlignedAlloc(size, alignment);
+    tStats.systemAllocations++;
+  }
+
+  tStats.allocations++;
+  *ppAllocator = pAllocator;
+  return pBlock;
+}
+
+void freeFunctionHeapBlock(
+    void* pBlock, size_t size, size_t alignment, IFunctionAllocator* pAllocator) noexcept {
+  if(pAllocator)
+    pAllocator->free(pBlock, size, alignment);
+  else
+    systemAlignedFree(pBlock);
+  tStats.frees++;
+}
+
+}  // namespace detail
+
+
+/*
+ * The free lists are Treiber stacks of block indices. The ABA tag in the upper half of the
+ * head is incremented on every update, so that a stale head never matches in the CAS.
+ */
+
+namespace {
+constexpr const uint64_t kIndexMask = 0xFFFFFFFFULL;
+constexpr const uint64_t kTagIncrement = 1ULL << 32;
+
+std::atomic<uint32_t>* nextOfBlock(uint8_t* pBlock) noexcept {
+  return (std::atomic<uint32_t>*)pBlock;
+}
+}  // namespace
+
+FunctionPoolAllocator::FunctionPoolAllocator(uint32_t blocksPerClass)
+    : mBlocksPerClass(blocksPerClass) {
+  size_t totalSize = 0;
+  for(size_t i = 0; i < kNumSizeClasses; ++i) totalSize += (kMinBlockSize << i) * blocksPerClass;
+  if(!totalSize) return;
+
+  mpMemory = (uint8_t*)systemAlignedAlloc(totalSize, kMinBlockSize);
+  V1_ASSERT(mpMemory);
+
+  auto pBlocks = mpMemory;
+  for(size_t i = 0; i < kNumSizeClasses; ++i) {
+    auto& sizeClass = mSizeClasses[i];
+    sizeClass.pBlocks = pBlocks;
+    sizeClass.blockSize = kMinBlockSize << i;
+    pBlocks += sizeClass.blockSize * blocksPerClass;
+
+    for(uint32_t iBlock = blocksPerClass; iBlock-- > 0;) push(sizeClass, iBlock);
+  }
+}
+
+FunctionPoolAllocator::~FunctionPoolAllocator() {
+  if(mpMemory) systemAlignedFree(mpMemory);
+}
+
+void FunctionPoolAllocator::push(SizeClass& sizeClass, uint32_t index) noexcept {
+  auto pNext = nextOfBlock(sizeClass.pBlocks + index * sizeClass.blockSize);
+  auto head = sizeClass.freeListHead.load(std::memory_order_relaxed);
+  do {
+    pNext->store(uint32_t(head & kIndexMask), std::memory_order_relaxed);
+  } while(!sizeClass.freeListHead.compare_exchange_weak(head,
+      ((head & ~kIndexMask) + kTagIncrement) | (index + 1), std::memory_order_release,
+      std::memory_order_relaxed));
+}
+
+void* FunctionPoolAllocator::allocate(size_t size, size_t alignment) noexcept {
+  if(size > kMaxBlockSize || alignment > kMinBlockSize || !mpMemory) return nullptr;
+
+  auto iClass = size_t(0);
+  while((kMinBlockSize << iClass) < size) ++iClass;
+  auto& sizeClass = mSizeClasses[iClass];
+
+  auto head = sizeClass.freeListHead.load(std::memory_order_acquire);
+  uint8_t* pBlock = nullptr;
+  do {
+    if(!(head & kIndexMask)) return nullptr;
+    pBlock = sizeClass.pBlocks + ((head & kIndexMask) - 1) * sizeClass.blockSize;
+    // If another thread popped the block meanwhile, this reads garbage; the CAS fails then.
+    auto next = nextOfBlock(pBlock)->load(std::memory_order_relaxed);
+    if(sizeClass.freeListHead.compare_exchange_weak(head,
+           ((head & ~kIndexMask) + kTagIncrement) | next, std::memory_order_acquire,
+           std::memory_order_acquire))
+      break;
+  } while(true);
+
+  return pBlock;
+}
+
+void FunctionPoolAllocator::free(void* pBlock, size_t size, size_t alignment) noexcept {
+  V1_ASSERT(size <= kMaxBlockSize && alignment <= kMinBlockSize);
+  (void)alignment;
+
+  auto iClass = size_t(0);
+  while((kMinBlockSize << iClass) < size) ++iClass;
+  auto& sizeClass = mSizeClasses[iClass];
+
+  auto offset = size_t((uint8_t*)pBlock - sizeClass.pBlocks);
+  V1_ASSERT(offset % sizeClass.blockSize == 0 && offset / sizeClass.blockSize < mBlocksPerClass);
+  push(sizeClass, uint32_t(offset / sizeClass.blockSize));
+}
+
+
+FunctionArenaAllocator::FunctionArenaAllocator(size_t capacity) : mCapacity(capacity) {
+  if(capacity) mpMemory = (uint8_t*)systemAlignedAlloc(capacity, alignof(std::max_align_t));
+  V1_ASSERT(mpMemory || !capacity);
+}
+
+FunctionArenaAllocator::~FunctionArenaAllocator() {
+  V1_ASSERT(!mNumLiveObjects.load());
+  if(mpMemory) systemAlignedFree(mpMemory);
+}
+
+void* FunctionArenaAllocator::allocate(size_t size, size_t alignment) noexcept {
+  auto begin = alignUp(uint64_t(uintptr_t(mpMemory) + mUsed), uint64_t(alignment));
+  auto offset = size_t(begin - uintptr_t(mpMemory));
+  if(!mpMemory || offset + size > mCapacity) return nullptr;
+
+  mUsed = offset + size;
+  mNumLiveObjects++;
+  return mpMemory + offset;
+}
+
+void FunctionArenaAllocator::free(void* pBlock, size_t, size_t) noexcept {
+  V1_ASSERT((uint8_t*)pBlock >= mpMemory && (uint8_t*)pBlock < mpMemory + mCapacity);
+  (void)pBlock;
+  mNumLiveObjects--;
+}
+
+void FunctionArenaAllocator::reset() noexcept {
+  V1_ASSERT(!mNumLiveObjects.load());
+  mUsed = 0;
+}
+
+}  // namespace v1util
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "v1util/base/cpppainrelief.hpp"
+#include "v1util/base/platform.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace v1util {
+
+/** Allocates the heap objects of Function, i.e. callables that don't fit the inline storage
+ *
+ * allocate() may return nullptr, the system allocator is used then. free() is called on the
+ * allocator that allocated a block, possibly from another thread, with the same size and
+ * alignment.
+ */
+class IFunctionAllocator {
+ public:
+  virtual void* allocate(size_t size, size_t alignment) noexcept = 0;
+  virtual void free(void* pBlock, size_t size, size_t alignment) noexcept = 0;
+
+ protected:
+  ~IFunctionAllocator() = default;
+};
+
+
+//! Heap object counters of the calling thread
+struct FunctionAllocationStats {
+  uint64_t allocations = 0;  //!< all heap objects created
+  uint64_t systemAllocations = 0;  //!< the part of allocations served by the system allocator
+  uint64_t frees = 0;  //!< heap objects destroyed (on this thread)
+};
+
+/** Counters of the calling thread since it started
+ *
+ * E.g. compare the values before and after a steady-state processing loop to ensure it doesn't
+ * allocate.
+ */
+V1_PUBLIC FunctionAllocationStats functionAllocationStats() noexcept;
+
+
+//! Set the allocator for all threads without a thread allocator; nullptr for the system allocator
+V1_PUBLIC void setDefaultFunctionAllocator(IFunctionAllocator* pAllocator) noexcept;
+
+//! Set the allocator of the calling thread; nullptr to use the default. Returns the previous one.
+V1_PUBLIC IFunctionAllocator* setThreadFunctionAllocator(IFunctionAllocator* pAllocator) noexcept;
+
+//! Use an allocator for the calling thread within a scope
+class FunctionAllocatorScope {
+ public:
+  explicit FunctionAllocatorScope(IFunctionAllocator* pAllocator) noexcept
+      : mpPrevious(setThreadFunctionAllocator(pAllocator)) {}
+  ~FunctionAllocatorScope() { setThreadFunctionAllocator(mpPrevious); }
+  V1_NO_CP_NO_MV(FunctionAllocatorScope);
+
+ private:
+  IFunctionAllocator* mpPrevious;
+};
+
+
+/** Lock-free pool of fixed-size blocks, in kNumSizeClasses size classes
+ *
+ * All memory is allocated up front. allocate() and free() may be called from any thread and
+ * don't block. Requests that are too large, too aligned or find their size class exhausted are
+ * passed on to the system allocator.
+ */
+class FunctionPoolAllocator final : public IFunctionAllocator {
+ public:
+  static constexpr const size_t kMinBlockSize = 32;
+  static constexpr const size_t kNumSizeClasses = 4;
+  static constexpr const size_t kMaxBlockSize = kMinBlockSize << (kNumSizeClasses - 1);
+
+  //! Reserve @p blocksPerClass blocks for each of the sizes 32, 64, ..., kMaxBlockSize bytes
+  V1_PUBLIC explicit FunctionPoolAllocator(uint32_t blocksPerClass);
+  V1_PUBLIC ~FunctionPoolAllocator();
+  V1_NO_CP_NO_MV(FunctionPoolAllocator);
+
+  V1_PUBLIC void* allocate(size_t size, size_t alignment) noexcept override;
+  V1_PUBLIC void free(void* pBlock, size_t size, size_t alignment) noexcept override;
+
+ private:
+  struct SizeClass {
+    uint8_t* pBlocks = nullptr;
+    size_t blockSize = 0;
+    //! ABA tag in the upper, 1-based index of the first free block in the lower 32 bits
+    std::atomic<uint64_t> freeListHead = 0;
+  };
+
+  void push(SizeClass& sizeClass, uint32_t index) noexcept;
+
+  uint8_t* mpMemory = nullptr;
+  uint32_t mBlocksPerClass = 0;
+  SizeClass mSizeClasses[kNumSizeClasses];
+};
+
+
+/** Bump allocator owned by a single thread
+ *
+ * allocate() must only be called from the owning thread, free() may be called from anywhere but
+ * doesn't reclaim memory. reset() releases everything at once, once all objects are freed.
+ * When the arena is exhausted, the system allocator takes over.
+ */
+class FunctionArenaAllocator final : public IFunctionAllocator {
+ public:
+  V1_PUBLIC explicit FunctionArenaAllocator(size_t capacity);
+  V1_PUBLIC ~FunctionArenaAllocator();
+  V1_NO_CP_NO_MV(FunctionArenaAllocator);
+
+  V1_PUBLIC void* allocate(size_t size, size_t alignment) noexcept override;
+  V1_PUBLIC void free(void* pBlock, size_t size, size_t alignment) noexcept override;
+
+  //! Rewind the arena; all objects allocated so far have to be freed
+  V1_PUBLIC void reset() noexcept;
+
+  size_t capacity() const noexcept { return mCapacity; }
+  size_t used() const noexcept { return mUsed; }
+  size_t numLiveObjects() const noexcept { return mNumLiveObjects.load(); }
+
+ private:
+  uint8_t* mpMemory = nullptr;
+  size_t mCapacity = 0;
+  size_t mUsed = 0;
+  std::atomic<size_t> mNumLiveObjects = 0;
+};
+
+
+namespace detail {
+/** Allocate a block for a Function heap object from the current allocator
+ *
+ * @p ppAllocator receives the allocator to pass to freeFunctionHeapBlock(); nullptr for the
+ * system allocator.
+ */
+V1_PUBLIC void* allocateFunctionHeapBlock(
+    size_t size, size_t alignment, IFunctionAllocator** ppAllocator) noexcept;
+V1_PUBLIC void freeFunctionHeapBlock(
+    void* pBlock, size_t size, size_t alignment, IFunctionAllocator* pAllocator) noexcept;
+}  // namespace detail
+
+}  // namespace v1util
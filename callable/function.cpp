@@ -1,4 +1,5 @@
 #include "function.hpp"
+#include "function-allocator.hpp"
 
 #include "v1util/base/bitop.hpp"
 #include "v1util/base/cpppainrelief.hpp"
@@ -8,12 +9,6 @@
 #include <algorithm>
 #include <atomic>
 
-#ifdef V1_OS_WIN
-#  include <malloc.h>
-#else
-#  include <cstdlib>
-#endif
-
 namespace v1util { namespace detail {
 
 namespace {
@@ -26,6 +21,7 @@ struct FunctionHeapHeader {
   V1_NO_CP_NO_MV(FunctionHeapHeader);
 
   PFunctionDeleterFunc pDeleter = nullptr;
+  IFunctionAllocator* pAllocator = nullptr;
   size_t objectSize = 0;
   size_t objectAlignment = 0;
   std::atomic_uint_fast32_t refCount = 1;
@@ -38,18 +34,23 @@ FunctionHeapHeader* headerFromHeapObj(void* pHeapObject) noexcept {
   return ((FunctionHeapHeader*)pHeapObject) - 1;
 };
 
+size_t allocAlignment(size_t objectAlignment) noexcept {
+  return std::max(objectAlignment, alignof(FunctionHeapHeader));
+}
+
+size_t allocSize(size_t objectSize, size_t objectAlignment) noexcept {
+  return alignUp(objectSize + sizeof(FunctionHeapHeader), allocAlignment(objectAlignment));
+}
+
 void* mallocHeapObject(size_t objectSize, size_t objectAlignment) noexcept {
   V1_ASSERT(isPow2(objectAlignment) && isPow2(alignof(FunctionHeapHeader)));
-  auto allocAlignment = std::max(objectAlignment, alignof(FunctionHeapHeader));
-  auto allocSize = alignUp(objectSize + sizeof(FunctionHeapHeader), allocAlignment);
 
-#ifdef V1_OS_WIN
-  auto pAlloc = _aligned_malloc(allocSize, allocAlignment);
-#else
-  auto pAlloc = std::aligned_alloc(allocAlignment, allocSize);
-#endif
+  IFunctionAllocator* pAllocator = nullptr;
+  auto pAlloc = allocateFunctionHeapBlock(allocSize(objectSize, objectAlignment),
+      allocAlignment(objectAlignment), &pAllocator);
 
   auto pHeader = new(pAlloc) FunctionHeapHeader();
+  pHeader->pAllocator = pAllocator;
   pHeader->objectSize = objectSize;
   pHeader->objectAlignment = objectAlignment;
   return pHeader + 1;
@@ -57,33 +58,25 @@ void* mallocHeapObject(size_t objectSize, size_t objectAlignment) noexcept {
 }  // namespace
 
 
-size_t FunctionBase::_refCount() const noexcept {
-  return hasHeapObject() ? headerFromHeapObj(mStorage.pObject)->refCount.load() : 0;
+size_t FunctionHeap::heapObjectRefCount(void* pHeapObject) noexcept {
+  return headerFromHeapObj(pHeapObject)->refCount.load();
 }
 
-void FunctionBase::createHeapObject(size_t objectSize, size_t objectAlignment, void* pTrampoline,
-    PFunctionDeleterFunc pDeleter) noexcept {
-  mStorage.pObject = mallocHeapObject(objectSize, objectAlignment);
-  setTrampoline(pTrampoline, K(hasHeapObject), !K(hasEmbeddedStorage));
-
-  auto pHeader = headerFromHeapObj(mStorage.pObject);
-  pHeader->pDeleter = pDeleter;
+void* FunctionHeap::createHeapObject(
+    size_t objectSize, size_t objectAlignment, PFunctionDeleterFunc pDeleter) noexcept {
+  auto pHeapObject = mallocHeapObject(objectSize, objectAlignment);
+  headerFromHeapObj(pHeapObject)->pDeleter = pDeleter;
+  return pHeapObject;
 }
 
-void FunctionBase::copyObject(const FunctionBase& other) noexcept {
-  if(other.hasHeapObject()) {
-    auto pOtherHeader = headerFromHeapObj(other.mStorage.pObject);
-    V1_ASSERT(pOtherHeader->canary == kValidHeapBlockMarker);
-    pOtherHeader->refCount++;
-    mStorage.pObject = other.mStorage.pObject;
-  } else
-    memcpy(mStorage.data, other.mStorage.data, sizeof(mStorage.data));
-
-  mpTrampoline = other.mpTrampoline;
+void FunctionHeap::retainHeapObject(void* pHeapObject) noexcept {
+  auto pHeader = headerFromHeapObj(pHeapObject);
+  V1_ASSERT(pHeader->canary == kValidHeapBlockMarker);
+  pHeader->refCount++;
 }
 
 
-void FunctionBase::freeHeapObject(void* pHeapObject) noexcept {
+void FunctionHeap::freeHeapObject(void* pHeapObject) noexcept {
   auto pHeader = headerFromHeapObj(pHeapObject);
   V1_ASSERT(pHeader->canary == kValidHeapBlockMarker);
 
@@ -94,14 +87,12 @@ void FunctionBase::freeHeapObject(void* pHeapObject) noexcept {
 #endif
 
   if(pHeader->pDeleter) pHeader->pDeleter(pHeapObject);
+  const auto pAllocator = pHeader->pAllocator;
+  const auto size = allocSize(pHeader->objectSize, pHeader->objectAlignment);
+  const auto alignment = allocAlignment(pHeader->objectAlignment);
   pHeader->~FunctionHeapHeader();
 
-  auto pAlloc = pHeader;
-#ifdef V1_OS_WIN
-  _aligned_free(pAlloc);
-#else
-  std::free(pAlloc);
-#endif
+  freeFunctionHeapBlock(pHeader, size, alignment, pAllocator);
 }
 
 }}  // namespace v1util::detail
@@ -20,76 +20,143 @@ namespace detail {
 using PFunctionDeleterFunc = void (*)(void*);
 struct FunctionHeapHeader;
 
-class FunctionBase {
+//! Operations on a non-trivial callable embedded into a Function
+enum class FunctionInlineOp { kCopy, kMove, kDestroy };
+using PFunctionInlineOpsFunc = void (*)(FunctionInlineOp op, void* pTarget, void* pSource);
+
+//! Reference-counted heap objects, shared by Functions of all storage sizes
+class FunctionHeap {
  protected:
+  V1_PUBLIC static void* createHeapObject(
+      size_t objectSize, size_t objectAlignment, PFunctionDeleterFunc pDeleter) noexcept;
+  V1_PUBLIC static void retainHeapObject(void* pHeapObject) noexcept;
+  V1_PUBLIC static void freeHeapObject(void* pHeapObject) noexcept;
+  V1_PUBLIC static size_t heapObjectRefCount(void* pHeapObject) noexcept;
+};
+
+template <size_t kInlineBytes>
+class FunctionBase : protected FunctionHeap {
+ protected:
+  static_assert(kInlineBytes >= sizeof(uintptr_t) && kInlineBytes % sizeof(uintptr_t) == 0,
+      "Inline storage has to be a multiple of the pointer size");
+
   static constexpr const auto kStorageAlignment = alignof(PFunctionDeleterFunc);
-  static constexpr const auto kStorageSize = 1 * sizeof(uintptr_t);
+  static constexpr const auto kStorageSize = kInlineBytes;
+  //! Non-trivial embedded callables are preceded by their PFunctionInlineOpsFunc
+  static constexpr const auto kInlineObjectOffset = sizeof(PFunctionInlineOpsFunc);
 
   FunctionBase() = default;
 
   FunctionBase(const FunctionBase& other) noexcept { copyObject(other); }
 
-  FunctionBase(FunctionBase&& other) noexcept {
-    memcpy(mStorage.data, other.mStorage.data, sizeof(mStorage));
-
-    mpTrampoline = other.mpTrampoline;
-    other.mpTrampoline = 0;
-  }
+  FunctionBase(FunctionBase&& other) noexcept { moveObject(other); }
 
   FunctionBase& operator=(const FunctionBase& other) noexcept {
-    // keep old object for self-assignment correctness
-    auto pOldObject = hasHeapObject() ? mStorage.pObject : nullptr;
-    copyObject(other);
-    if(pOldObject) freeHeapObject(pOldObject);
-
+    if(this != &other) {
+      reset();
+      copyObject(other);
+    }
     return *this;
   }
 
   FunctionBase& operator=(FunctionBase&& other) noexcept {
-    auto pOldObject = hasHeapObject() ? mStorage.pObject : nullptr;
-
-    memcpy(mStorage.data, other.mStorage.data, sizeof(mStorage));
-
-    mpTrampoline = other.mpTrampoline;
-    if(pOldObject) freeHeapObject(pOldObject);
-    other.mpTrampoline = 0;
+    if(this != &other) {
+      reset();
+      moveObject(other);
+    }
     return *this;
   }
 
   ~FunctionBase() {
-    if(hasHeapObject()) freeHeapObject(mStorage.pObject);
+    reset();
 #ifdef V1_DEBUG
     mpTrampoline = uintptr_t(~0ULL);
 #endif
   }
 
-  V1_PUBLIC void createHeapObject(size_t objectSize,
+  void createHeapObject(size_t objectSize,
       size_t objectAlignment,
       void* pTrampoline,
-      PFunctionDeleterFunc pDeleter) noexcept;
-  V1_PUBLIC void copyObject(const FunctionBase& other) noexcept;
-  V1_PUBLIC static void freeHeapObject(void* pHeapObject) noexcept;
+      PFunctionDeleterFunc pDeleter) noexcept {
+    mStorage.pObject = FunctionHeap::createHeapObject(objectSize, objectAlignment, pDeleter);
+    setTrampoline(pTrampoline, K(hasHeapObject), !K(hasEmbeddedStorage));
+  }
+
+  //! Returns the address to construct the callable at
+  void* createInlineObject(void* pTrampoline, PFunctionInlineOpsFunc pInlineOps) noexcept {
+#ifdef V1_OS_POSIX
+    V1_ASSERT((uintptr_t(pTrampoline) & kTrampolineStolenBitsMask) == 0);
+#endif
+    mStorage.pInlineOps = pInlineOps;
+    mpTrampoline = uintptr_t(pTrampoline) | kHasInlineOps;
+    return inlineObject();
+  }
+
+  void copyObject(const FunctionBase& other) noexcept {
+    if(other.hasInlineOps()) {
+      mStorage.pInlineOps = other.mStorage.pInlineOps;
+      mStorage.pInlineOps(FunctionInlineOp::kCopy, inlineObject(), other.inlineObject());
+    } else {
+      if(other.hasHeapObject()) retainHeapObject(other.mStorage.pObject);
+      memcpy(mStorage.data, other.mStorage.data, sizeof(mStorage.data));
+    }
+
+    mpTrampoline = other.mpTrampoline;
+  }
+
+  void moveObject(FunctionBase& other) noexcept {
+    if(other.hasInlineOps()) {
+      mStorage.pInlineOps = other.mStorage.pInlineOps;
+      mStorage.pInlineOps(FunctionInlineOp::kMove, inlineObject(), other.inlineObject());
+    } else
+      memcpy(mStorage.data, other.mStorage.data, sizeof(mStorage.data));
+
+    mpTrampoline = other.mpTrampoline;
+    other.mpTrampoline = 0;
+  }
+
+  void reset() noexcept {
+    if(hasHeapObject())
+      freeHeapObject(mStorage.pObject);
+    else if(hasInlineOps())
+      mStorage.pInlineOps(FunctionInlineOp::kDestroy, inlineObject(), nullptr);
+    mpTrampoline = 0;
+  }
+
   void setTrampoline(void* pTrampoline, bool hasHeapObject, bool hasEmbeddedStorage) {
 #ifdef V1_OS_POSIX
     // code alignment has to be ensured manually on that platform
     V1_ASSERT((uintptr_t(pTrampoline) & kTrampolineStolenBitsMask) == 0);
 #endif
+    V1_ASSERT(!hasHeapObject || !hasEmbeddedStorage);
     mpTrampoline = uintptr_t(pTrampoline) | (hasHeapObject ? kHasHeapObjectMask : 0)
                    | (hasEmbeddedStorage ? kUseAddressOfStorage : 0);
   }
 
-  inline bool hasHeapObject() const noexcept { return mpTrampoline & kHasHeapObjectMask; }
-  inline bool hasEmbeddedStorage() const noexcept { return mpTrampoline & kUseAddressOfStorage; }
+  inline uintptr_t storageBits() const noexcept { return mpTrampoline & kTrampolineStolenBitsMask; }
+  inline bool hasHeapObject() const noexcept { return storageBits() == kHasHeapObjectMask; }
+  inline bool hasEmbeddedStorage() const noexcept { return storageBits() == kUseAddressOfStorage; }
+  inline bool hasInlineOps() const noexcept { return storageBits() == kHasInlineOps; }
+  inline void* inlineObject() const noexcept {
+    return (void*)(mStorage.data + kInlineObjectOffset);
+  }
   inline void* storage() const noexcept {
-    return hasEmbeddedStorage() ? (void*)&mStorage.data : mStorage.pObject;
+    switch(storageBits()) {
+      case kUseAddressOfStorage: return (void*)&mStorage.data;
+      case kHasInlineOps: return inlineObject();
+      default: return mStorage.pObject;
+    }
   }
   inline void* trampoline() const noexcept {
     return (void*)(mpTrampoline & ~kTrampolineStolenBitsMask);
   }
-  V1_PUBLIC size_t _refCount() const noexcept;
+  size_t _refCount() const noexcept {
+    return hasHeapObject() ? heapObjectRefCount(mStorage.pObject) : 0;
+  }
 
   union {
     void* pObject;  // pointer to heap allocation or static data/function ptr
+    PFunctionInlineOpsFunc pInlineOps;  // followed by the embedded non-trivial Callable
     alignas(kStorageAlignment) uint8_t data[kStorageSize];  // embedded storage for small Lambdas
   } mStorage = {.data = {}};
 
@@ -97,6 +164,7 @@ class FunctionBase {
       "Storing additional data in mpTrampoline requires alignment of functions pointers");
   static constexpr const uintptr_t kHasHeapObjectMask = 0b01;
   static constexpr const uintptr_t kUseAddressOfStorage = 0b10;
+  static constexpr const uintptr_t kHasInlineOps = 0b11;  // embedded, with copy/move/destroy ops
   static constexpr const uintptr_t kTrampolineStolenBitsMask = 0b11;
 
   //! Trampoline function or target function (plus bits of storage):
@@ -111,21 +179,42 @@ class FunctionBase {
  * - move operations may+do not throw
  * - could support equality comparison with caveats
  * - small-Lambda optimization is obvious and guaranteed
+ * - the size of the small-Lambda storage is a template parameter
  *
  * Lambdas are stored inside iff:
- * - Lambda size fits kStorageSize, alignment doesn't exceed that of a function pointer
+ * - Lambda size fits kInlineBytes, alignment doesn't exceed that of a function pointer
  * - the Lambda is trivially copyable and destructable
  *   (caveat: copyable is not met on MSVC 2019; thus, on Windows, Lambdas are copied
  *    onto the heap)
+ * or:
+ * - Lambda size plus one pointer fits kInlineBytes, alignment as above
+ * - the Lambda is copy constructible and nothrow move constructible
+ *   The pointer refers to the copy/move/destroy operations of the Lambda.
+ *
+ * Everything else is stored on the heap and shared (reference-counted) between copies.
+ * Use fitsInline<Invocable>() to static_assert that construction won't allocate, e.g. in
+ * real-time threads.
  *
  * References to static functions and member functions are always stored inside.
  *
  */
-template <typename Signature>
+template <typename Signature, size_t kInlineBytes = sizeof(uintptr_t)>
 class Function;
 
-template <typename RetType, typename... Args>
-class Function<RetType(Args...)> : detail::FunctionBase {
+template <typename RetType, typename... Args, size_t kInlineBytes>
+class Function<RetType(Args...), kInlineBytes> : detail::FunctionBase<kInlineBytes> {
+  using Base = detail::FunctionBase<kInlineBytes>;
+  using Base::hasEmbeddedStorage;
+  using Base::hasHeapObject;
+  using Base::hasInlineOps;
+  using Base::kInlineObjectOffset;
+  using Base::kStorageAlignment;
+  using Base::kTrampolineStolenBitsMask;
+  using Base::mpTrampoline;
+  using Base::mStorage;
+  using Base::setTrampoline;
+  using Base::storage;
+
  public:
   using result_type = RetType;
 
@@ -153,12 +242,29 @@ class Function<RetType(Args...)> : detail::FunctionBase {
       return (*(std::add_pointer_t<Invocable>)pInvocable)(std::forward<Args>(args)...);
     };
 
-    if constexpr(std::is_trivially_destructible_v<BareInvocable>
-              && std::is_trivially_copyable_v<BareInvocable> // mStorage is only trivially copied
-              && sizeof(invocable) <= sizeof(mStorage.data)
-              && kStorageAlignment % alignof(BareInvocable) == 0) {
-        setTrampoline(pTrampoline, !K(hasHeapObject), K(hasEmbeddedStorage));
-        new(mStorage.data) BareInvocable(std::forward<Invocable>(invocable));
+    if constexpr(fitsEmbedded<BareInvocable>()) {
+      setTrampoline(pTrampoline, !K(hasHeapObject), K(hasEmbeddedStorage));
+      new(mStorage.data) BareInvocable(std::forward<Invocable>(invocable));
+    } else if constexpr(fitsEmbeddedWithOps<BareInvocable>()) {
+      using StoredInvocable = std::decay_t<Invocable>;
+      auto pInlineOps = (detail::PFunctionInlineOpsFunc)[](
+          detail::FunctionInlineOp op, void* pTarget, void* pSource) {
+        switch(op) {
+          case detail::FunctionInlineOp::kCopy:
+            new(pTarget) StoredInvocable(*(const StoredInvocable*)pSource);
+            break;
+          case detail::FunctionInlineOp::kMove:
+            new(pTarget) StoredInvocable(std::move(*(StoredInvocable*)pSource));
+            ((StoredInvocable*)pSource)->~StoredInvocable();
+            break;
+          case detail::FunctionInlineOp::kDestroy:
+            ((StoredInvocable*)pTarget)->~StoredInvocable();
+            break;
+        }
+      };
+
+      auto pObject = Base::createInlineObject(pTrampoline, pInlineOps);
+      new(pObject) StoredInvocable(std::forward<Invocable>(invocable));
     } else {
       // If all fails, just heap-allocate space for the Callable:
       auto pDeleter = (detail::PFunctionDeleterFunc)[](void* pInvokable){
@@ -166,12 +272,19 @@ class Function<RetType(Args...)> : detail::FunctionBase {
         pLambda->~BareInvocable();
       };
 
-      createHeapObject(sizeof(BareInvocable), alignof(BareInvocable), pTrampoline, pDeleter);
+      Base::createHeapObject(sizeof(BareInvocable), alignof(BareInvocable), pTrampoline, pDeleter);
       new(mStorage.pObject) BareInvocable(std::forward<Invocable>(invocable));
     }
   }
   // clang-format on
 
+  //! Whether an Invocable is stored without allocating
+  template <typename Invocable>
+  static constexpr bool fitsInline() noexcept {
+    using BareInvocable = std::remove_reference_t<std::remove_cv_t<Invocable>>;
+    return fitsEmbedded<BareInvocable>() || fitsEmbeddedWithOps<BareInvocable>();
+  }
+
 
   /** Bind to a member function.
    *
@@ -286,13 +399,12 @@ class Function<RetType(Args...)> : detail::FunctionBase {
 
   decltype(auto) operator()(Args... args) const {
     V1_ASSERT(mpTrampoline & ~kTrampolineStolenBitsMask);
-    V1_ASSERT(!hasHeapObject() || !hasEmbeddedStorage());
     return typedTrampoline()(storage(), std::forward<Args>(args)...);
   }
 
   inline explicit operator bool() const noexcept { return mpTrampoline; }
   inline bool isHeapBased() const noexcept { return mpTrampoline && hasHeapObject(); }
-  inline size_t _refCount() const noexcept { return FunctionBase::_refCount(); }
+  inline size_t _refCount() const noexcept { return Base::_refCount(); }
 
   /** Equality for functors, if possible (see Delegate::operator== for details)
    *
@@ -305,9 +417,9 @@ class Function<RetType(Args...)> : detail::FunctionBase {
    */
   inline friend bool operator==(const Function& a, const Function& b) {
     return a.mpTrampoline == b.mpTrampoline
-           && (a.isHeapBased()
+           && (a.isHeapBased() || a.hasInlineOps()
                    ? a.storage() == b.storage()
-                   : !std::memcmp(a.mStorage.data, b.mStorage.data, FunctionBase::kStorageSize));
+                   : !std::memcmp(a.mStorage.data, b.mStorage.data, Base::kStorageSize));
   }
   inline friend bool operator!=(const Function& a, const Function& b) { return !operator==(a, b); }
 
@@ -323,6 +435,23 @@ class Function<RetType(Args...)> : detail::FunctionBase {
   inline PTrampolineType typedTrampoline() const {
     return (PTrampolineType)(mpTrampoline & ~kTrampolineStolenBitsMask);
   }
+
+  template <typename BareInvocable>
+  static constexpr bool fitsEmbedded() noexcept {
+    return std::is_trivially_destructible_v<BareInvocable>
+           && std::is_trivially_copyable_v<BareInvocable>  // mStorage is only trivially copied
+           && sizeof(BareInvocable) <= sizeof(mStorage.data)
+           && kStorageAlignment % alignof(BareInvocable) == 0;
+  }
+
+  template <typename BareInvocable>
+  static constexpr bool fitsEmbeddedWithOps() noexcept {
+    using StoredInvocable = std::remove_cv_t<BareInvocable>;
+    return std::is_copy_constructible_v<StoredInvocable>
+           && std::is_nothrow_move_constructible_v<StoredInvocable>
+           && sizeof(StoredInvocable) + kInlineObjectOffset <= sizeof(mStorage.data)
+           && kStorageAlignment % alignof(StoredInvocable) == 0;
+  }
 };
 
 }  // namespace v1util
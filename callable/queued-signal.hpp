@@ -0,0 +1,116 @@
+#pragma once
+
+#include "function.hpp"
+
+#include "v1util/base/cpppainrelief.hpp"
+#include "v1util/container/mpsc_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace v1util {
+
+//! Queued emissions store the slot plus copies of the arguments inline, in this many bytes
+constexpr const size_t kQueuedSignalEventInlineBytes = 8 * sizeof(uintptr_t);
+
+/** Per-receiver queue of signal emissions, dispatched in batches on the receiving thread
+ *
+ * Any thread may post, e.g. a QueuedSignal's emit(). The receiving thread calls dispatch() at a
+ * point it chooses, e.g. once per audio block. Neither side locks or allocates.
+ */
+class SignalDispatchQueue {
+ public:
+  using Event = Function<void(), kQueuedSignalEventInlineBytes>;
+
+  explicit SignalDispatchQueue(uint64_t capacity) : mEvents(capacity) {}
+  V1_NO_CP_NO_MV(SignalDispatchQueue);
+
+  //! From any thread; returns false and counts a drop if the queue is full
+  bool post(Event&& event) noexcept {
+    if(mEvents.tryPush(std::move(event))) return true;
+    mNumDropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  /** Call up to @p maxEvents queued events; from the receiving thread only
+   *
+   * Events are called in the order they were posted, per posting thread. An event may call
+   * dispatch() itself, which continues with the events after it.
+   * @return the number of called events
+   */
+  uint64_t dispatch(uint64_t maxEvents = ~uint64_t(0)) {
+    return mEvents.consume([](Event& event) { event(); }, maxEvents);
+  }
+
+  //! Events lost because the queue was full
+  uint64_t numDropped() const noexcept { return mNumDropped.load(std::memory_order_relaxed); }
+  uint64_t capacity() const noexcept { return mEvents.capacity(); }
+
+ private:
+  MpscQueue<Event> mEvents;
+  std::atomic<uint64_t> mNumDropped = 0;
+};
+
+
+/** Signal that delivers emissions through the SignalDispatchQueue of each receiver
+ *
+ * emit() may be called from any thread; it copies the arguments into the receivers' queues,
+ * without locks or allocation. The slots are called when the receiving threads dispatch their
+ * queues, so arguments are passed by value, even if Args are references.
+ *
+ * Connections are not synchronized with emit(): set them up before emitting, and disconnect and
+ * drain the queue before a receiver dies.
+ */
+template <typename Signature>
+class QueuedSignal;
+
+template <typename... Args>
+class QueuedSignal<void(Args...)> {
+ public:
+  using Slot = Function<void(Args...)>;
+
+  QueuedSignal() = default;
+  V1_NO_CP_NO_MV(QueuedSignal);
+
+  template <auto pMemFn, typename Receiver>
+  void connect(Receiver* pReceiver, SignalDispatchQueue* pQueue) {
+    connect(Slot::template bind<pMemFn>(pReceiver), pQueue);
+  }
+
+  void connect(Slot slot, SignalDispatchQueue* pQueue) {
+    mConnections.push_back({std::move(slot), pQueue});
+  }
+
+  template <auto pMemFn, typename Receiver>
+  void disconnect(Receiver* pReceiver) {
+    const auto slot = Slot::template bind<pMemFn>(pReceiver);
+    mConnections.erase(std::remove_if(mConnections.begin(), mConnections.end(),
+                           [&](const Connection& connection) { return connection.slot == slot; }),
+        mConnections.end());
+  }
+
+  void disconnect_all() { mConnections.clear(); }
+
+  //! From any thread; returns false if any receiver's queue was full
+  bool emit(Args... args) const noexcept {
+    bool allQueued = true;
+    for(const auto& connection : mConnections) {
+      auto event = [slot = connection.slot, args...]() mutable { slot(args...); };
+      static_assert(SignalDispatchQueue::Event::fitsInline<decltype(event)>(),
+          "The arguments don't fit kQueuedSignalEventInlineBytes; pass a pointer or handle");
+      allQueued &= connection.pQueue->post(SignalDispatchQueue::Event(std::move(event)));
+    }
+    return allQueued;
+  }
+
+ private:
+  struct Connection {
+    Slot slot;
+    SignalDispatchQueue* pQueue;
+  };
+  std::vector<Connection> mConnections;
+};
+
+}  // namespace v1util
@@ -1,171 +1,295 @@
 #pragma once
 
-#if 1
-#  include "v1util/base/warnings.hpp"
+#include "function.hpp"
 
-V1_NO_WARNINGS
-#  include "v1util/third-party/nano-signal-slot/nano_function.hpp"
-#  include "v1util/third-party/nano-signal-slot/nano_mutex.hpp"
-#  include "v1util/third-party/nano-signal-slot/nano_observer.hpp"
-#  include "v1util/third-party/nano-signal-slot/nano_signal_slot.hpp"
-V1_RESTORE_WARNINGS
-
-
-namespace v1util {
-
-namespace detail {
-/** By making the mutex a no-op, the SigSlot mechanism becomes single-threaded,
- * but safe to use on dying class instances. Still, disconnecting an observer
- * won't take effect immediately, but only after any current emission has ended.
- */
-class SigSlot_NoMutex {
- public:
-  inline void lock() noexcept {}
-  inline void unlock() noexcept {}
-};
-
-}  // namespace detail
+#include "v1util/base/cpppainrelief.hpp"
+#include "v1util/base/debug.hpp"
 
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 /*********************************************************
- * TODO: Make my own signal-slot with sane semantics
- *
- * Wanted:
+ * Signals and slots with sane semantics:
  * - single-threaded
- * - auto-disconnection when slot owner dies
+ * - auto-disconnection when slot owner dies (SlotLifetimeTracker)
  * - non-owning connections
  * - new connections from within an emission of a signal are not called in that emission
  * - deleted connections from within an emission take effect immediately (bc. the emission is on the
  *   same thread and not queued, in contrast to queued singals)
- * - nested connection/disconnection does not crash, but may have degraded semantics
+ * - nested emission/connection/disconnection does not crash
  *
  * stretch goal:
  * - output iterator for return values
  **********************************************************/
 
-/** single-threaded signal (reentrant-safe for dying class instances)
- *
- * Danger: During the delivery of a signal, disconnecting a slot has no effect.
- * The signal will still be delivered to that slot. It's only disconnected for the
- * next delivery. Only if the slot is in a class instance destroyed during delivery,
- * the slot won't be called.
- *
- * Keep in mind: No copy. no move
- */
-template <typename Signature>
-using Signal = Nano::Signal<Signature, Nano::TS_Policy_Safe<detail::SigSlot_NoMutex>>;
+namespace v1util {
 
-/** signle-threaded slot owner w/ automatic disconnect on destruction
- * (reentrant-safe for dying class instances)
- *
- * Danger: During the delivery of a signal, disconnecting a slot has no effect.
- * The signal will still be delivered to that slot. It's only disconnected for the
- * next delivery. Only if the slot is in a class instance destroyed during delivery,
- * the slot won't be called.
+class SlotLifetimeTracker;
+
+//! Generation-counted reference to a connection of a Signal; stale references are ignored
+struct SignalConnection {
+  uint32_t id = ~uint32_t(0);
+  uint32_t generation = 0;
+
+  friend bool operator==(const SignalConnection& a, const SignalConnection& b) {
+    return a.id == b.id && a.generation == b.generation;
+  }
+  friend bool operator!=(const SignalConnection& a, const SignalConnection& b) {
+    return !(a == b);
+  }
+};
+
+namespace detail {
+class SignalBase {
+ public:
+  virtual void disconnect(SignalConnection connection) noexcept = 0;
+
+ protected:
+  SignalBase() = default;
+  ~SignalBase() = default;
+
+  inline void notifyOwnerAboutConnection(
+      SlotLifetimeTracker* pOwner, SignalConnection connection);
+  inline void notifyOwnerAboutDisconnection(
+      SlotLifetimeTracker* pOwner, SignalConnection connection) noexcept;
+};
+}  // namespace detail
+
+
+/** Base class for slot owners: disconnects all of its slots on destruction
  *
  * Keep in mind: No copy. no move
  */
-using SigSlotObserver = Nano::Observer<Nano::TS_Policy_Safe<detail::SigSlot_NoMutex>>;
+class SlotLifetimeTracker {
+ public:
+  SlotLifetimeTracker() = default;
+  V1_NO_CP_NO_MV(SlotLifetimeTracker);
+  ~SlotLifetimeTracker() { disconnectAllSlots(); }
+
+  void disconnectAllSlots() noexcept {
+    while(!mConnections.empty()) {
+      auto tracked = mConnections.back();
+      mConnections.pop_back();
+      tracked.pSignal->disconnect(tracked.connection);
+    }
+  }
 
-}  // namespace v1util
-#else
+ private:
+  friend class detail::SignalBase;
+
+  struct TrackedConnection {
+    detail::SignalBase* pSignal;
+    SignalConnection connection;
+  };
+  std::vector<TrackedConnection> mConnections;
+};
 
-#  include "function.hpp"
-#  include "v1util/utility/scope.hpp"
+using SigSlotObserver = SlotLifetimeTracker;
 
-#  include <memory>
-#  include <vector>
 
-namespace v1util {
-namespace detail {
-  struct SignalSlotConnection {
-    // TODO: Point to non-templated base signal and use some stable reference for the connection
-  };
+void detail::SignalBase::notifyOwnerAboutConnection(
+    SlotLifetimeTracker* pOwner, SignalConnection connection) {
+  pOwner->mConnections.push_back({this, connection});
 }
 
-class SlotLifetimeTracker {
- private:
-  std::vector<detail::SignalSlotConnection> mSlotConnections;
-};
+void detail::SignalBase::notifyOwnerAboutDisconnection(
+    SlotLifetimeTracker* pOwner, SignalConnection connection) noexcept {
+  auto& connections = pOwner->mConnections;
+  for(size_t i = 0; i < connections.size(); ++i) {
+    if(connections[i].pSignal == this && connections[i].connection == connection) {
+      connections[i] = connections.back();
+      connections.pop_back();
+      return;
+    }
+  }
+}
+
+
+//! Callables up to this size are stored inside a Signal's slot storage
+constexpr const size_t kSignalSlotInlineBytes = 4 * sizeof(uintptr_t);
 
-/* Emitter of an object where listeners (Slots) can register
+/** Single-threaded emitter of an object where listeners (slots) can register
+ *
+ * Slots are kept in a contiguous array of inline-stored Functions, in connection order.
+ * fire() doesn't allocate. disconnect() is O(1) and takes effect immediately, even during
+ * fire(); the slot's Function is destroyed after the emission. Connections made during fire()
+ * are called from the next emission on.
+ *
+ * Keep in mind: No copy. no move
  */
 template <typename Signature>
 class Signal;
 
 template <typename RetT, typename... Args>
-class Signal<RetT(Args...)> {
- private:
-  using FuncStorageT = Function<RetT(Args...)>;
-
-  struct Slot {
-    FuncStorageT slotFunction; 
-    SlotLifetimeTracker* pOwner = nullptr;
-    //TODO: some stable reference that identifies this connection so that pOwner can find it
-  };
-
+class Signal<RetT(Args...)> final : public detail::SignalBase {
  public:
-  V1_NO_CP_DEFAULT_MV_CTOR(Signal);
+  using SlotFunction = Function<RetT(Args...), kSignalSlotInlineBytes>;
+
+  Signal() = default;
+  V1_NO_CP_NO_MV(Signal);
+  ~Signal() {
+    V1_ASSERT(!mEmissionDepth);
+    disconnect_all();
+  }
 
   // TODO: rename -> emit
   void fire(Args... args) {
-    {
-      ValueScope<bool>(mInEmission, true);
-
-      for(const auto& slot : mSlots) {
-        if(slot) slot(args...);
-      }
+    const auto numSlots = mSlots.size();
+    ++mEmissionDepth;
+    for(size_t i = 0; i < numSlots; ++i) {
+      const auto& slot = mSlots[i];
+      if(slot.isConnected) slot.function(args...);
     }
+    --mEmissionDepth;
 
-    if(!mSlotsToAdd.empty()) {
-      mSlots.insert(mSlots.end(),
-          std::make_move_iterator(mSlotsToAdd.begin()),
-          std::make_move_iterator(mSlotsToAdd.end()));
-      mSlotsToAdd.clear();
-    }
+    if(!mEmissionDepth && (mNumDisconnected || !mPendingSlots.empty())) compact();
   }
 
+  /** Connect to a member function; connecting the same one twice yields the same connection
+   *
+   * If @p pSlotOwner is a SlotLifetimeTracker, it is disconnected on its destruction.
+   */
   template <auto pMemFn, typename Owner>
-  void connect(Owner* pSlotOwner) {
-    connect(FuncStorageT::template bind<pMemFn>(pSlotOwner),
-        std::is_base_of_v<SlotLifetimeTracker, Owner>
-            ? static_cast<SlotLifetimeTracker*>(pSlotOwner)
-            : nullptr);
+  SignalConnection connect(Owner* pSlotOwner) {
+    auto function = SlotFunction::template bind<pMemFn>(pSlotOwner);
+    if(auto pSlot = findSlot(function)) return connectionOf(*pSlot);
+
+    if constexpr(std::is_base_of_v<SlotLifetimeTracker, Owner>)
+      return addSlot(std::move(function), static_cast<SlotLifetimeTracker*>(pSlotOwner));
+    else
+      return addSlot(std::move(function), nullptr);
   }
 
   template <typename Functor>
-  void connect(Functor&& f) {
-    connect(FuncStorageT(f), nullptr);
+  SignalConnection connect(Functor&& f) {
+    return addSlot(SlotFunction(std::forward<Functor>(f)), nullptr);
   }
 
+  //! Connect a Callable that is disconnected when @p pOwner dies
+  template <typename Functor>
+  SignalConnection connect(SlotLifetimeTracker* pOwner, Functor&& f) {
+    return addSlot(SlotFunction(std::forward<Functor>(f)), pOwner);
+  }
+
+
+  void disconnect(SignalConnection connection) noexcept override {
+    if(!connected(connection)) return;
+
+    auto& slot = slotOf(mIds[connection.id]);
+    slot.isConnected = false;
+    mIds[connection.id].generation++;
+    mFreeIds.push_back(connection.id);  // capacity reserved in addSlot()
+    ++mNumDisconnected;
+
+    if(slot.pOwner) notifyOwnerAboutDisconnection(slot.pOwner, connection);
+  }
 
-  template <auto pMemFn, typename Arg>
-  void disconnect(Arg pSlotOwner) {}
-  void disconnect_all(){};
+  template <auto pMemFn, typename Owner>
+  void disconnect(Owner* pSlotOwner) noexcept {
+    if(auto pSlot = findSlot(SlotFunction::template bind<pMemFn>(pSlotOwner)))
+      disconnect(connectionOf(*pSlot));
+  }
+
+  void disconnect_all() noexcept {
+    for(auto* pSlots : {&mSlots, &mPendingSlots}) {
+      for(const auto& slot : *pSlots)
+        if(slot.isConnected) disconnect(connectionOf(slot));
+    }
+
+    if(!mEmissionDepth) compact();
+  }
+
+  bool connected(SignalConnection connection) const noexcept {
+    return connection.id < mIds.size() && mIds[connection.id].generation == connection.generation
+           && slotOf(mIds[connection.id]).isConnected;
+  }
 
  private:
-  void connect(Function<RetT(Args...)>&& function, SlotLifetimeTracker* pOwner) {
-    if(!mInEmission) {
-      mSlots.emplace_back(std::move(function));
+  struct Slot {
+    SlotFunction function;
+    SlotLifetimeTracker* pOwner = nullptr;
+    uint32_t id = 0;
+    bool isConnected = false;
+  };
+
+  struct IdEntry {
+    uint32_t slotIndex = 0;  // into mPendingSlots if kPendingSlotBit is set
+    uint32_t generation = 0;
+  };
+  static constexpr const uint32_t kPendingSlotBit = 1U << 31;
+
+  SignalConnection addSlot(SlotFunction&& function, SlotLifetimeTracker* pOwner) {
+    if(!mEmissionDepth && mNumDisconnected > mSlots.size() / 2) compact();
+
+    uint32_t id;
+    if(!mFreeIds.empty()) {
+      id = mFreeIds.back();
+      mFreeIds.pop_back();
     } else {
-      mSlotsToAdd.emplace_back(std::move(function));
+      id = uint32_t(mIds.size());
+      mIds.emplace_back();
+      mFreeIds.reserve(mIds.size());
     }
 
-    if(pOwner)
-      notifyOwnerAboutConnection(
-          pOwner, nullptr /* TODO: Bad idea. Track connection differently. */);
+    auto& slots = mEmissionDepth ? mPendingSlots : mSlots;
+    mIds[id].slotIndex = uint32_t(slots.size()) | (mEmissionDepth ? kPendingSlotBit : 0);
+    slots.push_back({std::move(function), pOwner, id, true});
+
+    const auto connection = SignalConnection{id, mIds[id].generation};
+    if(pOwner) notifyOwnerAboutConnection(pOwner, connection);
+    return connection;
   }
 
-  void notifyOwnerAboutConnection(SlotLifetimeTracker* pOwner, void* pMemFn) {}
-  void notifyOwnerAboutDisconnection(SlotLifetimeTracker* pOwner, void* pMemFn) {}
+  //! Drop disconnected slots and append the pending ones; only outside of emissions
+  void compact() noexcept {
+    V1_ASSERT(!mEmissionDepth);
+
+    size_t numKept = 0;
+    for(size_t i = 0; i < mSlots.size(); ++i) {
+      if(!mSlots[i].isConnected) continue;
+      if(i != numKept) mSlots[numKept] = std::move(mSlots[i]);
+      mIds[mSlots[numKept].id].slotIndex = uint32_t(numKept);
+      ++numKept;
+    }
+    mSlots.erase(mSlots.begin() + ptrdiff_t(numKept), mSlots.end());
+
+    for(auto& slot : mPendingSlots) {
+      if(!slot.isConnected) continue;
+      mIds[slot.id].slotIndex = uint32_t(mSlots.size());
+      mSlots.push_back(std::move(slot));
+    }
+    mPendingSlots.clear();
+    mNumDisconnected = 0;
+  }
+
+  Slot& slotOf(const IdEntry& entry) noexcept {
+    return entry.slotIndex & kPendingSlotBit ? mPendingSlots[entry.slotIndex & ~kPendingSlotBit]
+                                             : mSlots[entry.slotIndex];
+  }
+  const Slot& slotOf(const IdEntry& entry) const noexcept {
+    return const_cast<Signal*>(this)->slotOf(entry);
+  }
+
+  SignalConnection connectionOf(const Slot& slot) const noexcept {
+    return {slot.id, mIds[slot.id].generation};
+  }
+
+  const Slot* findSlot(const SlotFunction& function) const noexcept {
+    for(auto* pSlots : {&mSlots, &mPendingSlots}) {
+      for(const auto& slot : *pSlots)
+        if(slot.isConnected && slot.function == function) return &slot;
+    }
+    return nullptr;
+  }
 
   std::vector<Slot> mSlots;
-  std::vector<Slot> mSlotsToAdd;
-  bool mInEmission = false;
+  std::vector<Slot> mPendingSlots;  // connected during an emission
+  std::vector<IdEntry> mIds;
+  std::vector<uint32_t> mFreeIds;
+  size_t mNumDisconnected = 0;
+  int mEmissionDepth = 0;
 };
 
-#  define SigSlotObserver SlotLifetimeTracker
 }  // namespace v1util
-
-
-#endif
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "delegate.hpp"
+
+#include "v1util/base/cpppainrelief.hpp"
+#include "v1util/base/cppvtable.hpp"
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace v1util {
+
+namespace detail {
+template <auto pTarget>
+auto staticDispatchObjectPtr() {
+  if constexpr(std::is_member_function_pointer_v<decltype(pTarget)>)
+    return getMemberClassPtr(pTarget);
+  else
+    return nullptr;
+}
+
+//! Class* for member functions, std::nullptr_t for free functions
+template <auto pTarget>
+using StaticDispatchObject = decltype(staticDispatchObjectPtr<pTarget>());
+}  // namespace detail
+
+
+/** A fixed list of call targets, known at compile time
+ *
+ * Calling the list calls every target in order, with the same arguments (passed as lvalues).
+ * Targets are member functions or free functions; the objects of the member functions are
+ * passed to the constructor, nullptr for free functions:
+ *
+ *   auto graph = StaticDispatchList<void(float*, size_t), &Gain::process, &dcBlock,
+ *       &Meter::process>(&gain, nullptr, &meter);
+ *   graph(pSamples, numSamples);
+ *
+ * In contrast to a list of Delegates, there are no indirect calls, so the targets can be
+ * inlined into a single function. delegate() gives a runtime view with a single indirect call.
+ */
+template <typename Signature, auto... pTargets>
+class StaticDispatchList;
+
+template <typename... Args, auto... pTargets>
+class StaticDispatchList<void(Args...), pTargets...> {
+ public:
+  explicit StaticDispatchList(detail::StaticDispatchObject<pTargets>... pObjects) noexcept
+      : mObjects(pObjects...) {}
+  V1_DEFAULT_CP_MV(StaticDispatchList);
+
+  inline void operator()(Args... args) const {
+    callAll(std::index_sequence_for<decltype(pTargets)...>(), args...);
+  }
+
+  //! Valid as long as this list lives
+  Delegate<void(Args...)> delegate() const noexcept {
+    return Delegate<void(Args...)>::template bind<&StaticDispatchList::operator()>(this);
+  }
+
+  static constexpr size_t size() noexcept { return sizeof...(pTargets); }
+
+ private:
+  template <size_t... kIndices>
+  inline void callAll(std::index_sequence<kIndices...>, Args&... args) const {
+    (callTarget<pTargets>(std::get<kIndices>(mObjects), args...), ...);
+  }
+
+  template <auto pTarget, typename Object>
+  static inline void callTarget(Object pObject, Args&... args) {
+    if constexpr(std::is_member_function_pointer_v<decltype(pTarget)>)
+      (pObject->*pTarget)(args...);
+    else
+      pTarget(args...);
+  }
+
+  std::tuple<detail::StaticDispatchObject<pTargets>...> mObjects;
+};
+
+}  // namespace v1util
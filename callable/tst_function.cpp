@@ -4,6 +4,8 @@
 
 #include "doctest/doctest.h"
 
+#include <memory>
+
 
 namespace v1util::test::function {
 
@@ -341,6 +343,84 @@ TEST_CASE("function-callable-refcounting") {
   CHECK(counters == HeapBasedCallable::OpCounters{1, 2, 1, 0});
 }
 
+TEST_CASE("function-inline_capacity") {
+  using LargeFunction = Function<int(), 4 * sizeof(uintptr_t)>;
+  static_assert(sizeof(Function<int()>) == 2 * sizeof(uintptr_t));
+  static_assert(sizeof(LargeFunction) == 5 * sizeof(uintptr_t));
+
+  SUBCASE("trivial") {
+    int a = 1, b = 2, c = 3, d = 4;
+    auto lambda = [&a, &b, &c, &d]() { return a + b + c + d; };
+    static_assert(LargeFunction::fitsInline<decltype(lambda)>());
+    static_assert(!Function<int()>::fitsInline<decltype(lambda)>());
+
+    auto func = LargeFunction(lambda);
+    CHECK(func() == 10);
+    CHECK(!func.isHeapBased());
+    CHECK(func._refCount() == 0);
+
+    auto copy = func;
+    d = 40;
+    CHECK(copy() == 46);
+    CHECK(func == func);
+  }
+
+  SUBCASE("non-trivial") {
+    static_assert(LargeFunction::fitsInline<HeapBasedCallable>());
+    static_assert(!Function<int()>::fitsInline<HeapBasedCallable>());
+
+    HeapBasedCallable::OpCounters counters;
+    {
+      auto func = LargeFunction(HeapBasedCallable(&counters));
+      CHECK(counters == HeapBasedCallable::OpCounters{1, 0, 0, 1});
+      CHECK(!func.isHeapBased());
+      CHECK(func._refCount() == 0);
+      CHECK(func() == 23);
+
+      // in contrast to heap objects, copies are deep:
+      auto copy = func;
+      CHECK(counters == HeapBasedCallable::OpCounters{1, 0, 1, 1});
+      CHECK(copy() == 23);
+
+      auto movedIn = LargeFunction(std::move(copy));
+      CHECK(counters == HeapBasedCallable::OpCounters{1, 0, 1, 2});
+      CHECK(!copy);
+      CHECK(movedIn() == 23);
+
+      movedIn = func;
+      CHECK(counters == HeapBasedCallable::OpCounters{1, 1, 2, 2});
+
+      {
+        V1_NO_WARN_SELF_ASSIGNMENT
+        movedIn = movedIn;
+        V1_RESTORE_WARNINGS
+      }
+      CHECK(counters == HeapBasedCallable::OpCounters{1, 1, 2, 2});
+      CHECK(movedIn() == 23);
+
+      movedIn = std::move(func);
+      CHECK(counters == HeapBasedCallable::OpCounters{1, 2, 2, 3});
+      CHECK(!func);
+
+      movedIn = {};
+      CHECK(counters == HeapBasedCallable::OpCounters{1, 3, 2, 3});
+    }
+    CHECK(counters == HeapBasedCallable::OpCounters{1, 3, 2, 3});
+  }
+
+  SUBCASE("heap fallback") {
+    auto pValue = std::make_unique<int>(42);
+    auto moveOnlyLambda = [pValue = std::move(pValue)]() { return *pValue; };
+    static_assert(!LargeFunction::fitsInline<decltype(moveOnlyLambda)>());
+
+    auto func = LargeFunction(std::move(moveOnlyLambda));
+    CHECK(func() == 42);
+    CHECK(func.isHeapBased());
+    auto copy = func;
+    CHECK(copy._refCount() == 2);
+  }
+}
+
 TEST_CASE("function-equality") {
   SUBCASE("empty") {
     CHECK(Function<int()>() == Function<int()>());
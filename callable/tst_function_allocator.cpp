@@ -0,0 +1,173 @@
+#include "v1util/callable/function-allocator.hpp"
+#include "v1util/callable/function.hpp"
+
+#include "doctest/doctest.h"
+
+#include <array>
+#include <thread>
+#include <vector>
+
+namespace v1util::test::function_allocator {
+
+namespace {
+//! Large enough to never fit the inline storage of Function<int()>
+Function<int()> makeHeapBasedFunction(int value) {
+  std::array<int, 8> state = {value};
+  return Function<int()>([state]() { return state[0]; });
+}
+}  // namespace
+
+
+TEST_CASE("function_allocator-stats") {
+  const auto before = functionAllocationStats();
+  {
+    auto func = makeHeapBasedFunction(23);
+    CHECK(func.isHeapBased());
+    CHECK(func() == 23);
+
+    auto copy = func;
+    CHECK(copy() == 23);
+  }
+  const auto after = functionAllocationStats();
+  CHECK(after.allocations - before.allocations == 1);
+  CHECK(after.systemAllocations - before.systemAllocations == 1);
+  CHECK(after.frees - before.frees == 1);
+}
+
+TEST_CASE("function_allocator-pool") {
+  FunctionPoolAllocator pool(4);
+  std::vector<Function<int()>> funcs;
+
+  SUBCASE("steady state doesn't allocate") {
+    FunctionAllocatorScope scope(&pool);
+    const auto before = functionAllocationStats();
+    for(int i = 0; i < 100; ++i) {
+      funcs.push_back(makeHeapBasedFunction(i));
+      funcs.push_back(makeHeapBasedFunction(-i));
+      CHECK(funcs[0]() + funcs[1]() == 0);
+      funcs.clear();
+    }
+
+    const auto after = functionAllocationStats();
+    CHECK(after.allocations - before.allocations == 200);
+    CHECK(after.systemAllocations == before.systemAllocations);
+    CHECK(after.frees - before.frees == 200);
+  }
+
+  SUBCASE("exhaustion") {
+    funcs.reserve(6);
+    FunctionAllocatorScope scope(&pool);
+    const auto before = functionAllocationStats();
+    for(int i = 0; i < 6; ++i) funcs.push_back(makeHeapBasedFunction(i));
+    CHECK(functionAllocationStats().systemAllocations - before.systemAllocations == 2);
+    for(int i = 0; i < 6; ++i) CHECK(funcs[size_t(i)]() == i);
+
+    // the blocks are returned to the pool:
+    funcs.clear();
+    const auto afterClear = functionAllocationStats();
+    for(int i = 0; i < 4; ++i) funcs.push_back(makeHeapBasedFunction(i));
+    CHECK(functionAllocationStats().systemAllocations == afterClear.systemAllocations);
+    funcs.clear();
+  }
+
+  SUBCASE("too large") {
+    FunctionAllocatorScope scope(&pool);
+    const auto before = functionAllocationStats();
+    std::array<int, 128> state = {42};
+    auto func = Function<int()>([state]() { return state[0]; });
+    CHECK(func() == 42);
+    CHECK(functionAllocationStats().systemAllocations - before.systemAllocations == 1);
+  }
+}
+
+TEST_CASE("function_allocator-pool_threads") {
+  constexpr const size_t kNumThreads = 4;
+  constexpr const size_t kFuncsPerThread = 16;
+  FunctionPoolAllocator pool(kNumThreads * kFuncsPerThread);
+
+  std::array<uint64_t, kNumThreads> systemAllocations = {};
+  std::array<std::vector<Function<int()>>, kNumThreads> funcsPerThread;
+  auto runThreads = [&](auto threadFunc) {
+    std::vector<std::thread> threads;
+    for(size_t iThread = 0; iThread < kNumThreads; ++iThread)
+      threads.emplace_back([&, iThread]() {
+        FunctionAllocatorScope scope(&pool);
+        const auto before = functionAllocationStats().systemAllocations;
+        threadFunc(iThread);
+        systemAllocations[iThread] += functionAllocationStats().systemAllocations - before;
+      });
+    for(auto& thread : threads) thread.join();
+  };
+
+  // contended allocation + free:
+  runThreads([&](size_t iThread) {
+    auto& funcs = funcsPerThread[iThread];
+    for(int i = 0; i < 10000; ++i) {
+      funcs.push_back(makeHeapBasedFunction(i));
+      funcs.push_back(makeHeapBasedFunction(-i));
+      if(funcs[0]() + funcs[1]() != 0) break;
+      funcs.clear();
+    }
+  });
+
+  // free on a different thread than the allocating one:
+  runThreads([&](size_t iThread) {
+    for(size_t i = 0; i < kFuncsPerThread; ++i)
+      funcsPerThread[iThread].push_back(makeHeapBasedFunction(int(i)));
+  });
+  runThreads([&](size_t iThread) { funcsPerThread[(iThread + 1) % kNumThreads].clear(); });
+
+  for(auto count : systemAllocations) CHECK(count == 0);
+
+  // all blocks are back:
+  std::vector<Function<int()>> funcs;
+  FunctionAllocatorScope scope(&pool);
+  const auto before = functionAllocationStats();
+  for(size_t i = 0; i < kNumThreads * kFuncsPerThread; ++i)
+    funcs.push_back(makeHeapBasedFunction(int(i)));
+  CHECK(functionAllocationStats().systemAllocations == before.systemAllocations);
+  funcs.clear();
+}
+
+TEST_CASE("function_allocator-arena") {
+  FunctionArenaAllocator arena(1024);
+  std::vector<Function<int()>> funcs;
+  {
+    FunctionAllocatorScope scope(&arena);
+    const auto before = functionAllocationStats();
+    while(arena.capacity() - arena.used() >= 128) funcs.push_back(makeHeapBasedFunction(1));
+    CHECK(functionAllocationStats().systemAllocations == before.systemAllocations);
+    CHECK(arena.numLiveObjects() == funcs.size());
+
+    funcs.push_back(makeHeapBasedFunction(2));
+    funcs.push_back(makeHeapBasedFunction(3));
+    CHECK(functionAllocationStats().systemAllocations - before.systemAllocations >= 1);
+    CHECK(funcs.back()() == 3);
+  }
+
+  funcs.clear();
+  CHECK(arena.numLiveObjects() == 0);
+  arena.reset();
+  CHECK(arena.used() == 0);
+}
+
+TEST_CASE("function_allocator-default") {
+  FunctionPoolAllocator pool(1);
+  setDefaultFunctionAllocator(&pool);
+  {
+    const auto before = functionAllocationStats();
+    auto func = makeHeapBasedFunction(5);
+    CHECK(func() == 5);
+    CHECK(functionAllocationStats().systemAllocations == before.systemAllocations);
+
+    // the thread allocator has precedence:
+    FunctionArenaAllocator arena(0);
+    FunctionAllocatorScope scope(&arena);
+    auto func2 = makeHeapBasedFunction(6);
+    CHECK(func2() == 6);
+    CHECK(functionAllocationStats().systemAllocations - before.systemAllocations == 1);
+  }
+  setDefaultFunctionAllocator(nullptr);
+}
+
+}  // namespace v1util::test::function_allocator
@@ -0,0 +1,121 @@
+#include "v1util/callable/queued-signal.hpp"
+
+#include "v1util/callable/function-allocator.hpp"
+
+#include "doctest/doctest.h"
+
+#include <thread>
+#include <vector>
+
+namespace v1util::test::queued_signal {
+
+namespace {
+struct PeakEvent {
+  int64_t position;
+  float value;
+};
+
+class Receiver {
+ public:
+  void onPeak(const PeakEvent& peak) {
+    ++numPeaks;
+    lastPosition = peak.position;
+  }
+  void onParameter(int id, float value) { parameterSum += id * value; }
+
+  int numPeaks = 0;
+  int64_t lastPosition = -1;
+  float parameterSum = 0.F;
+};
+}  // namespace
+
+
+TEST_CASE("queued_signal-delivery on dispatch") {
+  SignalDispatchQueue queue(16);
+  Receiver receiver;
+  QueuedSignal<void(const PeakEvent&)> peakSignal;
+  QueuedSignal<void(int, float)> parameterSignal;
+  peakSignal.connect<&Receiver::onPeak>(&receiver, &queue);
+  parameterSignal.connect<&Receiver::onParameter>(&receiver, &queue);
+
+  {
+    // arguments are copied, even if passed by reference:
+    auto peak = PeakEvent{23, 1.F};
+    CHECK(peakSignal.emit(peak));
+    peak.position = 42;
+    CHECK(peakSignal.emit(peak));
+  }
+  CHECK(parameterSignal.emit(2, 0.5F));
+  CHECK(receiver.numPeaks == 0);
+
+  CHECK(queue.dispatch(1) == 1);
+  CHECK(receiver.numPeaks == 1);
+  CHECK(receiver.lastPosition == 23);
+
+  CHECK(queue.dispatch() == 2);
+  CHECK(receiver.numPeaks == 2);
+  CHECK(receiver.lastPosition == 42);
+  CHECK(receiver.parameterSum == doctest::Approx(1.F));
+
+  peakSignal.disconnect<&Receiver::onPeak>(&receiver);
+  CHECK(peakSignal.emit(PeakEvent{1, 1.F}));
+  CHECK(queue.dispatch() == 0);
+}
+
+TEST_CASE("queued_signal-full queue") {
+  SignalDispatchQueue queue(2);
+  int count = 0;
+  QueuedSignal<void()> signal;
+  signal.connect([&]() { ++count; }, &queue);
+
+  CHECK(signal.emit());
+  CHECK(signal.emit());
+  CHECK(!signal.emit());
+  CHECK(queue.numDropped() == 1);
+  CHECK(queue.dispatch() == 2);
+  CHECK(count == 2);
+}
+
+TEST_CASE("queued_signal-dispatch from an event") {
+  SignalDispatchQueue queue(8);
+  std::vector<int> calls;
+  QueuedSignal<void(int)> signal;
+  signal.connect(
+      [&](int id) {
+        calls.push_back(id);
+        if(id == 0) CHECK(queue.dispatch() == 2);
+      },
+      &queue);
+
+  for(int id = 0; id < 3; ++id) CHECK(signal.emit(id));
+  CHECK(queue.dispatch() == 1);
+  CHECK(calls == std::vector<int>{0, 1, 2});
+  CHECK(queue.dispatch() == 0);
+}
+
+TEST_CASE("queued_signal-threads") {
+  constexpr const int kNumEmitters = 3;
+  constexpr const int kNumEmissions = 10000;
+  SignalDispatchQueue queue(256);
+  Receiver receiver;
+  QueuedSignal<void(const PeakEvent&)> peakSignal;
+  peakSignal.connect<&Receiver::onPeak>(&receiver, &queue);
+
+  std::vector<std::thread> emitters;
+  std::vector<uint64_t> allocations(kNumEmitters);
+  for(int iEmitter = 0; iEmitter < kNumEmitters; ++iEmitter)
+    emitters.emplace_back([&, iEmitter]() {
+      const auto before = functionAllocationStats().allocations;
+      for(int i = 0; i < kNumEmissions; ++i)
+        while(!peakSignal.emit(PeakEvent{i, 1.F})) std::this_thread::yield();
+      allocations[size_t(iEmitter)] = functionAllocationStats().allocations - before;
+    });
+
+  while(receiver.numPeaks < kNumEmitters * kNumEmissions) queue.dispatch(64);
+  for(auto& emitter : emitters) emitter.join();
+
+  CHECK(receiver.numPeaks == kNumEmitters * kNumEmissions);
+  for(auto count : allocations) CHECK(count == 0);
+}
+
+}  // namespace v1util::test::queued_signal
@@ -0,0 +1,69 @@
+#include "v1util/callable/static-dispatch.hpp"
+
+#include "doctest/doctest.h"
+
+#include <vector>
+
+namespace v1util::test::static_dispatch {
+
+namespace {
+std::vector<int> sCallOrder;
+
+class Gain {
+ public:
+  void process(float* pSamples, size_t numSamples) {
+    sCallOrder.push_back(1);
+    for(size_t i = 0; i < numSamples; ++i) pSamples[i] *= mGain;
+  }
+  float mGain = 2.F;
+};
+
+class Meter {
+ public:
+  void process(float* pSamples, size_t numSamples) const {
+    sCallOrder.push_back(3);
+    for(size_t i = 0; i < numSamples; ++i) mPeak = pSamples[i] > mPeak ? pSamples[i] : mPeak;
+  }
+  mutable float mPeak = 0.F;
+};
+
+void sOffset(float* pSamples, size_t numSamples) {
+  sCallOrder.push_back(2);
+  for(size_t i = 0; i < numSamples; ++i) pSamples[i] += 1.F;
+}
+}  // namespace
+
+
+TEST_CASE("static_dispatch-calls") {
+  Gain gain;
+  Meter meter;
+  const auto graph = StaticDispatchList<void(float*, size_t), &Gain::process, &sOffset,
+      &Meter::process, &Gain::process>(&gain, nullptr, &meter, &gain);
+  static_assert(decltype(graph)::size() == 4);
+
+  float samples[] = {1.F, -2.F, 0.5F};
+  sCallOrder.clear();
+  graph(samples, 3);
+  CHECK(sCallOrder == std::vector<int>{1, 2, 3, 1});
+  CHECK(samples[0] == doctest::Approx(6.F));
+  CHECK(samples[1] == doctest::Approx(-6.F));
+  CHECK(samples[2] == doctest::Approx(4.F));
+  CHECK(meter.mPeak == doctest::Approx(3.F));
+
+  SUBCASE("delegate view") {
+    auto delegate = graph.delegate();
+    sCallOrder.clear();
+    delegate(samples, 1);
+    CHECK(sCallOrder == std::vector<int>{1, 2, 3, 1});
+    CHECK(samples[0] == doctest::Approx(26.F));
+  }
+}
+
+TEST_CASE("static_dispatch-empty") {
+  const auto nothing = StaticDispatchList<void(int)>();
+  static_assert(decltype(nothing)::size() == 0);
+  nothing(23);
+  nothing.delegate()(42);
+}
+
+}  // namespace v1util::test::static_dispatch
@@ -0,0 +1,55 @@
+#include "array_view.hpp"
+#include "range.hpp"
+#include "range_par.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <random>
+#include <vector>
+
+namespace v1util::bench {
+
+namespace {
+class RangeDataFixture {
+ public:
+  using Type = std::vector<float>;
+
+  Type& SetUp(const size_t& size) {
+    mData.resize(size);
+    std::mt19937 rng(0xC0FFEEU);
+    std::uniform_real_distribution<float> distribution(-0.5f, 0.5f);
+    for(auto& element : mData) element = distribution(rng);
+    return mData;
+  }
+  void TearDown() {}
+
+ private:
+  Type mData;
+};
+
+const std::vector<size_t> sRangeSizes = {1024, 1U << 16, 1U << 22};
+}  // namespace
+
+void rangeAccumulate(RangeDataFixture::Type& data, const size_t&) {
+  sltbench::DoNotOptimize(pmrange::accumulate(data, 0.f));
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(rangeAccumulate, RangeDataFixture, sRangeSizes);
+
+void rangeParAccumulate(RangeDataFixture::Type& data, const size_t&) {
+  sltbench::DoNotOptimize(
+      pmrange::par::accumulate(make_array_view(data), 0.f, &ThreadPool::global()));
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(rangeParAccumulate, RangeDataFixture, sRangeSizes);
+
+void rangeMinmaxElement(RangeDataFixture::Type& data, const size_t&) {
+  sltbench::DoNotOptimize(*pmrange::minmax_element(data).second);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(rangeMinmaxElement, RangeDataFixture, sRangeSizes);
+
+void rangeParMinmaxElement(RangeDataFixture::Type& data, const size_t&) {
+  sltbench::DoNotOptimize(
+      *pmrange::par::minmax_element(make_array_view(data), &ThreadPool::global()).second);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(rangeParMinmaxElement, RangeDataFixture, sRangeSizes);
+
+}  // namespace v1util::bench
@@ -0,0 +1,84 @@
+#include "ringbuffer.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <random>
+#include <vector>
+
+namespace v1util::bench {
+
+namespace {
+constexpr const size_t kNumElements = 1U << 16;
+
+class RingBufferFixture {
+ public:
+  using Type = ChunkedRingBuffer<float>;
+
+  Type& SetUp(const size_t&) {
+    mRingBuffer.setCapacity(kNumElements);
+    return mRingBuffer;
+  }
+  void TearDown() {}
+
+ private:
+  Type mRingBuffer;
+};
+
+std::vector<float> sChunkData(kNumElements, 1.f);
+
+const std::vector<size_t> sChunkSizes = {16, 256, 4096};
+}  // namespace
+
+void ringBufferFillDrain(RingBufferFixture::Type& ringBuffer, const size_t& chunkSize) {
+  for(size_t offset = 0; offset < kNumElements; offset += chunkSize) {
+    ringBuffer.fillFrom(make_array_view(sChunkData).subview(offset, chunkSize));
+    ringBuffer.drainTo(make_span(sChunkData).subspan(offset, chunkSize));
+  }
+  sltbench::DoNotOptimize(sChunkData.front());
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(ringBufferFillDrain, RingBufferFixture, sChunkSizes);
+
+void ringBufferPushPop(RingBufferFixture::Type& ringBuffer, const size_t& chunkSize) {
+  float sum = 0.f;
+  for(size_t offset = 0; offset < kNumElements; offset += chunkSize) {
+    for(size_t i = 0; i < chunkSize; ++i) ringBuffer.push(float(i));
+    for(size_t i = 0; i < chunkSize; ++i) sum += ringBuffer.pop();
+  }
+  sltbench::DoNotOptimize(sum);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(ringBufferPushPop, RingBufferFixture, sChunkSizes);
+
+
+namespace {
+class DequeFixture {
+ public:
+  using Type = FixedSizeDeque<size_t>;
+
+  Type& SetUp(const size_t& windowSize) {
+    mDeque = Type{};
+    mDeque.setCapacity(windowSize + 1);
+    return mDeque;
+  }
+  void TearDown() {}
+
+ private:
+  Type mDeque;
+};
+
+const std::vector<size_t> sWindowSizes = {8, 64, 512};
+}  // namespace
+
+//! The access pattern of a monotonic deque as used by sliding window extrema
+void fixedSizeDequeSlidingWindow(DequeFixture::Type& deque, const size_t& windowSize) {
+  std::minstd_rand rng(0x12345678U);
+  for(size_t i = 0; i < kNumElements; ++i) {
+    const auto value = size_t(rng());
+    while(!deque.empty() && deque.back() <= value) deque.pop_back();
+    if(deque.size() == windowSize) deque.pop_front();
+    deque.push_back(value);
+    if(i % windowSize == 0) sltbench::DoNotOptimize(deque.front());
+  }
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(fixedSizeDequeSlidingWindow, DequeFixture, sWindowSizes);
+
+}  // namespace v1util::bench
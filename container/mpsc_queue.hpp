@@ -0,0 +1,106 @@
+#pragma once
+
+#include "v1util/base/bitop.hpp"
+#include "v1util/base/cpppainrelief.hpp"
+#include "v1util/base/debug.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace v1util {
+
+/** Bounded lock-free multi-producer single-consumer queue
+ *
+ * Based on Dmitry Vyukov's bounded MPMC queue: every cell carries a sequence number that tells
+ * producers and the consumer whether it is theirs. Producers contend on a single CAS, the
+ * consumer doesn't need any. Neither side blocks or allocates after construction; tryPush()
+ * fails if the queue is full.
+ *
+ * T has to be default constructible and move assignable.
+ */
+template <typename T>
+class MpscQueue {
+ public:
+  //! @p capacity is rounded up to a power of two
+  explicit MpscQueue(uint64_t capacity)
+      : mMask(nextPow2(capacity < 2 ? uint64_t(2) : capacity) - 1),
+        mpCells(std::make_unique<Cell[]>(mMask + 1)) {
+    for(uint64_t i = 0; i <= mMask; ++i) mpCells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  V1_NO_CP_NO_MV(MpscQueue);
+
+  //! From any thread
+  bool tryPush(T&& value) noexcept {
+    auto pos = mEnqueuePos.load(std::memory_order_relaxed);
+    Cell* pCell;
+    while(true) {
+      pCell = &mpCells[pos & mMask];
+      const auto sequence = pCell->sequence.load(std::memory_order_acquire);
+      const auto diff = int64_t(sequence) - int64_t(pos);
+      if(diff == 0) {
+        if(mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if(diff < 0)
+        return false;  // full
+      else
+        pos = mEnqueuePos.load(std::memory_order_relaxed);
+    }
+
+    pCell->value = std::move(value);
+    pCell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  //! From the consumer thread only
+  bool tryPop(T* pValue) noexcept {
+    auto& cell = mpCells[mDequeuePos & mMask];
+    if(cell.sequence.load(std::memory_order_acquire) != mDequeuePos + 1) return false;
+
+    *pValue = std::move(cell.value);
+    cell.value = T();
+    cell.sequence.store(mDequeuePos + mMask + 1, std::memory_order_release);
+    ++mDequeuePos;
+    return true;
+  }
+
+  /** Pop up to @p maxCount elements, one at a time, and pass each to @p consumer
+   *
+   * From the consumer thread only. Elements pushed concurrently may or may not be consumed.
+   * Every element is popped before @p consumer is called, so @p consumer may call consume() or
+   * tryPop() itself; those continue with the next element.
+   * @return the number of elements passed to @p consumer
+   */
+  template <typename Consumer>
+  uint64_t consume(Consumer&& consumer, uint64_t maxCount = ~uint64_t(0)) {
+    uint64_t count = 0;
+    for(; count < maxCount; ++count) {
+      auto& cell = mpCells[mDequeuePos & mMask];
+      if(cell.sequence.load(std::memory_order_acquire) != mDequeuePos + 1) break;
+
+      auto value = std::move(cell.value);
+      cell.value = T();
+      cell.sequence.store(mDequeuePos + mMask + 1, std::memory_order_release);
+      ++mDequeuePos;
+      consumer(value);
+    }
+    return count;
+  }
+
+  //! From the consumer thread only; a snapshot while producers are active
+  uint64_t size() const noexcept { return mEnqueuePos.load() - mDequeuePos; }
+  uint64_t capacity() const noexcept { return mMask + 1; }
+
+ private:
+  struct Cell {
+    std::atomic<uint64_t> sequence = 0;
+    T value = {};
+  };
+
+  const uint64_t mMask;
+  const std::unique_ptr<Cell[]> mpCells;
+  alignas(64) std::atomic<uint64_t> mEnqueuePos = 0;  // separate cache lines
+  alignas(64) uint64_t mDequeuePos = 0;
+};
+
+}  // namespace v1util
@@ -0,0 +1,314 @@
+#pragma once
+
+#include "range.hpp"
+
+#include "v1util/base/thread_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+
+/** Parallel and vectorized counterparts of the pmrange reductions
+ *
+ * Same signatures as in pmrange, plus an optional ThreadPool. Ranges are cut into chunks of a
+ * fixed size, which are reduced on the pool if there is one and the range is large enough, and
+ * combined in order. Without a pool, or for smaller ranges, everything happens on the calling
+ * thread, and nothing is allocated either way: the results of the chunks are kept on the stack,
+ * in batches of kChunksPerBatch.
+ *
+ * Contiguous ranges of arithmetic types (ArrayView, Span, std::vector, ...) are reduced with
+ * independent lanes, which the compiler vectorizes for sums and for integer min/max; float
+ * min/max lanes at least don't form one long dependency chain.
+ *
+ * Results don't depend on the number of threads. Floating point sums are pairwise over blocks
+ * and within batches, so they are usually more accurate than std::accumulate, but not bitwise
+ * identical to it. Ranges without random access iterators fall back to pmrange. Predicates and
+ * element types have to be safe to use from several threads. NaNs are not supported by the
+ * min/max functions.
+ */
+
+namespace v1util { namespace pmrange { namespace par {
+
+//! Elements per chunk; fixed, so that results don't depend on the number of threads
+constexpr const size_t kChunkSize = size_t(1) << 14;
+//! Smaller ranges are reduced on the calling thread
+constexpr const size_t kMinParallelSize = size_t(1) << 16;
+//! Chunks whose results are combined at a time
+constexpr const size_t kChunksPerBatch = 64;
+
+namespace detail {
+template <typename Range>
+using Iterator = decltype(std::begin(std::declval<Range&>()));
+
+template <typename Range>
+using Value = std::remove_cv_t<std::remove_reference_t<decltype(*std::declval<Iterator<Range>>())>>;
+
+template <typename Range>
+constexpr bool isRandomAccess = std::is_base_of_v<std::random_access_iterator_tag,
+    typename std::iterator_traits<Iterator<Range>>::iterator_category>;
+
+template <typename Range, typename = void>
+struct IsContiguousArithmetic : std::false_type {};
+template <typename Range>
+struct IsContiguousArithmetic<Range, std::void_t<decltype(std::declval<Range&>().data())>>
+    : std::is_arithmetic<Value<Range>> {};
+
+template <typename Range>
+constexpr bool isContiguousArithmetic = IsContiguousArithmetic<std::remove_reference_t<Range>>{};
+
+constexpr const size_t kLanes = 8;
+constexpr const size_t kSumBlockSize = 256;
+
+//! Blocks of kSumBlockSize in lanes, then pairwise; the split points only depend on @p count
+template <typename Acc, typename T>
+Acc sumContiguous(const T* pElements, size_t count) {
+  if(count > kSumBlockSize) {
+    const auto half = (count / 2 + kSumBlockSize - 1) / kSumBlockSize * kSumBlockSize;
+    return sumContiguous<Acc>(pElements, half) + sumContiguous<Acc>(pElements + half, count - half);
+  }
+
+  Acc lanes[kLanes] = {};
+  const auto vectorCount = count - count % kLanes;
+  for(size_t i = 0; i < vectorCount; i += kLanes)
+    for(size_t lane = 0; lane < kLanes; ++lane) lanes[lane] += Acc(pElements[i + lane]);
+  for(size_t i = vectorCount; i < count; ++i) lanes[i - vectorCount] += Acc(pElements[i]);
+  return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3]))
+         + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+template <typename T>
+T minContiguous(const T* pElements, size_t count) {
+  T lanes[kLanes];
+  std::fill(lanes, lanes + kLanes, pElements[0]);
+  const auto vectorCount = count - count % kLanes;
+  for(size_t i = 0; i < vectorCount; i += kLanes) {
+    for(size_t lane = 0; lane < kLanes; ++lane) {
+      const auto element = pElements[i + lane];
+      lanes[lane] = element < lanes[lane] ? element : lanes[lane];
+    }
+  }
+  for(size_t i = vectorCount; i < count; ++i) lanes[0] = std::min(lanes[0], pElements[i]);
+  return *std::min_element(lanes, lanes + kLanes);
+}
+
+template <typename T>
+T maxContiguous(const T* pElements, size_t count) {
+  T lanes[kLanes];
+  std::fill(lanes, lanes + kLanes, pElements[0]);
+  const auto vectorCount = count - count % kLanes;
+  for(size_t i = 0; i < vectorCount; i += kLanes) {
+    for(size_t lane = 0; lane < kLanes; ++lane) {
+      const auto element = pElements[i + lane];
+      lanes[lane] = element > lanes[lane] ? element : lanes[lane];
+    }
+  }
+  for(size_t i = vectorCount; i < count; ++i) lanes[0] = std::max(lanes[0], pElements[i]);
+  return *std::max_element(lanes, lanes + kLanes);
+}
+
+/** Reduce every chunk to a Partial by @p reduceChunk(begin, count), on @p pPool if it pays off
+ *
+ * The partials are passed to @p combine(const Partial*, size_t count) in order, at most
+ * kChunksPerBatch at a time.
+ */
+template <typename Partial, typename ReduceChunk, typename Combine>
+void reduceChunks(size_t size, ThreadPool* pPool, ReduceChunk&& reduceChunk, Combine&& combine) {
+  constexpr const auto kBatchSize = kChunksPerBatch * kChunkSize;
+  const auto isParallel = pPool && size >= kMinParallelSize && pPool->concurrency() > 1;
+  Partial partials[kChunksPerBatch];
+  for(size_t batchBegin = 0; batchBegin < size; batchBegin += kBatchSize) {
+    const auto batchSize = std::min(kBatchSize, size - batchBegin);
+    const auto numChunks = (batchSize + kChunkSize - 1) / kChunkSize;
+    auto reduce = [&](size_t iChunk) {
+      const auto begin = iChunk * kChunkSize;
+      partials[iChunk] = reduceChunk(batchBegin + begin, std::min(kChunkSize, batchSize - begin));
+    };
+    if(isParallel)
+      pPool->parallelFor(numChunks, reduce);
+    else
+      for(size_t iChunk = 0; iChunk < numChunks; ++iChunk) reduce(iChunk);
+    combine(static_cast<const Partial*>(partials), numChunks);
+  }
+}
+
+template <typename T>
+T sumPairwise(const T* pPartials, size_t count) {
+  if(count == 1) return pPartials[0];
+  const auto half = count / 2;
+  return sumPairwise(pPartials, half) + sumPairwise(pPartials + half, count - half);
+}
+
+struct ChunkExtremes {
+  size_t minIndex = 0;
+  size_t maxIndex = 0;
+};
+
+//! First minimum and last maximum, as in std::minmax_element; either one is skipped if not wanted
+template <typename Range>
+ChunkExtremes extremesOfChunk(
+    Range& range, size_t begin, size_t count, bool wantsMin, bool wantsFirstMax) {
+  ChunkExtremes result;
+  if constexpr(isContiguousArithmetic<Range>) {
+    const auto* pChunk = range.data() + begin;
+    if(wantsMin) {
+      const auto minValue = minContiguous(pChunk, count);
+      result.minIndex = begin + size_t(std::find(pChunk, pChunk + count, minValue) - pChunk);
+    }
+    const auto maxValue = maxContiguous(pChunk, count);
+    if(wantsFirstMax) {
+      result.maxIndex = begin + size_t(std::find(pChunk, pChunk + count, maxValue) - pChunk);
+    } else {
+      auto iLast = count;
+      while(!(pChunk[iLast - 1] == maxValue)) --iLast;
+      result.maxIndex = begin + iLast - 1;
+    }
+  } else {
+    const auto iBegin = std::begin(range) + ptrdiff_t(begin);
+    const auto iEnd = iBegin + ptrdiff_t(count);
+    if(wantsFirstMax) {
+      result.minIndex = begin + size_t(std::min_element(iBegin, iEnd) - iBegin);
+      result.maxIndex = begin + size_t(std::max_element(iBegin, iEnd) - iBegin);
+    } else {
+      const auto minmax = std::minmax_element(iBegin, iEnd);
+      result.minIndex = begin + size_t(minmax.first - iBegin);
+      result.maxIndex = begin + size_t(minmax.second - iBegin);
+    }
+  }
+  return result;
+}
+
+}  // namespace detail
+
+
+template <class Range, class T>
+T accumulate(Range&& range, T init, ThreadPool* pPool = nullptr) {
+  if constexpr(!detail::isRandomAccess<Range>) {
+    return pmrange::accumulate(range, std::move(init));
+  } else {
+    const auto size = size_t(std::end(range) - std::begin(range));
+    auto result = std::move(init);
+    detail::reduceChunks<T>(
+        size, pPool,
+        [&](size_t begin, size_t count) {
+          if constexpr(detail::isContiguousArithmetic<Range> && std::is_arithmetic_v<T>) {
+            return detail::sumContiguous<T>(range.data() + begin, count);
+          } else {
+            const auto iBegin = std::begin(range) + ptrdiff_t(begin);
+            return std::accumulate(iBegin + 1, iBegin + ptrdiff_t(count), T(*iBegin));
+          }
+        },
+        [&](const T* pPartials, size_t count) {
+          if constexpr(std::is_arithmetic_v<T>)
+            result = result + detail::sumPairwise(pPartials, count);
+          else
+            result = std::accumulate(pPartials, pPartials + count, std::move(result));
+        });
+    return result;
+  }
+}
+
+template <class Range, class Predicate>
+size_t count_if(Range&& range, Predicate pred, ThreadPool* pPool = nullptr) {
+  if constexpr(!detail::isRandomAccess<Range>) {
+    return pmrange::count_if(range, std::move(pred));
+  } else {
+    const auto size = size_t(std::end(range) - std::begin(range));
+    size_t result = 0;
+    detail::reduceChunks<size_t>(
+        size, pPool,
+        [&](size_t begin, size_t count) {
+          const auto iBegin = std::begin(range) + ptrdiff_t(begin);
+          return size_t(std::count_if(iBegin, iBegin + ptrdiff_t(count), pred));
+        },
+        [&](const size_t* pCounts, size_t count) {
+          result = std::accumulate(pCounts, pCounts + count, result);
+        });
+    return result;
+  }
+}
+
+//! The first smallest element
+template <typename Range>
+auto min_element(Range&& range, ThreadPool* pPool = nullptr) {
+  if constexpr(!detail::isRandomAccess<Range>) {
+    return pmrange::min_element(range);
+  } else {
+    const auto iBegin = std::begin(range);
+    const auto size = size_t(std::end(range) - iBegin);
+    if(!size) return std::end(range);
+
+    size_t minIndex = 0;
+    detail::reduceChunks<detail::ChunkExtremes>(
+        size, pPool,
+        [&](size_t begin, size_t count) {
+          return detail::extremesOfChunk(range, begin, count, true, true);
+        },
+        [&](const detail::ChunkExtremes* pChunks, size_t count) {
+          for(size_t i = 0; i < count; ++i)
+            if(iBegin[ptrdiff_t(pChunks[i].minIndex)] < iBegin[ptrdiff_t(minIndex)])
+              minIndex = pChunks[i].minIndex;
+        });
+    return iBegin + ptrdiff_t(minIndex);
+  }
+}
+
+//! The first largest element
+template <typename Range>
+auto max_element(Range&& range, ThreadPool* pPool = nullptr) {
+  if constexpr(!detail::isRandomAccess<Range>) {
+    return pmrange::max_element(range);
+  } else {
+    const auto iBegin = std::begin(range);
+    const auto size = size_t(std::end(range) - iBegin);
+    if(!size) return std::end(range);
+
+    size_t maxIndex = 0;
+    detail::reduceChunks<detail::ChunkExtremes>(
+        size, pPool,
+        [&](size_t begin, size_t count) {
+          return detail::extremesOfChunk(range, begin, count, false, true);
+        },
+        [&](const detail::ChunkExtremes* pChunks, size_t count) {
+          for(size_t i = 0; i < count; ++i)
+            if(iBegin[ptrdiff_t(maxIndex)] < iBegin[ptrdiff_t(pChunks[i].maxIndex)])
+              maxIndex = pChunks[i].maxIndex;
+        });
+    return iBegin + ptrdiff_t(maxIndex);
+  }
+}
+
+//! The first smallest and the last largest element, as std::minmax_element
+template <typename Range>
+auto minmax_element(Range&& range, ThreadPool* pPool = nullptr) {
+  if constexpr(!detail::isRandomAccess<Range>) {
+    return pmrange::minmax_element(range);
+  } else {
+    const auto iBegin = std::begin(range);
+    const auto size = size_t(std::end(range) - iBegin);
+    if(!size) return std::make_pair(std::end(range), std::end(range));
+
+    size_t minIndex = 0;
+    size_t maxIndex = 0;
+    detail::reduceChunks<detail::ChunkExtremes>(
+        size, pPool,
+        [&](size_t begin, size_t count) {
+          return detail::extremesOfChunk(range, begin, count, true, false);
+        },
+        [&](const detail::ChunkExtremes* pChunks, size_t count) {
+          for(size_t i = 0; i < count; ++i) {
+            const auto& chunk = pChunks[i];
+            if(iBegin[ptrdiff_t(chunk.minIndex)] < iBegin[ptrdiff_t(minIndex)])
+              minIndex = chunk.minIndex;
+            if(!(iBegin[ptrdiff_t(chunk.maxIndex)] < iBegin[ptrdiff_t(maxIndex)]))
+              maxIndex = chunk.maxIndex;
+          }
+        });
+    return std::make_pair(iBegin + ptrdiff_t(minIndex), iBegin + ptrdiff_t(maxIndex));
+  }
+}
+
+}}}  // namespace v1util::pmrange::par
@@ -0,0 +1,71 @@
+#include "mpsc_queue.hpp"
+
+#include "doctest/doctest.h"
+
+#include <thread>
+#include <vector>
+
+namespace v1util { namespace container { namespace test {
+
+TEST_CASE("mpscQueue-basics") {
+  MpscQueue<int> queue(3);
+  CHECK(queue.capacity() == 4);
+
+  int value = 0;
+  CHECK(!queue.tryPop(&value));
+  for(int i = 1; i <= 4; ++i) CHECK(queue.tryPush(int(i)));
+  CHECK(!queue.tryPush(5));
+  CHECK(queue.size() == 4);
+
+  CHECK(queue.tryPop(&value));
+  CHECK(value == 1);
+  CHECK(queue.tryPush(5));
+
+  std::vector<int> consumed;
+  CHECK(queue.consume([&](int& x) { consumed.push_back(x); }, 2) == 2);
+  CHECK(queue.consume([&](int& x) { consumed.push_back(x); }) == 2);
+  CHECK(consumed == std::vector<int>{2, 3, 4, 5});
+
+  // re-entrant: the nested call continues after the element being consumed
+  for(int i = 0; i < 3; ++i) CHECK(queue.tryPush(int(i)));
+  consumed.clear();
+  const auto consumeNested = [&](int& x) {
+    consumed.push_back(x);
+    queue.consume([&](int& y) { consumed.push_back(10 + y); }, 1);
+  };
+  CHECK(queue.consume(consumeNested, 2) == 2);
+  CHECK(consumed == std::vector<int>{0, 11, 2});
+  CHECK(queue.size() == 0);
+}
+
+TEST_CASE("mpscQueue-threads") {
+  constexpr const int kNumProducers = 4;
+  constexpr const int kNumValuesPerProducer = 20000;
+  MpscQueue<int> queue(64);
+
+  std::vector<std::thread> producers;
+  for(int iProducer = 0; iProducer < kNumProducers; ++iProducer)
+    producers.emplace_back([&, iProducer]() {
+      for(int i = 0; i < kNumValuesPerProducer; ++i)
+        while(!queue.tryPush(iProducer * kNumValuesPerProducer + i)) std::this_thread::yield();
+    });
+
+  // per producer, values arrive in order:
+  std::vector<int> lastValues(kNumProducers, -1);
+  int numConsumed = 0;
+  bool inOrder = true;
+  while(numConsumed < kNumProducers * kNumValuesPerProducer) {
+    numConsumed += int(queue.consume([&](int& value) {
+      auto& lastValue = lastValues[size_t(value / kNumValuesPerProducer)];
+      inOrder &= value % kNumValuesPerProducer == lastValue + 1;
+      lastValue = value % kNumValuesPerProducer;
+    }));
+  }
+  for(auto& producer : producers) producer.join();
+
+  CHECK(inOrder);
+  CHECK(queue.size() == 0);
+  for(auto lastValue : lastValues) CHECK(lastValue == kNumValuesPerProducer - 1);
+}
+
+}}}  // namespace v1util::container::test
@@ -0,0 +1,102 @@
+#include "range_par.hpp"
+
+#include "array_view.hpp"
+
+#include "doctest/doctest.h"
+
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <random>
+#include <vector>
+
+namespace v1util { namespace test {
+
+namespace {
+std::vector<float> makeData(size_t size) {
+  std::vector<float> data(size);
+  std::mt19937 rng(0x5EEDU);
+  std::uniform_real_distribution<float> distribution(1000.f, 1001.f);
+  for(auto& element : data) element = distribution(rng);
+  return data;
+}
+
+//! Sizes around the chunk, parallel and batch thresholds
+const size_t kSizes[] = {1, 7, 300, pmrange::par::kChunkSize + 3, pmrange::par::kMinParallelSize,
+    3 * pmrange::par::kMinParallelSize + 11,
+    pmrange::par::kChunksPerBatch * pmrange::par::kChunkSize + 5};
+}  // namespace
+
+TEST_CASE("pmrange-par-accumulate") {
+  ThreadPool pool(3);
+
+  CHECK(pmrange::par::accumulate(std::vector<int>{}, 42, &pool) == 42);
+
+  for(auto size : kSizes) {
+    std::vector<int64_t> ints(size);
+    for(size_t i = 0; i < size; ++i) ints[i] = int64_t(i * 7919 % 1000) - 500;
+    CHECK(pmrange::par::accumulate(ints, int64_t(3), &pool)
+          == pmrange::accumulate(ints, int64_t(3)));
+
+    // floats: independent of the number of threads, and more accurate than a serial float sum
+    const auto data = makeData(size);
+    const auto view = make_array_view(data);
+    const auto sum = pmrange::par::accumulate(view, 0.f, &pool);
+    CHECK(sum == pmrange::par::accumulate(view, 0.f));
+    const auto exact = pmrange::accumulate(data, 0.);
+    const auto serialError = std::abs(double(pmrange::accumulate(data, 0.f)) - exact);
+    CHECK(std::abs(double(sum) - exact) <= serialError + 1e-6 * exact);
+    CHECK(pmrange::par::accumulate(view, 0., &pool) == doctest::Approx(exact).epsilon(1e-12));
+  }
+
+  // non-contiguous and non-random access ranges
+  std::list<int> list = {1, 2, 3, 4};
+  CHECK(pmrange::par::accumulate(list, 10, &pool) == 20);
+  struct Value {
+    int value = 0;
+    Value operator+(const Value& o) const { return {value + o.value}; }
+  };
+  std::vector<Value> values(pmrange::par::kMinParallelSize + 5, Value{2});
+  CHECK(pmrange::par::accumulate(values, Value{1}, &pool).value == int(values.size()) * 2 + 1);
+}
+
+TEST_CASE("pmrange-par-count_if") {
+  ThreadPool pool(3);
+  for(auto size : kSizes) {
+    const auto data = makeData(size);
+    auto isLarge = [](float value) { return value > 1000.5f; };
+    CHECK(pmrange::par::count_if(data, isLarge, &pool) == size_t(pmrange::count_if(data, isLarge)));
+  }
+  CHECK(pmrange::par::count_if(std::list<int>{1, 2, 3}, [](int i) { return i > 1; }, &pool) == 2U);
+}
+
+TEST_CASE("pmrange-par-min_max") {
+  ThreadPool pool(3);
+
+  std::vector<float> empty;
+  CHECK(pmrange::par::min_element(empty, &pool) == empty.end());
+  CHECK(pmrange::par::minmax_element(empty, &pool).second == empty.end());
+
+  for(auto size : kSizes) {
+    auto data = makeData(size);
+    // ties across chunks: first minimum and maximum, but the last maximum for minmax_element
+    if(size > pmrange::par::kChunkSize) {
+      data[5] = data[size - 2] = 2000.f;
+      data[6] = data[size - 3] = 0.f;
+    }
+
+    const auto view = make_array_view(data);
+    CHECK(pmrange::par::min_element(view, &pool) == pmrange::min_element(view));
+    CHECK(pmrange::par::max_element(view, &pool) == pmrange::max_element(view));
+    CHECK(pmrange::par::minmax_element(view, &pool) == pmrange::minmax_element(view));
+    CHECK(pmrange::par::minmax_element(view) == pmrange::minmax_element(view));
+
+    std::vector<int16_t> ints(data.begin(), data.end());
+    CHECK(pmrange::par::minmax_element(ints, &pool) == pmrange::minmax_element(ints));
+  }
+
+  std::list<int> list = {3, 1, 4, 1, 5};
+  CHECK(*pmrange::par::max_element(list, &pool) == 5);
+}
+
+}}  // namespace v1util::test
@@ -0,0 +1,156 @@
+#include "perfcounters.hpp"
+
+#include "tracing.hpp"
+
+#include "v1util/base/debug.hpp"
+
+#if defined(V1_OS_LINUX)
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  include <cstring>
+#endif
+
+namespace v1util::tracing {
+
+/*
+ * platform-dependent:
+ */
+
+#if defined(V1_OS_LINUX)
+
+namespace {
+
+constexpr const size_t kNumCounters = 4;
+
+//! The calling thread's counter group. Counts from opening until the thread exits.
+class PerfCounterGroup {
+ public:
+  PerfCounterGroup() {
+    const uint64_t configs[kNumCounters] = {PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+    for(size_t i = 0; i < kNumCounters; ++i) {
+      perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = configs[i];
+      attr.disabled = i == 0 ? 1 : 0;  // the whole group is enabled via the leader
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+                         | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+      mFds[i] = int(::syscall(SYS_perf_event_open, &attr, 0, -1, mFds[0], 0));
+      if(mFds[i] < 0) {
+        close();
+        return;
+      }
+    }
+
+    ::ioctl(mFds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ::ioctl(mFds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+
+  ~PerfCounterGroup() { close(); }
+  V1_NO_CP_NO_MV(PerfCounterGroup);
+
+  bool valid() const { return mFds[0] >= 0; }
+
+  bool read(PerfCounterValues* pValues) const {
+    if(!valid()) return false;
+
+    struct {
+      uint64_t nr;
+      uint64_t timeEnabled;
+      uint64_t timeRunning;
+      uint64_t values[kNumCounters];
+    } data;
+    if(::read(mFds[0], &data, sizeof(data)) != ssize_t(sizeof(data))) return false;
+    if(data.nr != kNumCounters || !data.timeRunning) return false;
+
+    // The kernel multiplexes the group if there are more events than counters; extrapolate:
+    const auto scale = [&](uint64_t value) {
+      if(data.timeRunning == data.timeEnabled) return value;
+      return uint64_t(double(value) * double(data.timeEnabled) / double(data.timeRunning));
+    };
+    pValues->cycles = scale(data.values[0]);
+    pValues->instructions = scale(data.values[1]);
+    pValues->cacheMisses = scale(data.values[2]);
+    pValues->branchMisses = scale(data.values[3]);
+    return true;
+  }
+
+ private:
+  void close() {
+    for(auto& fd : mFds) {
+      if(fd >= 0) ::close(fd);
+      fd = -1;
+    }
+  }
+
+  int mFds[kNumCounters] = {-1, -1, -1, -1};
+};
+
+const PerfCounterGroup& threadCounterGroup() {
+  thread_local PerfCounterGroup tGroup;
+  return tGroup;
+}
+
+}  // namespace
+
+bool perfCountersAvailable() {
+  return threadCounterGroup().valid();
+}
+
+bool readPerfCounters(PerfCounterValues* pValues) {
+  return threadCounterGroup().read(pValues);
+}
+
+#else
+
+bool perfCountersAvailable() {
+  return false;
+}
+
+bool readPerfCounters(PerfCounterValues*) {
+  return false;
+}
+
+#endif
+
+
+/*
+ * platform-independent:
+ */
+
+namespace detail {
+
+PerfCounterScope::PerfCounterScope(
+    const char* pCategory, const char* pName, PerfCounterStats* pStats)
+    : mpCategory(pCategory), mpName(pName), mpStats(pStats) {
+  V1_ASSERT(!pCategory == !pName);
+  if(mpCategory) begin_scope(mpCategory, mpName);
+  mValid = readPerfCounters(&mStart);
+}
+
+PerfCounterScope::~PerfCounterScope() {
+  PerfCounterValues end;
+  if(mValid && readPerfCounters(&end)) {
+    const auto delta = end - mStart;
+    if(mpStats) mpStats->feed(delta);
+    if(mpCategory) {
+      end_scope(mpCategory, mpName, toTraceArg("cycles", delta.cycles),
+          toTraceArg("instructions", delta.instructions), toTraceArg("ipc", delta.ipc()));
+      track_variable(mpCategory, mpName, toTraceArg("cacheMisses", delta.cacheMisses),
+          toTraceArg("branchMisses", delta.branchMisses));
+    }
+  } else if(mpCategory)
+    end_scope(mpCategory, mpName, toTraceArg("cycles", "n/a"), toTraceArg("instructions", "n/a"),
+        toTraceArg("ipc", "n/a"));
+}
+
+}  // namespace detail
+}  // namespace v1util::tracing
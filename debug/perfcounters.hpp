@@ -0,0 +1,99 @@
+#pragma once
+
+#include "v1util/base/cpppainrelief.hpp"
+#include "v1util/base/macromagic.hpp"
+#include "v1util/base/platform.hpp"
+#include "v1util/stats/aggregator.hpp"
+
+#include <cstdint>
+
+/*
+ * Hardware performance counters for a code region, read per thread.
+ *
+ * On Linux, the counters are read via perf_event_open(2). The calling thread's counter group is
+ * opened lazily on first use and closed when the thread exits. Counting is restricted to user
+ * space, so that it works with the default perf_event_paranoid setting of 2.
+ *
+ * On other platforms or if the kernel refuses to hand out the counters (e.g. in VMs without a
+ * virtual PMU or in containers with a seccomp filter), all scopes are no-ops.
+ */
+
+namespace v1util::tracing {
+
+struct PerfCounterValues {
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  uint64_t cacheMisses = 0;
+  uint64_t branchMisses = 0;
+
+  //! Instructions per cycle
+  double ipc() const { return cycles ? double(instructions) / double(cycles) : 0.; }
+
+  friend inline PerfCounterValues operator-(
+      const PerfCounterValues& l, const PerfCounterValues& r) {
+    return {l.cycles - r.cycles, l.instructions - r.instructions, l.cacheMisses - r.cacheMisses,
+        l.branchMisses - r.branchMisses};
+  }
+};
+
+//! @return true if the calling thread's hardware performance counters can be read.
+V1_PUBLIC bool perfCountersAvailable();
+
+//! Read the calling thread's counters, counting since the thread's first call. false on failure.
+V1_PUBLIC bool readPerfCounters(PerfCounterValues* pValues);
+
+
+//! Aggregated counter values of many invocations of a code region
+struct PerfCounterStats {
+  stats::MinAvgMaxAggregator cycles;
+  stats::MinAvgMaxAggregator instructions;
+  stats::MinAvgMaxAggregator cacheMisses;
+  stats::MinAvgMaxAggregator branchMisses;
+  stats::MinAvgMaxAggregator ipc;
+
+  void feed(const PerfCounterValues& values) {
+    cycles.feed(double(values.cycles));
+    instructions.feed(double(values.instructions));
+    cacheMisses.feed(double(values.cacheMisses));
+    branchMisses.feed(double(values.branchMisses));
+    ipc.feed(values.ipc());
+  }
+};
+
+
+/**
+ * Create a trace scope that is annotated with the hardware counters it consumed.
+ *
+ * The end event carries cycles, instructions and IPC, a counter event of the same name tracks
+ * cache and branch misses.
+ */
+#define V1_PERF_COUNTER_SCOPE(category, name)                                                    \
+  const auto V1_PP_UNQIUE_NAME(v1PerfCounterScope) = v1util::tracing::detail::PerfCounterScope { \
+    V1_PP_STR(category), V1_PP_STR(name), nullptr                                                \
+  }
+//! Like V1_PERF_COUNTER_SCOPE, but additionally feeds the counters into PerfCounterStats @p stats.
+#define V1_PERF_COUNTER_SCOPE_STATS(category, name, stats)                                       \
+  const auto V1_PP_UNQIUE_NAME(v1PerfCounterScope) = v1util::tracing::detail::PerfCounterScope { \
+    V1_PP_STR(category), V1_PP_STR(name), &(stats)                                               \
+  }
+
+
+namespace detail {
+
+class V1_PUBLIC PerfCounterScope {
+ public:
+  //! pCategory/pName may be nullptr to only feed @p pStats, which may be nullptr in turn.
+  PerfCounterScope(const char* pCategory, const char* pName, PerfCounterStats* pStats);
+  ~PerfCounterScope();
+  V1_NO_CP_NO_MV(PerfCounterScope);
+
+ private:
+  const char* mpCategory;
+  const char* mpName;
+  PerfCounterStats* mpStats;
+  PerfCounterValues mStart;
+  bool mValid;
+};
+
+}  // namespace detail
+}  // namespace v1util::tracing
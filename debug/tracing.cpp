@@ -96,7 +96,7 @@ namespace detail {
 SPDR_Event_Arg toSpdrArg(const TraceArg& Arg) {
   switch(Arg.Type) {
   case TraceArg::kStaticString: return uu_spdr_arg_make_str(Arg.pKey, Arg.pDynamicString);
-  case TraceArg::kInt64: return uu_spdr_arg_make_int(Arg.pKey, int(Arg.intNumber));
+  case TraceArg::kInt64: return uu_spdr_arg_make_int(Arg.pKey, Arg.intNumber);
   case TraceArg::kDouble: return uu_spdr_arg_make_double(Arg.pKey, Arg.fpNumber);
   }
   SPDR_Event_Arg invalidArg = {};
@@ -130,6 +130,17 @@ TracingScope::~TracingScope() {
 }
 
 
+void begin_scope(const char* pCategory, const char* pName) {
+  UU_SPDR_TRACE(gSpdrContext, pCategory, pName, SPDR_BEGIN);
+}
+
+void end_scope(const char* pCategory, const char* pName, const TraceArg& arg0,
+    const TraceArg& arg1, const TraceArg& arg2) {
+  UU_SPDR_TRACE3(
+      gSpdrContext, pCategory, pName, SPDR_END, toSpdrArg(arg0), toSpdrArg(arg1), toSpdrArg(arg2));
+}
+
+
 void track_variable(const char* pCategory, const char* pName, const TraceArg& arg0) {
   UU_SPDR_TRACE1(gSpdrContext, pCategory, pName, SPDR_COUNTER, toSpdrArg(arg0));
 }
@@ -165,6 +165,11 @@ class V1_PUBLIC TracingScope {
   const char* mpName;
 };
 
+//! Emit the begin/end events of a scope that can't be represented by TracingScope
+V1_PUBLIC void begin_scope(const char* pCategory, const char* pName);
+V1_PUBLIC void end_scope(const char* pCategory, const char* pName, const TraceArg& arg0,
+    const TraceArg& arg1, const TraceArg& arg2);
+
 V1_PUBLIC void track_variable(const char* pCategory, const char* pName, const TraceArg& arg0);
 V1_PUBLIC void track_variable(
     const char* pCategory, const char* pName, const TraceArg& arg0, const TraceArg& arg1);
@@ -0,0 +1,28 @@
+#include "perfcounters.hpp"
+
+#include "doctest/doctest.h"
+
+namespace v1util::tracing::test {
+
+TEST_CASE("PerfCounterScope-stats") {
+  PerfCounterStats stats;
+  volatile uint64_t sum = 0;
+  for(int run = 0; run < 3; ++run) {
+    V1_PERF_COUNTER_SCOPE_STATS(test, loop, stats);
+    for(uint64_t i = 0; i < 10000; ++i) sum = sum + i;
+  }
+
+  if(!perfCountersAvailable()) {
+    WARN_MESSAGE(false, "hardware performance counters are not available");
+    CHECK(!stats.cycles.hasStats());
+    return;
+  }
+
+  REQUIRE(stats.instructions.hasStats());
+  CHECK(stats.instructions.stats().count == 3);
+  CHECK(stats.instructions.stats().min >= 10000.);
+  CHECK(stats.cycles.stats().min > 0.);
+  CHECK(stats.ipc.stats().max > 0.);
+}
+
+}  // namespace v1util::tracing::test
@@ -1,16 +1,23 @@
 #pragma once
 
+#include "sampleFormat.hpp"
+
 #include "v1util/base/cpppainrelief.hpp"
 #include "v1util/base/debug.hpp"
 #include "v1util/container/array_view.hpp"
 #include "v1util/container/span.hpp"
 
+#include <type_traits>
+
 namespace v1util { namespace dsp {
 
 //! Uninterleaved, non-owning block of data
 template <typename PChannel>
 class AudioBlockBase {
  public:
+  using Sample = std::remove_cv_t<std::remove_pointer_t<PChannel>>;
+  static_assert(kIsSampleType<Sample>);
+
   AudioBlockBase() = default;
   AudioBlockBase(PChannel* ppBuffer, int numChannels_, size_t numSamples_)
       : ppBuffer(ppBuffer), numChannels(numChannels_), numSamples(numSamples_) {
@@ -20,7 +27,7 @@ class AudioBlockBase {
 
   V1_DEFAULT_CP_MV(AudioBlockBase)
 
-  ArrayView<float> channel(int channel) const {
+  ArrayView<Sample> channel(int channel) const {
     V1_ASSERT(channel < numChannels);
     return {ppBuffer[channel], numSamples};
   }
@@ -31,59 +38,69 @@ class AudioBlockBase {
 };
 
 //! Non-owning reference to an immutable block of audio (multiple channels), non-interleaved
-class ConstAudioBlock : public AudioBlockBase<float const* const> {
+template <typename Sample>
+class BasicConstAudioBlock : public AudioBlockBase<Sample const* const> {
  public:
-  ConstAudioBlock() = default;
-  ConstAudioBlock(const float* const* ppBuffer, int numChannels, size_t numSamples)
-      : AudioBlockBase(ppBuffer, numChannels, numSamples) {}
+  BasicConstAudioBlock() = default;
+  BasicConstAudioBlock(const Sample* const* ppBuffer, int numChannels, size_t numSamples)
+      : AudioBlockBase<Sample const* const>(ppBuffer, numChannels, numSamples) {}
 
-  V1_DEFAULT_CP_MV(ConstAudioBlock)
+  V1_DEFAULT_CP_MV(BasicConstAudioBlock)
 };
 
-//! Non-owning reference to a block of audio (multiple channels), non-interleaved
-class AudioBlock : public AudioBlockBase<float*> {
+/** Non-owning reference to a block of audio (multiple channels), non-interleaved
+ *
+ * Gains on PCM samples round and saturate, see convertSample().
+ */
+template <typename Sample>
+class BasicAudioBlock : public AudioBlockBase<Sample*> {
  public:
-  AudioBlock() = default;
-  AudioBlock(float** ppBuffer, int numChannels, size_t numSamples)
-      : AudioBlockBase(ppBuffer, numChannels, numSamples) {}
+  BasicAudioBlock() = default;
+  BasicAudioBlock(Sample** ppBuffer, int numChannels, size_t numSamples)
+      : AudioBlockBase<Sample*>(ppBuffer, numChannels, numSamples) {}
 
-  V1_DEFAULT_CP_MV(AudioBlock)
+  V1_DEFAULT_CP_MV(BasicAudioBlock)
 
   // @{ getters
-  operator ConstAudioBlock() { return {ppBuffer, numChannels, numSamples}; }
+  operator BasicConstAudioBlock<Sample>() const {
+    return {this->ppBuffer, this->numChannels, this->numSamples};
+  }
 
-  Span<float> channel(int channel) {
-    V1_ASSERT(channel < numChannels);
-    return {ppBuffer[channel], numSamples};
+  Span<Sample> channel(int channel) {
+    V1_ASSERT(channel < this->numChannels);
+    return {this->ppBuffer[channel], this->numSamples};
   }
   // @}
 
   // @{ setters
-  void clear() {
-    for(int i = 0; i < numChannels; ++i) {
-      auto pSamples = ppBuffer[i];
-      for(size_t j = 0; j < numSamples; ++j) pSamples[j] = 0.;
-    }
-  }
+  void clear() { fill(Sample(0)); }
 
-  void fill(int chan, float value) {
-    auto pSamples = ppBuffer[chan];
-    for(size_t j = 0; j < numSamples; ++j) pSamples[j] = value;
+  void fill(int chan, Sample value) {
+    auto pSamples = this->ppBuffer[chan];
+    for(size_t j = 0; j < this->numSamples; ++j) pSamples[j] = value;
   }
 
-  void fill(float value) {
-    for(int chan = 0; chan < numChannels; ++chan) fill(chan, value);
+  void fill(Sample value) {
+    for(int chan = 0; chan < this->numChannels; ++chan) fill(chan, value);
   }
 
   void applyGain(int chan, float gain) {
-    auto pSamples = ppBuffer[chan];
-    for(size_t j = 0; j < numSamples; ++j) pSamples[j] *= gain;
+    auto pSamples = this->ppBuffer[chan];
+    if constexpr(std::is_floating_point_v<Sample>) {
+      for(size_t j = 0; j < this->numSamples; ++j) pSamples[j] *= gain;
+    } else {
+      for(size_t j = 0; j < this->numSamples; ++j)
+        pSamples[j] = convertSample<Sample>(convertSample<double>(pSamples[j]) * gain);
+    }
   }
 
   void applyGain(float gain) {
-    for(int chan = 0; chan < numChannels; ++chan) applyGain(chan, gain);
+    for(int chan = 0; chan < this->numChannels; ++chan) applyGain(chan, gain);
   }
   // @}
 };
 
+using ConstAudioBlock = BasicConstAudioBlock<float>;
+using AudioBlock = BasicAudioBlock<float>;
+
 }}  // namespace v1util::dsp
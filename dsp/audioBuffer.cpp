@@ -0,0 +1,41 @@
+#include "audioBuffer.hpp"
+
+#include <algorithm>
+
+
+namespace v1util::dsp {
+
+AudioBufferPool::~AudioBufferPool() {
+  for(const auto& storage : mFree) detail::freeAudioStorage(storage.pData);
+}
+
+size_t AudioBufferPool::numFree() const {
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mFree.size();
+}
+
+AudioBufferPool::Storage AudioBufferPool::acquire(size_t numBytes) {
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto iBest = mFree.end();
+    for(auto iFree = mFree.begin(); iFree != mFree.end(); ++iFree) {
+      if(iFree->numBytes >= numBytes && (iBest == mFree.end() || iFree->numBytes < iBest->numBytes))
+        iBest = iFree;
+    }
+    if(iBest != mFree.end()) {
+      const auto storage = *iBest;
+      *iBest = mFree.back();
+      mFree.pop_back();
+      return storage;
+    }
+  }
+
+  return {detail::allocateAudioStorage(numBytes), numBytes};
+}
+
+void AudioBufferPool::release(Storage storage) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  mFree.push_back(storage);
+}
+
+}  // namespace v1util::dsp
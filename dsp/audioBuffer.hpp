@@ -3,57 +3,109 @@
 #include "audioBlock.hpp"
 #include "v1util/base/cpppainrelief.hpp"
 #include "v1util/base/debug.hpp"
+#include "v1util/base/platform.hpp"
 
 #include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
 
 
 namespace v1util { namespace dsp {
-//! An owning, non-interleaved chunk of audio data
-class AudioBuffer {
+//! Channels of AudioBuffer start at multiples of this, in bytes
+constexpr const size_t kAudioBufferAlignment = 64;
+
+namespace detail {
+inline void* allocateAudioStorage(size_t numBytes) {
+  return ::operator new(numBytes, std::align_val_t(kAudioBufferAlignment));
+}
+inline void freeAudioStorage(void* pData) {
+  ::operator delete(pData, std::align_val_t(kAudioBufferAlignment));
+}
+}  // namespace detail
+
+template <typename Sample>
+class BasicAudioBuffer;
+
+/** Recycles the storage of AudioBuffers, so that resizing them doesn't hit the heap
+ *
+ * Released storage is kept until the pool dies, and handed out again best-fit. Buffers using a
+ * pool must not outlive it. Thread-safe.
+ */
+class AudioBufferPool {
  public:
-  AudioBuffer() = default;
-  AudioBuffer(int numChannels, size_t numSamples) { resize(numChannels, numSamples); }
-  ~AudioBuffer() { destroy(); }
-
-  AudioBuffer(const AudioBuffer& src) { copyFrom(src); }
-  AudioBuffer(AudioBuffer&& src) noexcept
-      : mppChannels(src.mppChannels)
-      , mpBuffer(src.mpBuffer)
-      , mNumChannels(src.mNumChannels)
-      , mNumSamples(src.mNumSamples) {
-    src.mNumSamples = 0;
-#ifdef V1_DEBUG
-    src.mppChannels = nullptr;
-    src.mpBuffer = nullptr;
-    src.mNumChannels = 0;
-#endif
+  AudioBufferPool() = default;
+  V1_PUBLIC ~AudioBufferPool();
+  V1_NO_CP_NO_MV(AudioBufferPool);
+
+  //! Pre-allocate storage for @p count buffers of the given size, e.g. before real-time use
+  template <typename Sample = float>
+  void reserve(int numChannels, size_t numSamples, size_t count);
+
+  //! The number of storage blocks that are ready for use
+  V1_PUBLIC size_t numFree() const;
+
+ private:
+  template <typename Sample>
+  friend class BasicAudioBuffer;
+
+  struct Storage {
+    void* pData = nullptr;
+    size_t numBytes = 0U;
+  };
+
+  //! At least @p numBytes, from the pool or the heap
+  V1_PUBLIC Storage acquire(size_t numBytes);
+  V1_PUBLIC void release(Storage storage);
+
+  mutable std::mutex mMutex;
+  std::vector<Storage> mFree;
+};
+
+
+/** An owning, non-interleaved chunk of audio data, of int16_t, int32_t, float or double samples
+ *
+ * Every channel starts at a multiple of kAudioBufferAlignment and is padded to a multiple of it,
+ * so channels may be processed with aligned vector loads, and by different threads without false
+ * sharing. The storage is only reallocated if a resize needs more of it than there is.
+ */
+template <typename Sample>
+class BasicAudioBuffer {
+  static_assert(kIsSampleType<Sample>);
+
+ public:
+  BasicAudioBuffer() = default;
+  explicit BasicAudioBuffer(AudioBufferPool* pPool) : mpPool(pPool) {}
+  BasicAudioBuffer(int numChannels, size_t numSamples, AudioBufferPool* pPool = nullptr)
+      : mpPool(pPool) {
+    resize(numChannels, numSamples);
   }
-  AudioBuffer& operator=(const AudioBuffer& src) {
+  ~BasicAudioBuffer() { destroy(); }
+
+  //! Copies use the pool of @p src
+  BasicAudioBuffer(const BasicAudioBuffer& src) : mpPool(src.mpPool) { copyFrom(src); }
+  BasicAudioBuffer(BasicAudioBuffer&& src) noexcept { takeFrom(src); }
+  BasicAudioBuffer& operator=(const BasicAudioBuffer& src) {
     copyFrom(src);
     return *this;
   }
-  AudioBuffer& operator=(AudioBuffer&& src) noexcept {
-    destroy();
-
-    mppChannels = src.mppChannels;
-    mpBuffer = src.mpBuffer;
-    mNumChannels = src.mNumChannels;
-    mNumSamples = src.mNumSamples;
-    src.mNumSamples = 0;
-#ifdef V1_DEBUG
-    src.mppChannels = nullptr;
-    src.mpBuffer = nullptr;
-    src.mNumChannels = 0;
-#endif
-
+  BasicAudioBuffer& operator=(BasicAudioBuffer&& src) noexcept {
+    if(this != &src) {
+      destroy();
+      takeFrom(src);
+    }
     return *this;
   }
 
 
   // @{ getters
-  auto constAudioBlock() const { return ConstAudioBlock{mppChannels, mNumChannels, mNumSamples}; }
-  ConstAudioBlock audioBlock() const { return {mppChannels, mNumChannels, mNumSamples}; }
-  AudioBlock audioBlock() { return {mppChannels, mNumChannels, mNumSamples}; }
+  auto constAudioBlock() const {
+    return BasicConstAudioBlock<Sample>{mppChannels, mNumChannels, mNumSamples};
+  }
+  BasicConstAudioBlock<Sample> audioBlock() const {
+    return {mppChannels, mNumChannels, mNumSamples};
+  }
+  BasicAudioBlock<Sample> audioBlock() { return {mppChannels, mNumChannels, mNumSamples}; }
 
   auto constChannel(int chan) const { return constAudioBlock().channel(chan); }
   auto channel(int chan) const { return audioBlock().channel(chan); }
@@ -62,31 +114,52 @@ class AudioBuffer {
   size_t numSamples() const { return mNumSamples; }
   int numChannels() const { return mNumChannels; }
 
+  //! The distance between the starts of two channels, in samples
+  size_t channelStride() const { return mChannelStride; }
+  //! Bytes of storage, including the channel pointers and padding
+  size_t capacity() const { return mStorage.numBytes; }
+  AudioBufferPool* pool() const { return mpPool; }
+
   // @{ setters
+  //! Zeroes all samples; reallocates only if the current storage is too small
   void resize(int numChannels, size_t numSamples) {
-    destroy();
+    V1_ASSERT(numChannels >= 0);
+    constexpr const size_t kSamplesPerLine = kAudioBufferAlignment / sizeof(Sample);
+    const auto stride = (numSamples + kSamplesPerLine - 1) / kSamplesPerLine * kSamplesPerLine;
+    const auto pointersBytes = alignedSize(size_t(numChannels) * sizeof(Sample*));
+    const auto numBytes = pointersBytes + size_t(numChannels) * stride * sizeof(Sample);
+
+    if(numBytes > mStorage.numBytes) {
+      releaseStorage();
+      if(mpPool)
+        mStorage = mpPool->acquire(numBytes);
+      else
+        mStorage = {detail::allocateAudioStorage(numBytes), numBytes};
+    }
 
-    mppChannels = new float*[numChannels]();
-    mpBuffer = new float[size_t(numChannels) * numSamples]();
     mNumChannels = numChannels;
     mNumSamples = numSamples;
-
-    for(int i = 0; i < numChannels; ++i) mppChannels[i] = mpBuffer + (i * numSamples);
+    mChannelStride = stride;
+    if(!numBytes) {
+      mppChannels = nullptr;
+      mpBuffer = nullptr;
+      return;
+    }
+
+    mppChannels = static_cast<Sample**>(mStorage.pData);
+    mpBuffer = reinterpret_cast<Sample*>(static_cast<char*>(mStorage.pData) + pointersBytes);
+    for(int i = 0; i < numChannels; ++i) mppChannels[i] = mpBuffer + size_t(i) * stride;
+    std::memset(mpBuffer, 0, size_t(numChannels) * stride * sizeof(Sample));
   }
 
+  //! Releases the storage, to the pool if there is one
   void destroy() {
-    if(mNumSamples == 0) return;
-    V1_ASSERT(mppChannels);
-
-    delete mppChannels;
-    delete mpBuffer;
-
-    mNumSamples = 0;
-#ifdef V1_DEBUG
-    mNumChannels = 0;
-    mpBuffer = nullptr;
+    releaseStorage();
     mppChannels = nullptr;
-#endif
+    mpBuffer = nullptr;
+    mNumChannels = 0;
+    mNumSamples = 0;
+    mChannelStride = 0;
   }
 
   void clear() { audioBlock().clear(); }
@@ -94,19 +167,62 @@ class AudioBuffer {
   // @}
 
  private:
-  void copyFrom(const AudioBuffer& other) {
-    if(mNumSamples && other.mNumSamples && mpBuffer == other.mpBuffer) return;
+  static constexpr size_t alignedSize(size_t numBytes) {
+    return (numBytes + kAudioBufferAlignment - 1) / kAudioBufferAlignment * kAudioBufferAlignment;
+  }
+
+  void releaseStorage() {
+    if(!mStorage.pData) return;
+    if(mpPool)
+      mpPool->release(mStorage);
+    else
+      detail::freeAudioStorage(mStorage.pData);
+    mStorage = {};
+  }
+
+  void copyFrom(const BasicAudioBuffer& other) {
+    if(this == &other) return;
 
     resize(other.mNumChannels, other.mNumSamples);
-    std::memcpy(mpBuffer, other.mpBuffer, sizeof(float) * size_t(mNumChannels * mNumSamples));
-    for(int i = 0; i < mNumChannels; ++i) mppChannels[i] = mpBuffer + (i * mNumSamples);
+    if(mpBuffer)
+      std::memcpy(
+          mpBuffer, other.mpBuffer, sizeof(Sample) * size_t(mNumChannels) * mChannelStride);
   }
 
+  void takeFrom(BasicAudioBuffer& src) {
+    mStorage = src.mStorage;
+    mpPool = src.mpPool;
+    mppChannels = src.mppChannels;
+    mpBuffer = src.mpBuffer;
+    mNumChannels = src.mNumChannels;
+    mNumSamples = src.mNumSamples;
+    mChannelStride = src.mChannelStride;
 
-  float** mppChannels = nullptr;
-  float* mpBuffer = nullptr;
+    src.mStorage = {};
+    src.destroy();
+  }
+
+  AudioBufferPool::Storage mStorage;  // the channel pointers, then the channels
+  AudioBufferPool* mpPool = nullptr;
+  Sample** mppChannels = nullptr;
+  Sample* mpBuffer = nullptr;
   int mNumChannels = 0;
   size_t mNumSamples = 0;
+  size_t mChannelStride = 0;
 };
 
+using AudioBuffer = BasicAudioBuffer<float>;
+
+
+template <typename Sample>
+void AudioBufferPool::reserve(int numChannels, size_t numSamples, size_t count) {
+  // temporary buffers compute the size, so the pool doesn't need to know the layout
+  std::vector<BasicAudioBuffer<Sample>> buffers;
+  buffers.reserve(count);
+  for(size_t i = 0; i < count; ++i) {
+    buffers.emplace_back(this);
+    buffers.back().resize(numChannels, numSamples);
+  }
+}
+
 }}  // namespace v1util::dsp
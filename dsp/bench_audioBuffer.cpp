@@ -0,0 +1,44 @@
+#include "audioBuffer.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <vector>
+
+namespace v1util::dsp::bench {
+
+namespace {
+constexpr const int kScratchChannels = 8;
+constexpr const size_t kNumScratchBlocks = 64;
+
+const std::vector<size_t> sScratchBlockSizes = {64, 480, 4096};
+}  // namespace
+
+//! A scratch buffer per block, as block processing code tends to do
+void audioBufferScratchPerBlock(const size_t& blockSize) {
+  for(size_t i = 0; i < kNumScratchBlocks; ++i) {
+    AudioBuffer scratch(kScratchChannels, blockSize);
+    sltbench::DoNotOptimize(scratch.channel(0)[0]);
+  }
+}
+SLTBENCH_FUNCTION_WITH_ARGS(audioBufferScratchPerBlock, sScratchBlockSizes);
+
+void audioBufferPooledScratchPerBlock(const size_t& blockSize) {
+  static AudioBufferPool sPool;
+  for(size_t i = 0; i < kNumScratchBlocks; ++i) {
+    AudioBuffer scratch(kScratchChannels, blockSize, &sPool);
+    sltbench::DoNotOptimize(scratch.channel(0)[0]);
+  }
+}
+SLTBENCH_FUNCTION_WITH_ARGS(audioBufferPooledScratchPerBlock, sScratchBlockSizes);
+
+//! Varying block sizes within the capacity of one buffer
+void audioBufferResize(const size_t& blockSize) {
+  static AudioBuffer sBuffer;
+  for(size_t i = 0; i < kNumScratchBlocks; ++i) {
+    sBuffer.resize(kScratchChannels, blockSize - i % 16);
+    sltbench::DoNotOptimize(sBuffer.channel(0)[0]);
+  }
+}
+SLTBENCH_FUNCTION_WITH_ARGS(audioBufferResize, sScratchBlockSizes);
+
+}  // namespace v1util::dsp::bench
@@ -0,0 +1,78 @@
+#include "biquad.hpp"
+
+#include "audioBuffer.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <cmath>
+#include <vector>
+
+namespace v1util::dsp::bench {
+
+namespace {
+//! 100 ms at 48 kHz
+constexpr const size_t kBiquadSamples = 4800;
+constexpr const int kBiquadChannels = 64;
+
+AudioBuffer& biquadInput() {
+  static AudioBuffer sInput = [] {
+    AudioBuffer input(kBiquadChannels, kBiquadSamples);
+    for(int chan = 0; chan < kBiquadChannels; ++chan)
+      for(size_t i = 0; i < kBiquadSamples; ++i)
+        input.channel(chan)[i] = float(std::sin(0.01 * double(i * size_t(chan + 1))));
+    return input;
+  }();
+  return sInput;
+}
+
+const std::vector<BiquadCoefficients>& biquadStages() {
+  static const std::vector<BiquadCoefficients> sStages = {
+      BiquadCoefficients::highPass(48000., 100.), BiquadCoefficients::lowPass(48000., 8000.)};
+  return sStages;
+}
+}  // namespace
+
+//! One channel after the other, one sample after the other
+void biquadScalar() {
+  static AudioBuffer sBuffer(kBiquadChannels, kBiquadSamples);
+  sBuffer = biquadInput();
+  for(int chan = 0; chan < kBiquadChannels; ++chan) {
+    for(const auto& c : biquadStages()) {
+      auto s1 = 0.f, s2 = 0.f;
+      for(auto& sample : sBuffer.channel(chan)) {
+        const auto x = sample;
+        const auto y = c.b0 * x + s1;
+        s1 = c.b1 * x - c.a1 * y + s2;
+        s2 = c.b2 * x - c.a2 * y;
+        sample = y;
+      }
+    }
+  }
+  sltbench::DoNotOptimize(sBuffer.constChannel(0)[kBiquadSamples - 1]);
+}
+SLTBENCH_FUNCTION(biquadScalar);
+
+//! 64 channels, 2 stages, in blocks of 480 samples
+void biquadCascade() {
+  static AudioBuffer sBuffer(kBiquadChannels, kBiquadSamples);
+  static BiquadCascade sCascade = [] {
+    BiquadCascade cascade(kBiquadChannels, biquadStages().size());
+    for(size_t i = 0; i < biquadStages().size(); ++i)
+      cascade.setCoefficients(i, biquadStages()[i]);
+    return cascade;
+  }();
+  sBuffer = biquadInput();
+  sCascade.reset();
+
+  constexpr const size_t kBlockSize = 480;
+  float* ppBlock[kBiquadChannels];
+  for(size_t pos = 0; pos < kBiquadSamples; pos += kBlockSize) {
+    for(int chan = 0; chan < kBiquadChannels; ++chan)
+      ppBlock[chan] = sBuffer.channel(chan).data() + pos;
+    sCascade.process({ppBlock, kBiquadChannels, kBlockSize});
+  }
+  sltbench::DoNotOptimize(sBuffer.constChannel(0)[kBiquadSamples - 1]);
+}
+SLTBENCH_FUNCTION(biquadCascade);
+
+}  // namespace v1util::dsp::bench
@@ -0,0 +1,198 @@
+#include "audioBuffer.hpp"
+#include "blockOps.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace v1util::dsp::bench {
+
+namespace {
+constexpr const int kOpsChannels = 8;
+
+struct BlockOpsState {
+  AudioBuffer source;
+  AudioBuffer target;
+  std::vector<int16_t> ints16;
+  std::vector<int32_t> ints32;
+};
+
+//! Two buffers of kOpsChannels channels of the given block size, with noise
+class BlockOpsFixture {
+ public:
+  using Type = BlockOpsState;
+
+  Type& SetUp(const size_t& blockSize) {
+    mState.source.resize(kOpsChannels, blockSize);
+    mState.target.resize(kOpsChannels, blockSize);
+    std::mt19937 rng(0x0B5U);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+    for(auto* pBuffer : {&mState.source, &mState.target})
+      for(int chan = 0; chan < kOpsChannels; ++chan)
+        for(auto& sample : pBuffer->channel(chan)) sample = distribution(rng);
+    mState.ints16.assign(blockSize, 0);
+    mState.ints32.assign(blockSize, 0);
+    return mState;
+  }
+  void TearDown() {}
+
+ private:
+  Type mState;
+};
+
+const std::vector<size_t> sOpsBlockSizes = {64, 512, 4096};
+
+
+constexpr const size_t kTransposeSamples = 1024;
+
+struct TransposeState {
+  AudioBuffer deinterleaved;
+  std::vector<float> interleaved;
+};
+
+//! Buffers for kTransposeSamples samples of the given number of channels
+class TransposeFixture {
+ public:
+  using Type = TransposeState;
+
+  Type& SetUp(const int& numChannels) {
+    mState.deinterleaved.resize(numChannels, kTransposeSamples);
+    mState.interleaved.assign(size_t(numChannels) * kTransposeSamples, 0.5f);
+    return mState;
+  }
+  void TearDown() {}
+
+ private:
+  Type mState;
+};
+
+const std::vector<int> sTransposeChannels = {2, 6, 16};
+}  // namespace
+
+void blockOpsFill(BlockOpsState& state, const size_t&) {
+  ops::fill(state.target.audioBlock(), 0.25f);
+  sltbench::DoNotOptimize(state.target.channel(0)[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsFill, BlockOpsFixture, sOpsBlockSizes);
+
+void blockOpsCopy(BlockOpsState& state, const size_t&) {
+  ops::copy(state.source.constAudioBlock(), state.target.audioBlock());
+  sltbench::DoNotOptimize(state.target.channel(0)[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsCopy, BlockOpsFixture, sOpsBlockSizes);
+
+void blockOpsApplyGain(BlockOpsState& state, const size_t&) {
+  ops::applyGain(state.target.audioBlock(), 0.999f);
+  sltbench::DoNotOptimize(state.target.channel(0)[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsApplyGain, BlockOpsFixture, sOpsBlockSizes);
+
+void blockOpsApplyGainRamp(BlockOpsState& state, const size_t&) {
+  ops::applyGainRamp(state.target.audioBlock(), 1.f, 0.999f);
+  sltbench::DoNotOptimize(state.target.channel(0)[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsApplyGainRamp, BlockOpsFixture, sOpsBlockSizes);
+
+void blockOpsMix(BlockOpsState& state, const size_t&) {
+  ops::mix(state.source.constAudioBlock(), state.target.audioBlock(), 0.5f);
+  sltbench::DoNotOptimize(state.target.channel(0)[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsMix, BlockOpsFixture, sOpsBlockSizes);
+
+//! A hand-written mixing loop, for comparison with the above
+void blockOpsMixNaiveLoop(BlockOpsState& state, const size_t&) {
+  for(int chan = 0; chan < kOpsChannels; ++chan) {
+    auto source = state.source.constChannel(chan);
+    auto target = state.target.channel(chan);
+    for(size_t i = 0; i < source.size(); ++i) target[i] += 0.5f * source[i];
+  }
+  sltbench::DoNotOptimize(state.target.channel(0)[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsMixNaiveLoop, BlockOpsFixture, sOpsBlockSizes);
+
+void blockOpsMixWithRamp(BlockOpsState& state, const size_t&) {
+  ops::mixWithRamp(state.source.constAudioBlock(), state.target.audioBlock(), 0.5f, 0.25f);
+  sltbench::DoNotOptimize(state.target.channel(0)[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsMixWithRamp, BlockOpsFixture, sOpsBlockSizes);
+
+void blockOpsPeak(BlockOpsState& state, const size_t&) {
+  float peaks[kOpsChannels];
+  ops::peak(state.source.constAudioBlock(), make_span(peaks, kOpsChannels));
+  sltbench::DoNotOptimize(peaks[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsPeak, BlockOpsFixture, sOpsBlockSizes);
+
+void blockOpsRms(BlockOpsState& state, const size_t&) {
+  float rms[kOpsChannels];
+  ops::rms(state.source.constAudioBlock(), make_span(rms, kOpsChannels));
+  sltbench::DoNotOptimize(rms[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsRms, BlockOpsFixture, sOpsBlockSizes);
+
+void blockOpsClip(BlockOpsState& state, const size_t&) {
+  ops::clip(state.target.audioBlock(), 0.5f);
+  sltbench::DoNotOptimize(state.target.channel(0)[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsClip, BlockOpsFixture, sOpsBlockSizes);
+
+void blockOpsFlushDenormals(BlockOpsState& state, const size_t&) {
+  ops::flushDenormals(state.target.audioBlock());
+  sltbench::DoNotOptimize(state.target.channel(0)[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsFlushDenormals, BlockOpsFixture, sOpsBlockSizes);
+
+void blockOpsFloatToInt16(BlockOpsState& state, const size_t&) {
+  ops::convert(state.source.constChannel(0), make_span(state.ints16));
+  sltbench::DoNotOptimize(state.ints16[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsFloatToInt16, BlockOpsFixture, sOpsBlockSizes);
+
+void blockOpsInt16ToFloat(BlockOpsState& state, const size_t&) {
+  ops::convert(make_array_view(state.ints16), state.target.channel(0));
+  sltbench::DoNotOptimize(state.target.channel(0)[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsInt16ToFloat, BlockOpsFixture, sOpsBlockSizes);
+
+void blockOpsFloatToInt32(BlockOpsState& state, const size_t&) {
+  ops::convert(state.source.constChannel(0), make_span(state.ints32));
+  sltbench::DoNotOptimize(state.ints32[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsFloatToInt32, BlockOpsFixture, sOpsBlockSizes);
+
+void blockOpsInt32ToFloat(BlockOpsState& state, const size_t&) {
+  ops::convert(make_array_view(state.ints32), state.target.channel(0));
+  sltbench::DoNotOptimize(state.target.channel(0)[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsInt32ToFloat, BlockOpsFixture, sOpsBlockSizes);
+
+void blockOpsDeinterleave(TransposeState& state, const int& numChannels) {
+  ops::deinterleave(ConstInterleavedAudioBlock(state.interleaved.data(), numChannels,
+                        kTransposeSamples),
+      state.deinterleaved.audioBlock());
+  sltbench::DoNotOptimize(state.deinterleaved.channel(0)[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsDeinterleave, TransposeFixture, sTransposeChannels);
+
+//! Channel by channel over all samples, for comparison with the above
+void blockOpsDeinterleaveNaiveLoop(TransposeState& state, const int& numChannels) {
+  for(int chan = 0; chan < numChannels; ++chan) {
+    auto target = state.deinterleaved.channel(chan);
+    for(size_t i = 0; i < kTransposeSamples; ++i)
+      target[i] = state.interleaved[i * size_t(numChannels) + size_t(chan)];
+  }
+  sltbench::DoNotOptimize(state.deinterleaved.channel(0)[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(
+    blockOpsDeinterleaveNaiveLoop, TransposeFixture, sTransposeChannels);
+
+void blockOpsInterleave(TransposeState& state, const int& numChannels) {
+  ops::interleave(state.deinterleaved.constAudioBlock(),
+      InterleavedAudioBlock(state.interleaved.data(), numChannels, kTransposeSamples));
+  sltbench::DoNotOptimize(state.interleaved[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(blockOpsInterleave, TransposeFixture, sTransposeChannels);
+
+}  // namespace v1util::dsp::bench
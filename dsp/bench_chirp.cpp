@@ -0,0 +1,50 @@
+#include "chirp.hpp"
+
+#include "v1util/base/math.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <cmath>
+#include <vector>
+
+namespace v1util::dsp::bench {
+
+namespace {
+//! One second at 48 kHz
+constexpr const size_t kChirpSamples = 48000;
+
+const std::vector<size_t> sChirpBlockSizes = {64, 1024};
+
+void generateChirp(ChirpSweep sweep, size_t blockSize) {
+  ChirpGen<float> chirp(48000.f, 20.f, 20000.f, 1.f, 0.01f, sweep);
+  std::vector<float> block(blockSize);
+  while(!chirp.done()) chirp.fillBlock(make_span(block));
+  sltbench::DoNotOptimize(block[0]);
+}
+}  // namespace
+
+void chirpLinear(const size_t& blockSize) {
+  generateChirp(ChirpSweep::kLinear, blockSize);
+}
+SLTBENCH_FUNCTION_WITH_ARGS(chirpLinear, sChirpBlockSizes);
+
+void chirpExponential(const size_t& blockSize) {
+  generateChirp(ChirpSweep::kExponential, blockSize);
+}
+SLTBENCH_FUNCTION_WITH_ARGS(chirpExponential, sChirpBlockSizes);
+
+//! std::sin() of the phase for every sample, for comparison with the above
+void chirpNaiveSin() {
+  std::vector<float> samples(kChirpSamples);
+  const auto dT = 1. / 48000.;
+  const auto w1 = 20. * 2. * kPi;
+  const auto w2 = 20000. * 2. * kPi;
+  for(size_t i = 0; i < kChirpSamples; ++i) {
+    const auto t = double(i) * dT;
+    samples[i] = float(std::sin((w1 + (w2 - w1) * t / 2.) * t));
+  }
+  sltbench::DoNotOptimize(samples[0]);
+}
+SLTBENCH_FUNCTION(chirpNaiveSin);
+
+}  // namespace v1util::dsp::bench
@@ -0,0 +1,72 @@
+#include "fft.hpp"
+#include "stft.hpp"
+
+#include "audioBuffer.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <cmath>
+#include <vector>
+
+namespace v1util::dsp::bench {
+
+namespace {
+const std::vector<size_t> sFftSizes = {256, 1024, 4096};
+
+//! One second at 48 kHz
+constexpr const size_t kStftSamples = 48000;
+constexpr const int kStftChannels = 8;
+}  // namespace
+
+void realFftForward(const size_t& size) {
+  static RealFft sFft;
+  if(sFft.size() != size) sFft = RealFft(size);
+
+  std::vector<float> input(size), real(sFft.numBins()), imag(sFft.numBins());
+  for(size_t i = 0; i < size; ++i) input[i] = float(i % 7) - 3.f;
+  sFft.forward(make_array_view(input), make_span(real), make_span(imag));
+  sltbench::DoNotOptimize(real[1]);
+}
+SLTBENCH_FUNCTION_WITH_ARGS(realFftForward, sFftSizes);
+
+void realFftRoundtrip(const size_t& size) {
+  static RealFft sFft;
+  if(sFft.size() != size) sFft = RealFft(size);
+
+  std::vector<float> samples(size), real(sFft.numBins()), imag(sFft.numBins());
+  for(size_t i = 0; i < size; ++i) samples[i] = float(i % 7) - 3.f;
+  sFft.forward(make_array_view(samples), make_span(real), make_span(imag));
+  sFft.inverse(make_array_view(real), make_array_view(imag), make_span(samples));
+  sltbench::DoNotOptimize(samples[1]);
+}
+SLTBENCH_FUNCTION_WITH_ARGS(realFftRoundtrip, sFftSizes);
+
+//! 8 channels, 1025 bins, 75 % overlap, in blocks of 480 samples
+void stftResynthesis() {
+  static AudioBuffer sInput = [] {
+    AudioBuffer input(kStftChannels, kStftSamples);
+    for(int chan = 0; chan < kStftChannels; ++chan)
+      for(size_t i = 0; i < kStftSamples; ++i)
+        input.channel(chan)[i] = float(std::sin(0.01 * double(i * size_t(chan + 1))));
+    return input;
+  }();
+  static AudioBuffer sOutput(kStftChannels, kStftSamples);
+  static Stft sStft(kStftChannels, 2048, 512);
+  sStft.reset();
+
+  constexpr const size_t kBlockSize = 480;
+  const float* ppInput[kStftChannels];
+  float* ppOutput[kStftChannels];
+  for(size_t pos = 0; pos < kStftSamples; pos += kBlockSize) {
+    for(int chan = 0; chan < kStftChannels; ++chan) {
+      ppInput[chan] = sInput.constChannel(chan).data() + pos;
+      ppOutput[chan] = sOutput.channel(chan).data() + pos;
+    }
+    sStft.process({ppInput, kStftChannels, kBlockSize}, {ppOutput, kStftChannels, kBlockSize},
+        [](StftFrame&) {});
+  }
+  sltbench::DoNotOptimize(sOutput.constChannel(0)[kStftSamples - 1]);
+}
+SLTBENCH_FUNCTION(stftResynthesis);
+
+}  // namespace v1util::dsp::bench
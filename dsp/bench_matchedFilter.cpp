@@ -0,0 +1,86 @@
+#include "matchedFilter.hpp"
+
+#include "audioBuffer.hpp"
+#include "chirp.hpp"
+
+#include "v1util/base/thread_pool.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <random>
+
+namespace v1util::dsp::bench {
+
+namespace {
+//! One second at 48 kHz, in blocks of 480 samples, against a chirp of 20 ms
+constexpr const size_t kMatchedSamples = 48000;
+constexpr const size_t kMatchedBlockSize = 480;
+constexpr const int kMatchedChannels = 64;
+
+const AudioBuffer& matchedTemplate() {
+  static AudioBuffer sTemplate = [] {
+    ChirpGen<float> chirp(48000.f, 500.f, 12000.f, 0.02f, 0.002f);
+    AudioBuffer templateSignal(1, chirp.lengthSmpl());
+    chirp.fillBlock(templateSignal.channel(0));
+    return templateSignal;
+  }();
+  return sTemplate;
+}
+
+const AudioBuffer& matchedInput() {
+  static AudioBuffer sInput = [] {
+    AudioBuffer input(kMatchedChannels, kMatchedSamples);
+    std::mt19937 rng(5U);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+    for(int chan = 0; chan < kMatchedChannels; ++chan)
+      for(auto& sample : input.channel(chan)) sample = distribution(rng);
+    return input;
+  }();
+  return sInput;
+}
+
+void matchedFilterRun(ThreadPool* pPool) {
+  static MatchedFilter sFilter(kMatchedChannels, matchedTemplate().constChannel(0));
+  static AudioBuffer sOutput(kMatchedChannels, kMatchedBlockSize);
+  sFilter.reset();
+
+  const auto& input = matchedInput();
+  const float* ppBlock[kMatchedChannels];
+  for(size_t pos = 0; pos < kMatchedSamples; pos += kMatchedBlockSize) {
+    for(int chan = 0; chan < kMatchedChannels; ++chan)
+      ppBlock[chan] = input.constChannel(chan).data() + pos;
+    sFilter.process({ppBlock, kMatchedChannels, kMatchedBlockSize}, sOutput.audioBlock(), pPool);
+  }
+  sltbench::DoNotOptimize(sOutput.constChannel(0)[0]);
+}
+}  // namespace
+
+//! Only one block of the second, by direct correlation
+void matchedFilterDirectBlock() {
+  static AudioBuffer sOutput(kMatchedChannels, kMatchedBlockSize);
+  const auto taps = matchedTemplate().constChannel(0);
+  const auto& input = matchedInput();
+  for(int chan = 0; chan < kMatchedChannels; ++chan) {
+    const auto pInput = input.constChannel(chan).data();
+    auto output = sOutput.channel(chan);
+    for(size_t i = 0; i < kMatchedBlockSize; ++i) {
+      auto sum = 0.f;
+      for(size_t k = 0; k < taps.size(); ++k) sum += pInput[i + k] * taps[k];
+      output[i] = sum;
+    }
+  }
+  sltbench::DoNotOptimize(sOutput.constChannel(0)[0]);
+}
+SLTBENCH_FUNCTION(matchedFilterDirectBlock);
+
+void matchedFilterSerial() {
+  matchedFilterRun(nullptr);
+}
+SLTBENCH_FUNCTION(matchedFilterSerial);
+
+void matchedFilterThreadPool() {
+  matchedFilterRun(&ThreadPool::global());
+}
+SLTBENCH_FUNCTION(matchedFilterThreadPool);
+
+}  // namespace v1util::dsp::bench
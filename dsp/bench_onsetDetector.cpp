@@ -0,0 +1,86 @@
+#include "onsetDetector.hpp"
+
+#include "audioBuffer.hpp"
+#include "peakfinder.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace v1util::dsp::bench {
+
+namespace {
+//! One second at 48 kHz, in blocks of 4800 samples
+constexpr const size_t kOnsetSamples = 48000;
+constexpr const size_t kOnsetBlockSize = 4800;
+constexpr const int kOnsetChannels = 16;
+constexpr const size_t kOnsetPatternSize = 481;
+
+//! Noise with a decaying burst every 4000 samples
+const AudioBuffer& onsetInput() {
+  static AudioBuffer sInput = [] {
+    AudioBuffer input(kOnsetChannels, kOnsetSamples);
+    std::mt19937 rng(11U);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+    for(int chan = 0; chan < kOnsetChannels; ++chan)
+      for(size_t i = 0; i < kOnsetSamples; ++i) {
+        const auto level = 0.01 + std::exp(-double(i % 4000) / 300.);
+        input.channel(chan)[i] = float(level) * distribution(rng);
+      }
+    return input;
+  }();
+  return sInput;
+}
+}  // namespace
+
+//! Per block: the envelopes of all channels into a buffer, then peak finders with a fixed threshold
+void onsetsUnfused() {
+  static AudioBuffer sEnvelopes(kOnsetChannels, kOnsetBlockSize);
+  static std::vector<StreamingPeakFinder<float>> sPeakFinders(kOnsetChannels);
+  static std::vector<float> sStates;
+  for(auto& peakFinder : sPeakFinders) peakFinder.reconfigure(kOnsetPatternSize);
+  sStates.assign(kOnsetChannels, 0.f);
+  const auto release = float(std::exp(-1. / double(kOnsetPatternSize / 2)));
+
+  size_t numOnsets = 0;
+  const auto& input = onsetInput();
+  for(size_t pos = 0; pos < kOnsetSamples; pos += kOnsetBlockSize) {
+    for(int chan = 0; chan < kOnsetChannels; ++chan) {
+      auto envelope = sStates[size_t(chan)];
+      const auto pInput = input.constChannel(chan).data() + pos;
+      auto envelopes = sEnvelopes.channel(chan);
+      for(size_t i = 0; i < kOnsetBlockSize; ++i) {
+        const auto rectified = std::abs(pInput[i]);
+        envelope = rectified > envelope ? rectified : rectified + release * (envelope - rectified);
+        envelopes[i] = envelope;
+      }
+      sStates[size_t(chan)] = envelope;
+    }
+    for(int chan = 0; chan < kOnsetChannels; ++chan)
+      sPeakFinders[size_t(chan)].process(sEnvelopes.constChannel(chan), pos, 1e-3f,
+          [&](const PeakFinderValueAtPos<float>&) { ++numOnsets; });
+  }
+  sltbench::DoNotOptimize(numOnsets);
+}
+SLTBENCH_FUNCTION(onsetsUnfused);
+
+void onsetDetector() {
+  static OnsetDetector sDetector(kOnsetChannels, kOnsetPatternSize, 4800);
+  sDetector.reset();
+
+  size_t numOnsets = 0;
+  const auto& input = onsetInput();
+  const float* ppBlock[kOnsetChannels];
+  for(size_t pos = 0; pos < kOnsetSamples; pos += kOnsetBlockSize) {
+    for(int chan = 0; chan < kOnsetChannels; ++chan)
+      ppBlock[chan] = input.constChannel(chan).data() + pos;
+    sDetector.process({ppBlock, kOnsetChannels, kOnsetBlockSize},
+        [&](int, const PeakFinderValueAtPos<float>&) { ++numOnsets; });
+  }
+  sltbench::DoNotOptimize(numOnsets);
+}
+SLTBENCH_FUNCTION(onsetDetector);
+
+}  // namespace v1util::dsp::bench
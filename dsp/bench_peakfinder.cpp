@@ -0,0 +1,86 @@
+#include "peakfinder.hpp"
+
+#include "v1util/base/math.hpp"
+#include "v1util/container/array_view.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace v1util::dsp::bench {
+
+namespace {
+constexpr const size_t kNumSamples = 1U << 16;
+constexpr const size_t kPatternSize = 127;
+
+//! Noise with a sharp peak every ~kPatternSize samples, similar to a matched filter output
+std::vector<float> makeTestSignal() {
+  std::vector<float> signal(kNumSamples);
+  std::mt19937 rng(0xC0FFEEU);
+  std::uniform_real_distribution<float> distribution(0.f, 1.f);
+  for(size_t i = 0; i < kNumSamples; ++i) {
+    signal[i] = distribution(rng);
+    if(i % (kPatternSize + 3) == 0) signal[i] += 10.f;
+  }
+  return signal;
+}
+
+const auto sSignal = makeTestSignal();
+
+class PeakFinderFixture {
+ public:
+  using Type = StreamingPeakFinder<float>;
+
+  Type& SetUp(const size_t&) {
+    mPeakFinder.reconfigure(kPatternSize);
+    return mPeakFinder;
+  }
+  void TearDown() {}
+
+ private:
+  Type mPeakFinder;
+};
+
+class SubSamplePeakFinderFixture {
+ public:
+  using Type = SubSamplePeakFinder<float>;
+
+  Type& SetUp(const size_t&) {
+    mPeakFinder = Type(kPatternSize, PeakInterpolation::kGaussian, true);
+    return mPeakFinder;
+  }
+  void TearDown() {}
+
+ private:
+  Type mPeakFinder;
+};
+
+const std::vector<size_t> sBlockSizes = {32, 256, 4096};
+}  // namespace
+
+void streamingPeakFinder(PeakFinderFixture::Type& peakFinder, const size_t& blockSize) {
+  const auto signal = make_array_view(sSignal);
+  size_t numPeaks = 0;
+  for(size_t offset = 0; offset < signal.size(); offset += blockSize) {
+    peakFinder.process(signal.subview(offset, std::min(blockSize, signal.size() - offset)), offset,
+        5.f, [&](const PeakFinderValueAtPos<float>&) { ++numPeaks; });
+  }
+  sltbench::DoNotOptimize(numPeaks);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(streamingPeakFinder, PeakFinderFixture, sBlockSizes);
+
+void subSamplePeakFinder(SubSamplePeakFinderFixture::Type& peakFinder, const size_t& blockSize) {
+  const auto signal = make_array_view(sSignal);
+  double position = 0.;
+  for(size_t offset = 0; offset < signal.size(); offset += blockSize) {
+    peakFinder.process(signal.subview(offset, std::min(blockSize, signal.size() - offset)), offset,
+        5.f, [&](const PeakFinderSubSamplePeak<float>& peak) { position += peak.position; });
+  }
+  sltbench::DoNotOptimize(position);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(
+    subSamplePeakFinder, SubSamplePeakFinderFixture, sBlockSizes);
+
+}  // namespace v1util::dsp::bench
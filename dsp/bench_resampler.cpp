@@ -0,0 +1,54 @@
+#include "resampler.hpp"
+
+#include "audioBuffer.hpp"
+
+#include "v1util/base/thread_pool.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <random>
+
+namespace v1util::dsp::bench {
+
+namespace {
+constexpr const int kResamplerChannels = 8;
+//! 0.1 s at 44.1 kHz
+constexpr const size_t kResamplerInputSamples = 4410;
+
+//! 8 channels of noise-like input from 44.1 to 48 kHz, in blocks of 441 samples
+void resample44To48(ThreadPool* pPool) {
+  static const auto sInput = [] {
+    AudioBuffer input(kResamplerChannels, kResamplerInputSamples);
+    std::mt19937 rng(1U);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+    for(int chan = 0; chan < kResamplerChannels; ++chan)
+      for(auto& sample : input.channel(chan)) sample = distribution(rng);
+    return input;
+  }();
+
+  static Resampler sResampler(44100., 48000., kResamplerChannels);
+  auto& resampler = sResampler;
+  resampler.reset();
+  constexpr const size_t kBlockSize = 441;
+  AudioBuffer output(kResamplerChannels, resampler.maxNumOutputSamples(kBlockSize));
+  const float* ppBlock[kResamplerChannels];
+  for(size_t pos = 0; pos < kResamplerInputSamples; pos += kBlockSize) {
+    for(int chan = 0; chan < kResamplerChannels; ++chan)
+      ppBlock[chan] = sInput.constChannel(chan).data() + pos;
+    resampler.process({ppBlock, kResamplerChannels, kBlockSize}, output.audioBlock(), pPool);
+  }
+  sltbench::DoNotOptimize(output.constChannel(0)[0]);
+}
+}  // namespace
+
+void resampleSerial() {
+  resample44To48(nullptr);
+}
+SLTBENCH_FUNCTION(resampleSerial);
+
+void resampleThreadPool() {
+  resample44To48(&ThreadPool::global());
+}
+SLTBENCH_FUNCTION(resampleThreadPool);
+
+}  // namespace v1util::dsp::bench
@@ -0,0 +1,94 @@
+#include "audioBuffer.hpp"
+#include "peakfinder.hpp"
+#include "slidingWindowStats.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <random>
+#include <vector>
+
+namespace v1util::dsp::bench {
+
+namespace {
+constexpr const int kNumChannels = 16;
+constexpr const size_t kBlockSize = 256;
+constexpr const size_t kNumBlocks = 64;
+
+AudioBuffer makeMeteringSignal() {
+  AudioBuffer buffer(kNumChannels, kBlockSize);
+  std::mt19937 rng(0xFEEDU);
+  std::uniform_real_distribution<float> distribution(-0.5f, 0.5f);
+  for(int chan = 0; chan < kNumChannels; ++chan)
+    for(auto& sample : buffer.channel(chan)) sample = distribution(rng);
+  return buffer;
+}
+
+const auto sMeteringSignal = makeMeteringSignal();
+
+class SlidingWindowStatsFixture {
+ public:
+  using Type = SlidingWindowStats;
+
+  Type& SetUp(const size_t& windowSize) {
+    mStats.reconfigure(kNumChannels, windowSize);
+    return mStats;
+  }
+  void TearDown() {}
+
+ private:
+  Type mStats;
+};
+
+class MaximaFinderFixture {
+ public:
+  using Type = std::vector<SlidingWindowLocalMaximaFinder<float>>;
+
+  Type& SetUp(const size_t& windowSize) {
+    mFinders.clear();
+    mFinders.reserve(kNumChannels);
+    for(int chan = 0; chan < kNumChannels; ++chan) mFinders.emplace_back(windowSize);
+    return mFinders;
+  }
+  void TearDown() {}
+
+ private:
+  Type mFinders;
+};
+
+const std::vector<size_t> sWindowSizes = {64, 480, 4800};
+}  // namespace
+
+//! Only the current values, as for a level meter
+void slidingWindowStatsMetering(SlidingWindowStatsFixture::Type& stats, const size_t&) {
+  for(size_t i = 0; i < kNumBlocks; ++i) stats.process(sMeteringSignal.constAudioBlock());
+  sltbench::DoNotOptimize(stats.current(0));
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(
+    slidingWindowStatsMetering, SlidingWindowStatsFixture, sWindowSizes);
+
+void slidingWindowStatsPerSampleMax(SlidingWindowStatsFixture::Type& stats, const size_t&) {
+  static AudioBuffer sMax(kNumChannels, kBlockSize);
+  SlidingWindowOutputs outputs;
+  outputs.max = sMax.audioBlock();
+  for(size_t i = 0; i < kNumBlocks; ++i)
+    stats.process(sMeteringSignal.constAudioBlock(), outputs);
+  sltbench::DoNotOptimize(sMax.channel(0)[0]);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(
+    slidingWindowStatsPerSampleMax, SlidingWindowStatsFixture, sWindowSizes);
+
+//! The monotonic deque, for comparison with the above
+void slidingWindowMaximaFinderPerSample(MaximaFinderFixture::Type& finders, const size_t&) {
+  float sum = 0.f;
+  for(size_t i = 0; i < kNumBlocks; ++i) {
+    for(int chan = 0; chan < kNumChannels; ++chan) {
+      for(auto sample : sMeteringSignal.constChannel(chan))
+        sum += finders[size_t(chan)].add(sample);
+    }
+  }
+  sltbench::DoNotOptimize(sum);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(
+    slidingWindowMaximaFinderPerSample, MaximaFinderFixture, sWindowSizes);
+
+}  // namespace v1util::dsp::bench
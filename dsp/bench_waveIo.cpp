@@ -0,0 +1,106 @@
+#include "waveIo.hpp"
+
+#include "audioBuffer.hpp"
+
+#include "v1util/base/math.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <vector>
+
+namespace v1util::dsp::io::bench {
+
+namespace {
+constexpr const int kNumChannels = 2;
+constexpr const size_t kNumSamples = 1U << 16;
+
+struct SampleFormat {
+  uint8_t bitsPerSample;
+  bool isFloatingPoint;
+};
+
+std::ostream& operator<<(std::ostream& os, const SampleFormat& format) {
+  return os << (format.isFloatingPoint ? "float" : "PCM") << int(format.bitsPerSample);
+}
+
+const std::vector<SampleFormat> sSampleFormats = {{16, false}, {32, false}, {32, true}};
+
+
+struct WaveBenchState {
+  FILE* pFile = nullptr;
+  WaveInfo format;
+  AudioBuffer buffer;
+  BasicAudioBuffer<int16_t> ints16;
+};
+
+/** Provides a temporary file and buffers of kNumSamples samples, float and int16_t
+ *
+ * The file already contains the buffer in the requested format, so that reading can start
+ * right away.
+ */
+class WaveFixture {
+ public:
+  using Type = WaveBenchState;
+
+  Type& SetUp(const SampleFormat& sampleFormat) {
+    mState.format.numChannels = kNumChannels;
+    mState.format.sampleRate = 48000.;
+    mState.format.bitsPerSample = sampleFormat.bitsPerSample;
+    mState.format.isFloatingPoint = sampleFormat.isFloatingPoint;
+
+    mState.buffer.resize(kNumChannels, kNumSamples);
+    for(int chan = 0; chan < kNumChannels; ++chan) {
+      auto channel = mState.buffer.channel(chan);
+      for(size_t i = 0; i < kNumSamples; ++i)
+        channel[i] = 0.5f * std::sin(kfPi * 2.f * float(i * size_t(chan + 1)) / 100.f);
+    }
+
+    mState.ints16.resize(kNumChannels, kNumSamples);
+
+    mState.pFile = std::tmpfile();
+    auto writer = WaveWriter(mState.pFile, mState.format);
+    writer.write(mState.buffer.constAudioBlock());
+    mState.pFile = writer.release();
+    return mState;
+  }
+
+  void TearDown() {
+    if(mState.pFile) ::fclose(mState.pFile);
+    mState.pFile = nullptr;
+  }
+
+ private:
+  Type mState;
+};
+}  // namespace
+
+void waveWrite(WaveFixture::Type& state, const SampleFormat&) {
+  ::fseek(state.pFile, 0, SEEK_SET);
+  auto writer = WaveWriter(state.pFile, state.format);
+  sltbench::DoNotOptimize(writer.write(state.buffer.constAudioBlock()));
+  state.pFile = writer.release();
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(waveWrite, WaveFixture, sSampleFormats);
+
+void waveRead(WaveFixture::Type& state, const SampleFormat&) {
+  ::fseek(state.pFile, 0, SEEK_SET);
+  auto reader = WaveReader(state.pFile);
+  sltbench::DoNotOptimize(reader.read(state.buffer.audioBlock()));
+  state.pFile = reader.release();
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(waveRead, WaveFixture, sSampleFormats);
+
+//! Without conversion for PCM16
+void waveReadInt16(WaveFixture::Type& state, const SampleFormat&) {
+  ::fseek(state.pFile, 0, SEEK_SET);
+  auto reader = WaveReader(state.pFile);
+  sltbench::DoNotOptimize(reader.read(state.ints16.audioBlock()));
+  state.pFile = reader.release();
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(waveReadInt16, WaveFixture, sSampleFormats);
+
+}  // namespace v1util::dsp::io::bench
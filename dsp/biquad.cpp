@@ -0,0 +1,239 @@
+#include "biquad.hpp"
+
+#include "blockOps.hpp"
+#include "interleavedAudioBlock.hpp"
+
+#include "v1util/base/debug.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+// only gcc knows "#pragma GCC unroll"; others warn about it
+#if defined(__GNUC__) && !defined(__clang__)
+#  define V1_BIQUAD_NO_UNROLL _Pragma("GCC unroll 1")
+#else
+#  define V1_BIQUAD_NO_UNROLL
+#endif
+
+
+namespace v1util::dsp {
+
+namespace {
+constexpr const size_t kLanes = BiquadCascade::kLanes;
+
+//! Normalized by a0
+BiquadCoefficients fromCookbook(
+    double b0, double b1, double b2, double a0, double a1, double a2) {
+  BiquadCoefficients result;
+  result.b0 = float(b0 / a0);
+  result.b1 = float(b1 / a0);
+  result.b2 = float(b2 / a0);
+  result.a1 = float(a1 / a0);
+  result.a2 = float(a2 / a0);
+  return result;
+}
+
+struct CookbookTerms {
+  CookbookTerms(double sampleRate, double freqHz, double q) {
+    const auto w0 = 2. * kPi * freqHz / sampleRate;
+    cosW0 = std::cos(w0);
+    alpha = std::sin(w0) / (2. * q);
+  }
+
+  double cosW0;
+  double alpha;
+};
+
+
+// kernels; free functions, because compilers only trust __restrict on parameters
+
+/** One biquad over a tile of kLanes interleaved channels
+ *
+ * Samples before @p rampLength use pStart + n * pDelta, the others pSteady. pState holds s1, then
+ * s2 of every lane.
+ */
+V1_TARGET_CLONES void biquadKernel(float* __restrict pTile, size_t numSamples,
+    const float* __restrict pStart, const float* __restrict pDelta, size_t rampLength,
+    const float* __restrict pSteady, float* __restrict pState) {
+  float s1[kLanes], s2[kLanes];
+  for(size_t lane = 0; lane < kLanes; ++lane) {
+    s1[lane] = pState[lane];
+    s2[lane] = pState[kLanes + lane];
+  }
+
+  // "unroll 1" keeps gcc from peeling the lanes into scalar code before it vectorizes them
+  for(size_t n = 0; n < rampLength; ++n) {
+    const auto t = float(n);
+    const auto b0 = pStart[0] + t * pDelta[0], b1 = pStart[1] + t * pDelta[1];
+    const auto b2 = pStart[2] + t * pDelta[2], a1 = pStart[3] + t * pDelta[3];
+    const auto a2 = pStart[4] + t * pDelta[4];
+    auto pSamples = pTile + n * kLanes;
+    V1_BIQUAD_NO_UNROLL
+    for(size_t lane = 0; lane < kLanes; ++lane) {
+      const auto x = pSamples[lane];
+      const auto y = b0 * x + s1[lane];
+      s1[lane] = b1 * x - a1 * y + s2[lane];
+      s2[lane] = b2 * x - a2 * y;
+      pSamples[lane] = y;
+    }
+  }
+
+  const auto b0 = pSteady[0], b1 = pSteady[1], b2 = pSteady[2];
+  const auto a1 = pSteady[3], a2 = pSteady[4];
+  for(size_t n = rampLength; n < numSamples; ++n) {
+    auto pSamples = pTile + n * kLanes;
+    V1_BIQUAD_NO_UNROLL
+    for(size_t lane = 0; lane < kLanes; ++lane) {
+      const auto x = pSamples[lane];
+      const auto y = b0 * x + s1[lane];
+      s1[lane] = b1 * x - a1 * y + s2[lane];
+      s2[lane] = b2 * x - a2 * y;
+      pSamples[lane] = y;
+    }
+  }
+
+  for(size_t lane = 0; lane < kLanes; ++lane) {
+    pState[lane] = s1[lane];
+    pState[kLanes + lane] = s2[lane];
+  }
+}
+}  // namespace
+
+
+BiquadCoefficients BiquadCoefficients::lowPass(double sampleRate, double freqHz, double q) {
+  const CookbookTerms terms(sampleRate, freqHz, q);
+  const auto b1 = 1. - terms.cosW0;
+  return fromCookbook(
+      b1 / 2., b1, b1 / 2., 1. + terms.alpha, -2. * terms.cosW0, 1. - terms.alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::highPass(double sampleRate, double freqHz, double q) {
+  const CookbookTerms terms(sampleRate, freqHz, q);
+  const auto b1 = -(1. + terms.cosW0);
+  return fromCookbook(
+      -b1 / 2., b1, -b1 / 2., 1. + terms.alpha, -2. * terms.cosW0, 1. - terms.alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::bandPass(double sampleRate, double freqHz, double q) {
+  const CookbookTerms terms(sampleRate, freqHz, q);
+  return fromCookbook(
+      terms.alpha, 0., -terms.alpha, 1. + terms.alpha, -2. * terms.cosW0, 1. - terms.alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::notch(double sampleRate, double freqHz, double q) {
+  const CookbookTerms terms(sampleRate, freqHz, q);
+  return fromCookbook(
+      1., -2. * terms.cosW0, 1., 1. + terms.alpha, -2. * terms.cosW0, 1. - terms.alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::peaking(
+    double sampleRate, double freqHz, double q, double gainDb) {
+  const CookbookTerms terms(sampleRate, freqHz, q);
+  const auto amplitude = std::pow(10., gainDb / 40.);
+  return fromCookbook(1. + terms.alpha * amplitude, -2. * terms.cosW0,
+      1. - terms.alpha * amplitude, 1. + terms.alpha / amplitude, -2. * terms.cosW0,
+      1. - terms.alpha / amplitude);
+}
+
+BiquadCoefficients BiquadCoefficients::dcBlocker(double sampleRate, double cutoffHz) {
+  const auto pole = std::exp(-2. * kPi * cutoffHz / sampleRate);
+  return fromCookbook(1., -1., 0., 1., -pole, 0.);
+}
+
+BiquadCoefficients BiquadCoefficients::preEmphasis(float amount) {
+  BiquadCoefficients result;
+  result.b1 = -amount;
+  return result;
+}
+
+double BiquadCoefficients::gainAt(double sampleRate, double freqHz) const {
+  const auto z1 = std::polar(1., -2. * kPi * freqHz / sampleRate);  // z^-1
+  const auto z2 = z1 * z1;
+  return std::abs((double(b0) + double(b1) * z1 + double(b2) * z2)
+                  / (1. + double(a1) * z1 + double(a2) * z2));
+}
+
+
+BiquadCascade::BiquadCascade(int numChannels, size_t numStages) {
+  if(numChannels <= 0) return;
+
+  mNumChannels = numChannels;
+  mStages.resize(numStages);
+  const auto numGroups = (size_t(numChannels) + kLanes - 1) / kLanes;
+  mStates.resize(numGroups * numStages * 2 * kLanes);
+  mTile.resize(1, kTileSize * kLanes);
+}
+
+BiquadCascade::Coefficients BiquadCascade::currentCoefficients(const Stage& stage) {
+  if(stage.rampPos < stage.rampLength) {
+    Coefficients result;
+    for(size_t i = 0; i < result.size(); ++i)
+      result[i] = stage.origin[i] + float(stage.rampPos) * stage.delta[i];
+    return result;
+  }
+  const auto& target = stage.target;
+  return {target.b0, target.b1, target.b2, target.a1, target.a2};
+}
+
+void BiquadCascade::setCoefficients(
+    size_t iStage, const BiquadCoefficients& coefficients, size_t rampSamples) {
+  V1_ASSERT(iStage < mStages.size());
+  auto& stage = mStages[iStage];
+  stage.origin = currentCoefficients(stage);
+  stage.target = coefficients;
+  stage.rampPos = 0;
+  stage.rampLength = rampSamples;
+
+  const Coefficients target = {
+      coefficients.b0, coefficients.b1, coefficients.b2, coefficients.a1, coefficients.a2};
+  for(size_t i = 0; i < target.size(); ++i)
+    stage.delta[i] = rampSamples ? (target[i] - stage.origin[i]) / float(rampSamples) : 0.f;
+}
+
+void BiquadCascade::process(AudioBlock block) {
+  V1_ASSERT(isValid() && block.numChannels == mNumChannels);
+  const auto numStages = mStages.size();
+  const auto pTile = mTile.channel(0).data();
+
+  for(size_t tileStart = 0; tileStart < block.numSamples; tileStart += kTileSize) {
+    const auto tileLength = std::min(kTileSize, block.numSamples - tileStart);
+
+    for(int firstChannel = 0; firstChannel < mNumChannels; firstChannel += int(kLanes)) {
+      const auto numGroupChannels = std::min(int(kLanes), mNumChannels - firstChannel);
+      float* ppChannels[kLanes];
+      for(int chan = 0; chan < numGroupChannels; ++chan)
+        ppChannels[chan] = block.ppBuffer[firstChannel + chan] + tileStart;
+      const AudioBlock groupBlock(ppChannels, numGroupChannels, tileLength);
+      const InterleavedAudioBlock tile(pTile, int(kLanes), tileLength);
+
+      ops::interleave<float>(groupBlock, tile);
+      auto pState = mStates.data() + size_t(firstChannel) / kLanes * numStages * 2 * kLanes;
+      for(const auto& stage : mStages) {
+        const auto start = currentCoefficients(stage);
+        const auto rampLength = std::min(stage.rampLength - stage.rampPos, tileLength);
+        const auto& target = stage.target;
+        const Coefficients steady = {target.b0, target.b1, target.b2, target.a1, target.a2};
+        biquadKernel(pTile, tileLength, start.data(), stage.delta.data(), rampLength,
+            steady.data(), pState);
+        pState += 2 * kLanes;
+      }
+      ops::deinterleave<float>(tile, groupBlock);
+    }
+
+    for(auto& stage : mStages) {
+      if(stage.rampPos < stage.rampLength)
+        stage.rampPos = std::min(stage.rampLength, stage.rampPos + tileLength);
+    }
+  }
+
+  // decaying states would become denormals, which are slow
+  ops::flushDenormals(make_span(mStates));
+}
+
+void BiquadCascade::reset() {
+  std::fill(mStates.begin(), mStates.end(), 0.f);
+  for(auto& stage : mStages) stage.rampPos = stage.rampLength;
+}
+
+}  // namespace v1util::dsp
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "audioBlock.hpp"
+#include "audioBuffer.hpp"
+
+#include "v1util/base/cpppainrelief.hpp"
+#include "v1util/base/math.hpp"
+#include "v1util/base/platform.hpp"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace v1util::dsp {
+
+/** y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+ *
+ * The default is the identity. The factories follow the "Audio EQ Cookbook" by R. Bristow-Johnson.
+ */
+struct BiquadCoefficients {
+  static constexpr const double kButterworthQ = 1. / kSqrt2;
+
+  float b0 = 1.f, b1 = 0.f, b2 = 0.f;
+  float a1 = 0.f, a2 = 0.f;
+
+  V1_PUBLIC static BiquadCoefficients lowPass(
+      double sampleRate, double freqHz, double q = kButterworthQ);
+  V1_PUBLIC static BiquadCoefficients highPass(
+      double sampleRate, double freqHz, double q = kButterworthQ);
+  //! With a gain of 1 at @p freqHz
+  V1_PUBLIC static BiquadCoefficients bandPass(double sampleRate, double freqHz, double q);
+  V1_PUBLIC static BiquadCoefficients notch(double sampleRate, double freqHz, double q);
+  V1_PUBLIC static BiquadCoefficients peaking(
+      double sampleRate, double freqHz, double q, double gainDb);
+
+  //! First order: y[n] = x[n] - x[n-1] + r y[n-1], -3 dB at about @p cutoffHz
+  V1_PUBLIC static BiquadCoefficients dcBlocker(double sampleRate, double cutoffHz);
+  //! First order: y[n] = x[n] - amount x[n-1]
+  V1_PUBLIC static BiquadCoefficients preEmphasis(float amount);
+
+  //! The magnitude of the frequency response at @p freqHz
+  V1_PUBLIC double gainAt(double sampleRate, double freqHz) const;
+};
+
+/** Cascade of biquads in transposed direct form II, with the same coefficients for all channels
+ *
+ * Vectorized across channels: groups of kLanes channels are transposed into tiles of kTileSize
+ * samples, one lane per channel, and run through all stages while they are in the L1 cache.
+ *
+ * New coefficients can be ramped in linearly, sample by sample, to avoid zipper noise. Since the
+ * stable (a1, a2) form a triangle, the coefficients in between are stable, too.
+ */
+class BiquadCascade {
+ public:
+  static constexpr const size_t kLanes = 8;
+  static constexpr const size_t kTileSize = 64;
+
+  BiquadCascade() = default;
+  //! Every stage starts as the identity
+  V1_PUBLIC BiquadCascade(int numChannels, size_t numStages);
+  V1_DEFAULT_CP_MV_MAYTHROW(BiquadCascade)
+
+  bool isValid() const { return mNumChannels > 0; }
+  int numChannels() const { return mNumChannels; }
+  size_t numStages() const { return mStages.size(); }
+
+  /** Change the coefficients of @p stage, within the next @p rampSamples
+   *
+   * A ramp starts from where a ramp in progress is.
+   */
+  V1_PUBLIC void setCoefficients(
+      size_t stage, const BiquadCoefficients& coefficients, size_t rampSamples = 0);
+  const BiquadCoefficients& coefficients(size_t stage) const { return mStages[stage].target; }
+
+  //! Filter all channels of @p block in place
+  V1_PUBLIC void process(AudioBlock block);
+
+  //! Clear the filter states and finish ramps
+  V1_PUBLIC void reset();
+
+ private:
+  using Coefficients = std::array<float, 5>;  // b0, b1, b2, a1, a2
+
+  struct Stage {
+    BiquadCoefficients target;
+    Coefficients origin = {};  // of the ramp
+    Coefficients delta = {};  // per sample
+    size_t rampPos = 0, rampLength = 0;
+  };
+
+  //! The coefficients at the current position of a ramp
+  static Coefficients currentCoefficients(const Stage& stage);
+
+  int mNumChannels = 0;
+  std::vector<Stage> mStages;
+  std::vector<float> mStates;  // per group of channels and stage: s1 and s2 of kLanes channels
+  AudioBuffer mTile;  // kTileSize samples of kLanes interleaved channels
+};
+
+}  // namespace v1util::dsp
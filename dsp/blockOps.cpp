@@ -0,0 +1,433 @@
+#include "blockOps.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+namespace v1util::dsp::ops {
+
+namespace {
+constexpr const uint32_t kSignMask = 0x8000'0000U;
+constexpr const uint32_t kExponentMask = 0x7F80'0000U;
+constexpr const float kInt16FullScale = float(0x7FFF);
+constexpr const double kInt32FullScale = double(0x7FFF'FFFF);
+
+//! Ramps restart from an exact gain every so often, so that float(i) stays exact
+constexpr const size_t kRampChunkSize = size_t(1) << 16;
+
+inline int32_t toBits(float value) {
+  int32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline float fromBits(int32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+//! Limits to [-1, 1] by comparing the magnitude bits, which order like the values
+inline float clipToUnit(float value) {
+  constexpr const int32_t kUnitBits = 0x3F80'0000;
+  const auto bits = toBits(value);
+  const auto magnitudeBits = bits & int32_t(~kSignMask);
+  return fromBits(magnitudeBits > kUnitBits ? (bits & int32_t(kSignMask)) | kUnitBits : bits);
+}
+
+//! Rounds half away from zero on conversion to an integer
+inline float roundingOffset(float value) {
+  return fromBits((toBits(value) & int32_t(kSignMask)) | toBits(0.5f));
+}
+
+
+// kernels; free functions, because compilers only trust __restrict on parameters
+
+V1_TARGET_CLONES void fillKernel(float* __restrict pTarget, size_t count, float value) {
+  for(size_t i = 0; i < count; ++i) pTarget[i] = value;
+}
+
+V1_TARGET_CLONES void gainKernel(float* __restrict pSamples, size_t count, float gain) {
+  for(size_t i = 0; i < count; ++i) pSamples[i] *= gain;
+}
+
+V1_TARGET_CLONES void gainRampKernel(
+    float* __restrict pSamples, int32_t count, float startGain, float step) {
+  for(int32_t i = 0; i < count; ++i) pSamples[i] *= startGain + step * float(i);
+}
+
+V1_TARGET_CLONES void mixKernel(
+    const float* __restrict pSource, float* __restrict pTarget, size_t count, float gain) {
+  for(size_t i = 0; i < count; ++i) pTarget[i] += gain * pSource[i];
+}
+
+V1_TARGET_CLONES void mixRampKernel(const float* __restrict pSource, float* __restrict pTarget,
+    int32_t count, float startGain, float step) {
+  for(int32_t i = 0; i < count; ++i) pTarget[i] += (startGain + step * float(i)) * pSource[i];
+}
+
+V1_TARGET_CLONES int32_t peakBitsKernel(const float* __restrict pSamples, size_t count) {
+  int32_t maxBits = 0;
+  for(size_t i = 0; i < count; ++i) {
+    const auto magnitudeBits = toBits(pSamples[i]) & int32_t(~kSignMask);
+    maxBits = magnitudeBits > maxBits ? magnitudeBits : maxBits;
+  }
+  return maxBits;
+}
+
+V1_TARGET_CLONES double sumOfSquaresKernel(const float* __restrict pSamples, size_t count) {
+  constexpr const size_t kLanes = 8;
+  double sums[kLanes] = {};
+  const auto vectorCount = count - count % kLanes;
+  for(size_t i = 0; i < vectorCount; i += kLanes) {
+    for(size_t lane = 0; lane < kLanes; ++lane) {
+      const auto sample = double(pSamples[i + lane]);
+      sums[lane] += sample * sample;
+    }
+  }
+  for(size_t i = vectorCount; i < count; ++i) sums[0] += double(pSamples[i]) * pSamples[i];
+  return ((sums[0] + sums[1]) + (sums[2] + sums[3])) + ((sums[4] + sums[5]) + (sums[6] + sums[7]));
+}
+
+V1_TARGET_CLONES void clipKernel(float* __restrict pSamples, size_t count, int32_t ceilingBits) {
+  for(size_t i = 0; i < count; ++i) {
+    const auto bits = toBits(pSamples[i]);
+    const auto magnitudeBits = bits & int32_t(~kSignMask);
+    pSamples[i] =
+        fromBits(magnitudeBits > ceilingBits ? (bits & int32_t(kSignMask)) | ceilingBits : bits);
+  }
+}
+
+V1_TARGET_CLONES void flushDenormalsKernel(float* __restrict pSamples, size_t count) {
+  for(size_t i = 0; i < count; ++i) {
+    const auto bits = toBits(pSamples[i]);
+    const auto keepMask = (bits & int32_t(kExponentMask)) ? int32_t(~0) : int32_t(kSignMask);
+    pSamples[i] = fromBits(bits & keepMask);
+  }
+}
+
+V1_TARGET_CLONES void int16ToFloatKernel(
+    const int16_t* __restrict pSource, float* __restrict pTarget, size_t count) {
+  for(size_t i = 0; i < count; ++i) pTarget[i] = float(pSource[i]) * (1.f / kInt16FullScale);
+}
+
+V1_TARGET_CLONES void int32ToFloatKernel(
+    const int32_t* __restrict pSource, float* __restrict pTarget, size_t count) {
+  for(size_t i = 0; i < count; ++i)
+    pTarget[i] = float(double(pSource[i]) * (1. / kInt32FullScale));
+}
+
+V1_TARGET_CLONES void floatToInt16Kernel(
+    const float* __restrict pSource, int16_t* __restrict pTarget, size_t count) {
+  for(size_t i = 0; i < count; ++i) {
+    const auto scaled = clipToUnit(pSource[i]) * kInt16FullScale;
+    pTarget[i] = int16_t(int32_t(scaled + roundingOffset(scaled)));
+  }
+}
+
+V1_TARGET_CLONES void floatToInt32Kernel(
+    const float* __restrict pSource, int32_t* __restrict pTarget, size_t count) {
+  for(size_t i = 0; i < count; ++i) {
+    const auto clipped = clipToUnit(pSource[i]);
+    pTarget[i] = int32_t(double(clipped) * kInt32FullScale + double(roundingOffset(clipped)));
+  }
+}
+
+template <typename T>
+inline void deinterleave2Loop(const T* __restrict pSource,
+    T* __restrict pTarget0, T* __restrict pTarget1, size_t count) {
+  for(size_t i = 0; i < count; ++i) {
+    pTarget0[i] = pSource[2 * i];
+    pTarget1[i] = pSource[2 * i + 1];
+  }
+}
+
+template <typename T>
+inline void deinterleave4Loop(const T* __restrict pSource,
+    T* __restrict pTarget0, T* __restrict pTarget1, T* __restrict pTarget2,
+    T* __restrict pTarget3, size_t count) {
+  for(size_t i = 0; i < count; ++i) {
+    pTarget0[i] = pSource[4 * i];
+    pTarget1[i] = pSource[4 * i + 1];
+    pTarget2[i] = pSource[4 * i + 2];
+    pTarget3[i] = pSource[4 * i + 3];
+  }
+}
+
+template <typename T>
+inline void interleave2Loop(const T* __restrict pSource0,
+    const T* __restrict pSource1, T* __restrict pTarget, size_t count) {
+  for(size_t i = 0; i < count; ++i) {
+    pTarget[2 * i] = pSource0[i];
+    pTarget[2 * i + 1] = pSource1[i];
+  }
+}
+
+template <typename T>
+inline void interleave4Loop(const T* __restrict pSource0,
+    const T* __restrict pSource1, const T* __restrict pSource2,
+    const T* __restrict pSource3, T* __restrict pTarget, size_t count) {
+  for(size_t i = 0; i < count; ++i) {
+    pTarget[4 * i] = pSource0[i];
+    pTarget[4 * i + 1] = pSource1[i];
+    pTarget[4 * i + 2] = pSource2[i];
+    pTarget[4 * i + 3] = pSource3[i];
+  }
+}
+
+//! Four adjacent channels of a wider interleaved layout
+template <typename T>
+inline void deinterleaveGroupLoop(const T* __restrict pSource, size_t stride,
+    T* __restrict pTarget0, T* __restrict pTarget1, T* __restrict pTarget2,
+    T* __restrict pTarget3, size_t count) {
+  // 4x4 tiles, so that loads and stores are four adjacent values each
+  const auto tiledCount = count - count % 4;
+  for(size_t i = 0; i < tiledCount; i += 4) {
+    T tile[4][4];
+    for(size_t row = 0; row < 4; ++row)
+      for(size_t chan = 0; chan < 4; ++chan) tile[chan][row] = pSource[stride * (i + row) + chan];
+    for(size_t row = 0; row < 4; ++row) {
+      pTarget0[i + row] = tile[0][row];
+      pTarget1[i + row] = tile[1][row];
+      pTarget2[i + row] = tile[2][row];
+      pTarget3[i + row] = tile[3][row];
+    }
+  }
+  for(size_t i = tiledCount; i < count; ++i) {
+    pTarget0[i] = pSource[stride * i];
+    pTarget1[i] = pSource[stride * i + 1];
+    pTarget2[i] = pSource[stride * i + 2];
+    pTarget3[i] = pSource[stride * i + 3];
+  }
+}
+
+template <typename T>
+inline void interleaveGroupLoop(const T* __restrict pSource0,
+    const T* __restrict pSource1, const T* __restrict pSource2,
+    const T* __restrict pSource3, T* __restrict pTarget, size_t stride, size_t count) {
+  for(size_t i = 0; i < count; ++i) {
+    pTarget[stride * i] = pSource0[i];
+    pTarget[stride * i + 1] = pSource1[i];
+    pTarget[stride * i + 2] = pSource2[i];
+    pTarget[stride * i + 3] = pSource3[i];
+  }
+}
+
+/* The transposes only move samples, so their loops are templates; but clang can't clone function
+ * templates for several instruction sets, so the kernels are stamped out per sample type. */
+#define V1_TRANSPOSE_KERNELS(T)                                                                 \
+  V1_TARGET_CLONES void deinterleave2Kernel(const T* __restrict pSource,                        \
+      T* __restrict pTarget0, T* __restrict pTarget1, size_t count) {                           \
+    deinterleave2Loop(pSource, pTarget0, pTarget1, count);                                      \
+  }                                                                                             \
+  V1_TARGET_CLONES void deinterleave4Kernel(const T* __restrict pSource,                        \
+      T* __restrict pTarget0, T* __restrict pTarget1, T* __restrict pTarget2,                   \
+      T* __restrict pTarget3, size_t count) {                                                   \
+    deinterleave4Loop(pSource, pTarget0, pTarget1, pTarget2, pTarget3, count);                  \
+  }                                                                                             \
+  V1_TARGET_CLONES void interleave2Kernel(const T* __restrict pSource0,                         \
+      const T* __restrict pSource1, T* __restrict pTarget, size_t count) {                      \
+    interleave2Loop(pSource0, pSource1, pTarget, count);                                        \
+  }                                                                                             \
+  V1_TARGET_CLONES void interleave4Kernel(const T* __restrict pSource0,                         \
+      const T* __restrict pSource1, const T* __restrict pSource2,                               \
+      const T* __restrict pSource3, T* __restrict pTarget, size_t count) {                      \
+    interleave4Loop(pSource0, pSource1, pSource2, pSource3, pTarget, count);                    \
+  }                                                                                             \
+  V1_TARGET_CLONES void deinterleaveGroupKernel(const T* __restrict pSource, size_t stride,     \
+      T* __restrict pTarget0, T* __restrict pTarget1, T* __restrict pTarget2,                   \
+      T* __restrict pTarget3, size_t count) {                                                   \
+    deinterleaveGroupLoop(pSource, stride, pTarget0, pTarget1, pTarget2, pTarget3, count);      \
+  }                                                                                             \
+  V1_TARGET_CLONES void interleaveGroupKernel(const T* __restrict pSource0,                     \
+      const T* __restrict pSource1, const T* __restrict pSource2,                               \
+      const T* __restrict pSource3, T* __restrict pTarget, size_t stride, size_t count) {       \
+    interleaveGroupLoop(pSource0, pSource1, pSource2, pSource3, pTarget, stride, count);        \
+  }
+
+V1_TRANSPOSE_KERNELS(int16_t)
+V1_TRANSPOSE_KERNELS(int32_t)
+V1_TRANSPOSE_KERNELS(float)
+V1_TRANSPOSE_KERNELS(double)
+#undef V1_TRANSPOSE_KERNELS
+
+//! Samples per tile of a transpose; a tile of 16 channels fits into 4 KiB
+constexpr const size_t kTransposeTileSize = 64;
+}  // namespace
+
+
+const char* instructionSet() {
+#if defined(V1_HAS_TARGET_CLONES)
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx512f")) return "avx512f";
+  if(__builtin_cpu_supports("avx2")) return "avx2";
+  return "sse2";
+#else
+  return "default";
+#endif
+}
+
+void fill(Span<float> samples, float value) {
+  fillKernel(samples.data(), samples.size(), value);
+}
+
+void copy(ArrayView<float> source, Span<float> target) {
+  V1_ASSERT(source.size() == target.size());
+  if(!source.empty()) std::memcpy(target.data(), source.data(), source.size() * sizeof(float));
+}
+
+void applyGain(Span<float> samples, float gain) {
+  gainKernel(samples.data(), samples.size(), gain);
+}
+
+void applyGainRamp(Span<float> samples, float startGain, float endGain) {
+  if(samples.empty()) return;
+  const auto step = (endGain - startGain) / float(samples.size());
+  for(size_t offset = 0; offset < samples.size(); offset += kRampChunkSize) {
+    const auto count = std::min(kRampChunkSize, samples.size() - offset);
+    gainRampKernel(
+        samples.data() + offset, int32_t(count), startGain + step * float(offset), step);
+  }
+}
+
+void mix(ArrayView<float> source, Span<float> target, float gain) {
+  V1_ASSERT(source.size() == target.size());
+  mixKernel(source.data(), target.data(), source.size(), gain);
+}
+
+void mixWithRamp(ArrayView<float> source, Span<float> target, float startGain, float endGain) {
+  V1_ASSERT(source.size() == target.size());
+  if(source.empty()) return;
+  const auto step = (endGain - startGain) / float(source.size());
+  for(size_t offset = 0; offset < source.size(); offset += kRampChunkSize) {
+    const auto count = std::min(kRampChunkSize, source.size() - offset);
+    mixRampKernel(source.data() + offset, target.data() + offset, int32_t(count),
+        startGain + step * float(offset), step);
+  }
+}
+
+float peak(ArrayView<float> samples) {
+  return fromBits(peakBitsKernel(samples.data(), samples.size()));
+}
+
+float rms(ArrayView<float> samples) {
+  if(samples.empty()) return 0.f;
+  return float(std::sqrt(sumOfSquaresKernel(samples.data(), samples.size()) / samples.size()));
+}
+
+void clip(Span<float> samples, float ceiling) {
+  V1_ASSERT(ceiling >= 0.f);
+  clipKernel(samples.data(), samples.size(), toBits(ceiling));
+}
+
+void flushDenormals(Span<float> samples) {
+  flushDenormalsKernel(samples.data(), samples.size());
+}
+
+void convert(ArrayView<int16_t> source, Span<float> target) {
+  V1_ASSERT(source.size() == target.size());
+  int16ToFloatKernel(source.data(), target.data(), source.size());
+}
+
+void convert(ArrayView<int32_t> source, Span<float> target) {
+  V1_ASSERT(source.size() == target.size());
+  int32ToFloatKernel(source.data(), target.data(), source.size());
+}
+
+void convert(ArrayView<float> source, Span<int16_t> target) {
+  V1_ASSERT(source.size() == target.size());
+  floatToInt16Kernel(source.data(), target.data(), source.size());
+}
+
+void convert(ArrayView<float> source, Span<int32_t> target) {
+  V1_ASSERT(source.size() == target.size());
+  floatToInt32Kernel(source.data(), target.data(), source.size());
+}
+
+template <typename Sample>
+void deinterleave(typename detail::NonDeduced<BasicConstInterleavedAudioBlock<Sample>>::Type source,
+    BasicAudioBlock<Sample> target) {
+  V1_ASSERT(target.numChannels <= source.numChannels && target.numSamples == source.numSamples);
+  const auto count = source.numSamples;
+  const auto* pSource = source.pSamples;
+  auto** ppTarget = target.ppBuffer;
+  if(!count || !target.numChannels) return;
+
+  if(source.numChannels == 1) {
+    std::memcpy(ppTarget[0], pSource, count * sizeof(Sample));
+    return;
+  }
+  if(source.numChannels == 2 && target.numChannels == 2)
+    return deinterleave2Kernel(pSource, ppTarget[0], ppTarget[1], count);
+  if(source.numChannels == 4 && target.numChannels == 4)
+    return deinterleave4Kernel(pSource, ppTarget[0], ppTarget[1], ppTarget[2], ppTarget[3], count);
+
+  // the tile is read once from memory, and then from the cache for every channel
+  const auto stride = size_t(source.numChannels);
+  for(size_t begin = 0; begin < count; begin += kTransposeTileSize) {
+    const auto end = std::min(begin + kTransposeTileSize, count);
+    int chan = 0;
+    for(; chan + 4 <= target.numChannels; chan += 4) {
+      deinterleaveGroupKernel(pSource + begin * stride + size_t(chan), stride,
+          ppTarget[chan] + begin, ppTarget[chan + 1] + begin, ppTarget[chan + 2] + begin,
+          ppTarget[chan + 3] + begin, end - begin);
+    }
+    for(; chan < target.numChannels; ++chan) {
+      const auto* pChannel = pSource + size_t(chan);
+      auto* pTarget = ppTarget[chan];
+      for(size_t i = begin; i < end; ++i) pTarget[i] = pChannel[i * stride];
+    }
+  }
+}
+
+template <typename Sample>
+void interleave(typename detail::NonDeduced<BasicConstAudioBlock<Sample>>::Type source,
+    BasicInterleavedAudioBlock<Sample> target) {
+  V1_ASSERT(source.numChannels <= target.numChannels && target.numSamples == source.numSamples);
+  const auto count = source.numSamples;
+  const auto* const* ppSource = source.ppBuffer;
+  auto* pTarget = target.pSamples;
+  if(!count || !source.numChannels) return;
+
+  if(target.numChannels == 1) {
+    std::memcpy(pTarget, ppSource[0], count * sizeof(Sample));
+    return;
+  }
+  if(source.numChannels == 2 && target.numChannels == 2)
+    return interleave2Kernel(ppSource[0], ppSource[1], pTarget, count);
+  if(source.numChannels == 4 && target.numChannels == 4)
+    return interleave4Kernel(ppSource[0], ppSource[1], ppSource[2], ppSource[3], pTarget, count);
+
+  const auto stride = size_t(target.numChannels);
+  for(size_t begin = 0; begin < count; begin += kTransposeTileSize) {
+    const auto end = std::min(begin + kTransposeTileSize, count);
+    int chan = 0;
+    for(; chan + 4 <= source.numChannels; chan += 4) {
+      interleaveGroupKernel(ppSource[chan] + begin, ppSource[chan + 1] + begin,
+          ppSource[chan + 2] + begin, ppSource[chan + 3] + begin,
+          pTarget + begin * stride + size_t(chan), stride, end - begin);
+    }
+    for(; chan < source.numChannels; ++chan) {
+      const auto* pSource = ppSource[chan];
+      auto* pChannel = pTarget + size_t(chan);
+      for(size_t i = begin; i < end; ++i) pChannel[i * stride] = pSource[i];
+    }
+  }
+}
+
+template void deinterleave<int16_t>(
+    BasicConstInterleavedAudioBlock<int16_t>, BasicAudioBlock<int16_t>);
+template void deinterleave<int32_t>(
+    BasicConstInterleavedAudioBlock<int32_t>, BasicAudioBlock<int32_t>);
+template void deinterleave<float>(BasicConstInterleavedAudioBlock<float>, BasicAudioBlock<float>);
+template void deinterleave<double>(
+    BasicConstInterleavedAudioBlock<double>, BasicAudioBlock<double>);
+template void interleave<int16_t>(
+    BasicConstAudioBlock<int16_t>, BasicInterleavedAudioBlock<int16_t>);
+template void interleave<int32_t>(
+    BasicConstAudioBlock<int32_t>, BasicInterleavedAudioBlock<int32_t>);
+template void interleave<float>(BasicConstAudioBlock<float>, BasicInterleavedAudioBlock<float>);
+template void interleave<double>(BasicConstAudioBlock<double>, BasicInterleavedAudioBlock<double>);
+
+}  // namespace v1util::dsp::ops
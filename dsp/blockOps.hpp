@@ -0,0 +1,177 @@
+#pragma once
+
+#include "audioBlock.hpp"
+#include "interleavedAudioBlock.hpp"
+
+#include "v1util/base/debug.hpp"
+#include "v1util/base/platform.hpp"
+#include "v1util/container/array_view.hpp"
+#include "v1util/container/span.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+
+/** Vectorized operations on channels and blocks of audio
+ *
+ * The channel kernels are compiled for SSE2, AVX2 and AVX-512, and the best one is picked at
+ * load time (x86-64 Linux with GCC or Clang; elsewhere, they are compiled for the target only).
+ * Comparisons are done on the bits of the samples, so that the compiler vectorizes them without
+ * -fno-trapping-math.
+ *
+ * Sources and targets must not overlap.
+ */
+
+namespace v1util::dsp::ops {
+
+//! The instruction set of the kernels in use, e.g. "avx2"
+V1_PUBLIC const char* instructionSet();
+
+
+// @{ channels
+V1_PUBLIC void fill(Span<float> samples, float value);
+V1_PUBLIC void copy(ArrayView<float> source, Span<float> target);
+V1_PUBLIC void applyGain(Span<float> samples, float gain);
+
+/** Multiply with a gain that moves linearly from @p startGain towards @p endGain
+ *
+ * The last sample gets the gain before @p endGain, so that consecutive blocks with the end gain
+ * of one as the start gain of the next form one ramp.
+ */
+V1_PUBLIC void applyGainRamp(Span<float> samples, float startGain, float endGain);
+
+//! target += gain * source
+V1_PUBLIC void mix(ArrayView<float> source, Span<float> target, float gain = 1.f);
+//! target += gain * source, with a gain ramp as in applyGainRamp()
+V1_PUBLIC void mixWithRamp(
+    ArrayView<float> source, Span<float> target, float startGain, float endGain);
+
+//! The largest absolute value, 0 if empty
+V1_PUBLIC float peak(ArrayView<float> samples);
+//! The root mean square, 0 if empty
+V1_PUBLIC float rms(ArrayView<float> samples);
+
+//! Limit to [-ceiling, ceiling], with @p ceiling >= 0
+V1_PUBLIC void clip(Span<float> samples, float ceiling);
+//! Replace denormals by zeros of the same sign
+V1_PUBLIC void flushDenormals(Span<float> samples);
+
+/** Convert from and to PCM with full scale at 0x7FFF or 0x7FFF'FFFF, as in wave files
+ *
+ * Conversions to PCM round and saturate.
+ */
+V1_PUBLIC void convert(ArrayView<int16_t> source, Span<float> target);
+V1_PUBLIC void convert(ArrayView<int32_t> source, Span<float> target);
+V1_PUBLIC void convert(ArrayView<float> source, Span<int16_t> target);
+V1_PUBLIC void convert(ArrayView<float> source, Span<int32_t> target);
+// @}
+
+
+// @{ blocks
+inline void fill(AudioBlock block, float value) {
+  for(int chan = 0; chan < block.numChannels; ++chan) fill(block.channel(chan), value);
+}
+
+inline void copy(ConstAudioBlock source, AudioBlock target) {
+  V1_ASSERT(source.numChannels == target.numChannels && source.numSamples == target.numSamples);
+  for(int chan = 0; chan < source.numChannels; ++chan)
+    copy(source.channel(chan), target.channel(chan));
+}
+
+inline void applyGain(AudioBlock block, float gain) {
+  for(int chan = 0; chan < block.numChannels; ++chan) applyGain(block.channel(chan), gain);
+}
+
+inline void applyGainRamp(AudioBlock block, float startGain, float endGain) {
+  for(int chan = 0; chan < block.numChannels; ++chan)
+    applyGainRamp(block.channel(chan), startGain, endGain);
+}
+
+inline void mix(ConstAudioBlock source, AudioBlock target, float gain = 1.f) {
+  V1_ASSERT(source.numChannels == target.numChannels && source.numSamples == target.numSamples);
+  for(int chan = 0; chan < source.numChannels; ++chan)
+    mix(source.channel(chan), target.channel(chan), gain);
+}
+
+inline void mixWithRamp(ConstAudioBlock source, AudioBlock target, float startGain, float endGain) {
+  V1_ASSERT(source.numChannels == target.numChannels && source.numSamples == target.numSamples);
+  for(int chan = 0; chan < source.numChannels; ++chan)
+    mixWithRamp(source.channel(chan), target.channel(chan), startGain, endGain);
+}
+
+//! The peak of every channel
+inline void peak(ConstAudioBlock block, Span<float> perChannel) {
+  V1_ASSERT(perChannel.size() >= size_t(block.numChannels));
+  for(int chan = 0; chan < block.numChannels; ++chan)
+    perChannel[size_t(chan)] = peak(block.channel(chan));
+}
+
+//! The RMS of every channel
+inline void rms(ConstAudioBlock block, Span<float> perChannel) {
+  V1_ASSERT(perChannel.size() >= size_t(block.numChannels));
+  for(int chan = 0; chan < block.numChannels; ++chan)
+    perChannel[size_t(chan)] = rms(block.channel(chan));
+}
+
+inline void clip(AudioBlock block, float ceiling) {
+  for(int chan = 0; chan < block.numChannels; ++chan) clip(block.channel(chan), ceiling);
+}
+
+inline void flushDenormals(AudioBlock block) {
+  for(int chan = 0; chan < block.numChannels; ++chan) flushDenormals(block.channel(chan));
+}
+
+/** Convert all samples of @p source into @p target, see convertSample()
+ *
+ * Float to and from int16_t or int32_t uses the vectorized convert() of channels, and same types
+ * are copied.
+ */
+template <typename From, typename To>
+void convert(BasicConstAudioBlock<From> source, BasicAudioBlock<To> target) {
+  V1_ASSERT(source.numChannels == target.numChannels && source.numSamples == target.numSamples);
+  for(int chan = 0; chan < source.numChannels; ++chan) {
+    auto sourceChannel = source.channel(chan);
+    auto targetChannel = target.channel(chan);
+    if constexpr(std::is_same_v<From, To>) {
+      if(source.numSamples)
+        std::memcpy(targetChannel.data(), sourceChannel.data(), source.numSamples * sizeof(To));
+    } else if constexpr((std::is_same_v<From, float> && !std::is_same_v<To, double>)
+                        || (std::is_same_v<To, float> && !std::is_same_v<From, double>)) {
+      convert(sourceChannel, targetChannel);
+    } else {
+      for(size_t i = 0; i < source.numSamples; ++i)
+        targetChannel[i] = convertSample<To>(sourceChannel[i]);
+    }
+  }
+}
+
+//! Deduces the sample types of a mutable @p source, too
+template <typename From, typename To>
+void convert(BasicAudioBlock<From> source, BasicAudioBlock<To> target) {
+  convert(BasicConstAudioBlock<From>(source), target);
+}
+
+namespace detail {
+template <typename T>
+struct NonDeduced {
+  using Type = T;
+};
+}  // namespace detail
+
+/** Copy the first target.numChannels channels of @p source into @p target
+ *
+ * A transpose in tiles that fit into the L1 cache, four channels at a time; mono, stereo and
+ * quad are special-cased. For int16_t, int32_t, float and double samples.
+ */
+template <typename Sample>
+V1_PUBLIC void deinterleave(
+    typename detail::NonDeduced<BasicConstInterleavedAudioBlock<Sample>>::Type source,
+    BasicAudioBlock<Sample> target);
+//! Copy @p source into the first source.numChannels channels of @p target, see deinterleave()
+template <typename Sample>
+V1_PUBLIC void interleave(typename detail::NonDeduced<BasicConstAudioBlock<Sample>>::Type source,
+    BasicInterleavedAudioBlock<Sample> target);
+// @}
+
+}  // namespace v1util::dsp::ops
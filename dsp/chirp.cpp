@@ -0,0 +1,61 @@
+#include "chirp.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+
+namespace v1util::dsp::detail {
+
+namespace {
+//! Adding and subtracting it rounds doubles of magnitude < 2^51 to integers
+constexpr const double kRoundingMagic = 0x1.8p52;
+
+//! An odd polynomial (near-minimax) of sin(2 pi x) on [0, 1/4], in powers of x^2
+constexpr const double kSineCoefficients[] = {0x1.921fb5438494cp+2, -0x1.4abbce38aae01p+5,
+    0x1.466bbc0568c8fp+6, -0x1.32d08e4cd3a48p+6, 0x1.4ffffab3e8111p+5, -0x1.cac8e8e1931a6p+3};
+
+/** sin(2 pi turns), within 1.4e-11
+ *
+ * Reduced to [-1/2, 1/2] turns, then by symmetry to [0, 1/4]; only arithmetic and bit
+ * operations, so that it vectorizes.
+ */
+inline double sinOfTurns(double turns) {
+  const auto reduced = turns - ((turns + kRoundingMagic) - kRoundingMagic);
+  const auto x = 0.25 - std::abs(std::abs(reduced) - 0.25);
+  const auto x2 = x * x;
+  auto polynomial = kSineCoefficients[5];
+  for(int k = 4; k >= 0; --k) polynomial = polynomial * x2 + kSineCoefficients[k];
+  return std::copysign(x * polynomial, reduced);
+}
+
+
+// kernels; free functions, because compilers only trust __restrict on parameters
+
+V1_TARGET_CLONES void quadraticPhaseKernel(double* __restrict pOut, int32_t first, int32_t end,
+    double phase, double rate, double acceleration) {
+  for(int32_t i = first; i < end; ++i) {
+    const auto t = double(i);
+    pOut[i] = sinOfTurns(phase + t * (rate + t * acceleration));
+  }
+}
+
+V1_TARGET_CLONES void exponentialPhaseKernel(double* __restrict pOut,
+    const double* __restrict pExpm1, size_t first, size_t end, double phase, double scale) {
+  for(size_t i = first; i < end; ++i) pOut[i] = sinOfTurns(phase + scale * pExpm1[i]);
+}
+}  // namespace
+
+
+void sinOfQuadraticPhase(
+    double* pOut, size_t first, size_t end, double phase, double rate, double acceleration) {
+  V1_ASSERT(first <= end && end <= size_t(INT32_MAX));
+  quadraticPhaseKernel(pOut, int32_t(first), int32_t(end), phase, rate, acceleration);
+}
+
+void sinOfExponentialPhase(
+    double* pOut, const double* pExpm1, size_t first, size_t end, double phase, double scale) {
+  V1_ASSERT(first <= end);
+  exponentialPhaseKernel(pOut, pExpm1, first, end, phase, scale);
+}
+
+}  // namespace v1util::dsp::detail
@@ -1,58 +1,180 @@
 #pragma once
 
+#include "audioBlock.hpp"
+#include "sampleFormat.hpp"
+
 #include "v1util/base/cpppainrelief.hpp"
+#include "v1util/base/debug.hpp"
+#include "v1util/base/platform.hpp"
 #include "v1util/container/span.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstddef>
+#include <cstring>
+#include <type_traits>
 
 namespace v1util { namespace dsp {
 
+namespace detail {
+//! pOut[i] = sin(2 pi (phase + rate * i + acceleration * i^2)) for i in [first, end), in turns
+V1_PUBLIC void sinOfQuadraticPhase(
+    double* pOut, size_t first, size_t end, double phase, double rate, double acceleration);
+//! pOut[i] = sin(2 pi (phase + scale * pExpm1[i])) for i in [first, end), in turns
+V1_PUBLIC void sinOfExponentialPhase(
+    double* pOut, const double* pExpm1, size_t first, size_t end, double phase, double scale);
+}  // namespace detail
+
+
+enum class ChirpSweep {
+  kLinear,  //!< the frequency changes by the same amount per second
+  kExponential  //!< the same time per octave; needs a start frequency > 0
+};
+
+/** Sine sweep from startFreqHz to endFreqHz, faded in and out exponentially
+ *
+ * Generated block by block: every fillBlock() continues where the last one stopped, and the result
+ * doesn't depend on the block sizes. The phase is computed in double precision, in closed form at
+ * every multiple of kChunkSize samples and incrementally within, and its sine by a polynomial, in
+ * vectorized kernels. Before conversion to the output type, samples are within
+ * 2e-11 + 2e-15 * (number of cycles so far) of the exact sweep.
+ */
 template <typename V>
 class ChirpGen {
  public:
-  ChirpGen(V sampleRate, V startFreqHz, V endFreqHz, V durationS, V fadeInOutS)
+  static constexpr const size_t kChunkSize = 256;
+
+  ChirpGen(V sampleRate, V startFreqHz, V endFreqHz, V durationS, V fadeInOutS,
+      ChirpSweep sweep = ChirpSweep::kLinear)
       : mSampleRate(sampleRate)
       , mStartFreqHz(startFreqHz)
       , mEndFreqHz(endFreqHz)
       , mDurationS(durationS)
-      , mFadeInOutS(std::min(fadeInOutS, V(durationS / 3))) {
+      , mFadeInOutS(std::min(fadeInOutS, V(durationS / 3)))
+      , mSweep(sweep) {
     mLengthSmpl = size_t(std::round(mDurationS * mSampleRate));
+    mNumFadeSamples = size_t(std::round(mFadeInOutS * mSampleRate));
+    if(mNumFadeSamples < 2) mNumFadeSamples = 0;  // a fade of one sample has a gain of 1
+
+    const auto sampleRateD = double(mSampleRate);
+    mRate = double(mStartFreqHz) / sampleRateD;
+    if(mSweep == ChirpSweep::kExponential && mStartFreqHz != mEndFreqHz) {
+      V1_ASSERT(mStartFreqHz > 0 && mEndFreqHz > 0);
+      mGrowth = std::log(double(mEndFreqHz) / double(mStartFreqHz))
+                / (double(mDurationS) * sampleRateD);
+      for(size_t i = 0; i < kChunkSize; ++i) mExpm1[i] = std::expm1(double(i) * mGrowth);
+    } else {
+      mAcceleration = double(mEndFreqHz - mStartFreqHz)
+                      / (2. * double(mDurationS) * sampleRateD * sampleRateD);
+    }
+
+    if(mNumFadeSamples) {
+      for(size_t i = 0; i < kChunkSize; ++i) {
+        mFadeInSteps[i] = std::exp(5. * double(i) / double(mNumFadeSamples));
+        mFadeOutSteps[i] = 1. / mFadeInSteps[i];
+      }
+    }
   }
 
   V1_DEFAULT_CP_MV(ChirpGen)
 
   size_t lengthSmpl() const { return mLengthSmpl; }
+  //! The number of samples generated so far
+  size_t position() const { return mPos; }
+  bool done() const { return mPos >= mLengthSmpl; }
+
+  //! Continue at sample @p pos, e.g. 0 to start over
+  void seek(size_t pos) { mPos = std::min(pos, mLengthSmpl); }
 
+  /** Write the next samples into @p span, returning how many were written
+   *
+   * Fewer than span.size() at the end of the sweep; the rest of @p span is left as it is.
+   * Samples of PCM types are converted as by convertSample().
+   */
   template <typename V2>
-  void fillBlock(Span<V2> span) {
-    auto pBuffer = span.data();
-
-    const auto dT = 1 / mSampleRate;
-    const auto w1 = mStartFreqHz * 2 * 3.14;
-    const auto w2 = mEndFreqHz * 2 * 3.14;
-    auto t = 0.;
-    for(size_t i = 0; i < mLengthSmpl; ++i, t += dT) {
-      pBuffer[i] = V2(sin((w1 + (w2 - w1) * t / (2 * mDurationS)) * t));
-    }
+  size_t fillBlock(Span<V2> span) {
+    const auto count = std::min(span.size(), mLengthSmpl - mPos);
+    double chunk[kChunkSize];
+    for(size_t offset = 0; offset < count;) {
+      const auto first = mPos % kChunkSize;
+      const auto end = std::min(kChunkSize, first + (count - offset));
+      generateChunk(chunk, first, end);
 
-    const auto numFadeSamples = size_t(std::round(mFadeInOutS * mSampleRate));
-    const auto decayFactor = -5. / numFadeSamples;
-    auto pFadeIn = pBuffer + numFadeSamples - 1;
-    auto pFadeOut = pBuffer + (mLengthSmpl - numFadeSamples);
-    for(int i = 0; i < numFadeSamples; ++i) {
-      const auto decay = V2(exp(decayFactor * i));
-      *pFadeIn-- *= decay;
-      *pFadeOut++ *= decay;
+      auto pTarget = span.data() + offset - first;
+      for(size_t i = first; i < end; ++i) {
+        if constexpr(std::is_floating_point_v<V2>)
+          pTarget[i] = V2(chunk[i]);
+        else
+          pTarget[i] = convertSample<V2>(chunk[i]);
+      }
+      mPos += end - first;
+      offset += end - first;
     }
+    return count;
+  }
+
+  //! The same sweep into all channels of @p block, see fillBlock(Span)
+  template <typename Sample>
+  size_t fillBlock(BasicAudioBlock<Sample> block) {
+    if(!block.numChannels) return 0U;
+    const auto count = fillBlock(block.channel(0));
+    for(int chan = 1; chan < block.numChannels; ++chan)
+      std::memcpy(block.ppBuffer[chan], block.ppBuffer[0], count * sizeof(Sample));
+    return count;
   }
 
  private:
-  V mSampleRate;
-  V mStartFreqHz, mEndFreqHz;
-  V mDurationS;
-  V mFadeInOutS;
+  //! Samples [first, end) of the chunk that contains mPos, with fades
+  void generateChunk(double* pChunk, size_t first, size_t end) const {
+    V1_ASSERT(first < end && end <= kChunkSize);
+    const auto chunkStart = mPos - first;
+    const auto start = double(chunkStart);
+    if(mGrowth != 0.) {
+      const auto phase = mRate / mGrowth * std::expm1(start * mGrowth);
+      detail::sinOfExponentialPhase(pChunk, mExpm1.data(), first, end, phase - std::floor(phase),
+          mRate / mGrowth * std::exp(start * mGrowth));
+    } else {
+      const auto phase = start * (mRate + mAcceleration * start);
+      detail::sinOfQuadraticPhase(pChunk, first, end, phase - std::floor(phase),
+          mRate + 2. * mAcceleration * start, mAcceleration);
+    }
+
+    // the fade in ends with a gain of 1 at mNumFadeSamples - 1, the fade out starts with it
+    if(chunkStart + first < mNumFadeSamples) {
+      const auto fadeInEnd = std::min(end, mNumFadeSamples - chunkStart);
+      const auto gain =
+          std::exp(-5. * (double(mNumFadeSamples - 1) - start) / double(mNumFadeSamples));
+      for(size_t i = first; i < fadeInEnd; ++i) pChunk[i] *= gain * mFadeInSteps[i];
+    }
+    const auto fadeOutStart = mLengthSmpl - mNumFadeSamples;
+    if(mNumFadeSamples && chunkStart + end > fadeOutStart) {
+      const auto fadeOutFirst =
+          std::max(first, fadeOutStart - std::min(fadeOutStart, chunkStart));
+      const auto gain = std::exp(-5. * (start - double(fadeOutStart)) / double(mNumFadeSamples));
+      for(size_t i = fadeOutFirst; i < end; ++i) pChunk[i] *= gain * mFadeOutSteps[i];
+    }
+  }
+
+  V mSampleRate = 0;
+  V mStartFreqHz = 0, mEndFreqHz = 0;
+  V mDurationS = 0;
+  V mFadeInOutS = 0;
+  ChirpSweep mSweep = ChirpSweep::kLinear;
+
+  size_t mLengthSmpl = 0U;
+  size_t mNumFadeSamples = 0U;
+
+  // in turns per sample:
+  double mRate = 0.;          // at the start
+  double mAcceleration = 0.;  // linear: half the change of mRate per sample
+  double mGrowth = 0.;        // exponential: the log of the growth of mRate per sample
+
+  std::array<double, kChunkSize> mExpm1 = {};  // expm1(i * mGrowth)
+  std::array<double, kChunkSize> mFadeInSteps = {};
+  std::array<double, kChunkSize> mFadeOutSteps = {};
 
-  size_t mLengthSmpl;
+  size_t mPos = 0U;
 };
 
 }}  // namespace v1util::dsp
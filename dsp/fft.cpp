@@ -0,0 +1,201 @@
+#include "fft.hpp"
+
+#include "blockOps.hpp"
+#include "interleavedAudioBlock.hpp"
+
+#include "v1util/base/debug.hpp"
+#include "v1util/base/math.hpp"
+
+#include <cmath>
+#include <utility>
+
+
+namespace v1util::dsp {
+
+namespace {
+// kernels; free functions, because compilers only trust __restrict on parameters
+
+//! A radix-2 Stockham stage with stride 1: y[2p] = a + b, y[2p + 1] = (a - b) w[p]
+V1_TARGET_CLONES void firstStageKernel(const float* __restrict pXr, const float* __restrict pXi,
+    float* __restrict pYr, float* __restrict pYi, const float* __restrict pWr,
+    const float* __restrict pWi, size_t half) {
+  for(size_t p = 0; p < half; ++p) {
+    const auto ar = pXr[p], ai = pXi[p];
+    const auto br = pXr[p + half], bi = pXi[p + half];
+    const auto dr = ar - br, di = ai - bi;
+    pYr[2 * p] = ar + br;
+    pYi[2 * p] = ai + bi;
+    pYr[2 * p + 1] = dr * pWr[p] - di * pWi[p];
+    pYi[2 * p + 1] = dr * pWi[p] + di * pWr[p];
+  }
+}
+
+//! A radix-2 Stockham stage with stride > 1, vectorized along the stride
+V1_TARGET_CLONES void stageKernel(const float* __restrict pXr, const float* __restrict pXi,
+    float* __restrict pYr, float* __restrict pYi, const float* __restrict pWr,
+    const float* __restrict pWi, size_t half, size_t stride) {
+  for(size_t p = 0; p < half; ++p) {
+    const auto wr = pWr[p], wi = pWi[p];
+    const auto a = stride * p, b = stride * (p + half);
+    const auto y0 = stride * 2 * p, y1 = y0 + stride;
+    for(size_t q = 0; q < stride; ++q) {
+      const auto ar = pXr[a + q], ai = pXi[a + q];
+      const auto br = pXr[b + q], bi = pXi[b + q];
+      const auto dr = ar - br, di = ai - bi;
+      pYr[y0 + q] = ar + br;
+      pYi[y0 + q] = ai + bi;
+      pYr[y1 + q] = dr * wr - di * wi;
+      pYi[y1 + q] = dr * wi + di * wr;
+    }
+  }
+}
+
+/** From the FFT Z of z[j] = x[2j] + i x[2j + 1] to the spectrum X of x, for bins [1, n)
+ *
+ * X[k] = E[k] + W^k O[k], with the spectra of the even and odd samples
+ * E[k] = (Z[k] + conj(Z[n - k])) / 2 and O[k] = -i (Z[k] - conj(Z[n - k])) / 2.
+ */
+V1_TARGET_CLONES void splitKernel(const float* __restrict pZr, const float* __restrict pZi,
+    const float* __restrict pWr, const float* __restrict pWi, float* __restrict pXr,
+    float* __restrict pXi, size_t n) {
+  for(size_t k = 1; k < n; ++k) {
+    const auto ar = pZr[k], ai = pZi[k];
+    const auto br = pZr[n - k], bi = -pZi[n - k];
+    const auto er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+    const auto orr = 0.5f * (ai - bi), oi = -0.5f * (ar - br);
+    pXr[k] = er + pWr[k] * orr - pWi[k] * oi;
+    pXi[k] = ei + pWr[k] * oi + pWi[k] * orr;
+  }
+}
+
+/** The inverse of splitKernel(), for bins [1, n) and scaled by @p scale
+ *
+ * Z[k] = E[k] + i O[k], with E[k] = (X[k] + conj(X[n - k])) / 2 and
+ * O[k] = conj(W^k) (X[k] - conj(X[n - k])) / 2.
+ */
+V1_TARGET_CLONES void mergeKernel(const float* __restrict pXr, const float* __restrict pXi,
+    const float* __restrict pWr, const float* __restrict pWi, float* __restrict pZr,
+    float* __restrict pZi, size_t n, float scale) {
+  const auto halfScale = 0.5f * scale;
+  for(size_t k = 1; k < n; ++k) {
+    const auto ar = pXr[k], ai = pXi[k];
+    const auto br = pXr[n - k], bi = -pXi[n - k];
+    const auto er = halfScale * (ar + br), ei = halfScale * (ai + bi);
+    const auto dr = halfScale * (ar - br), di = halfScale * (ai - bi);
+    const auto orr = dr * pWr[k] + di * pWi[k], oi = di * pWr[k] - dr * pWi[k];
+    pZr[k] = er - oi;
+    pZi[k] = ei + orr;
+  }
+}
+
+V1_TARGET_CLONES void powerKernel(const float* __restrict pReal, const float* __restrict pImag,
+    float* __restrict pTarget, size_t count) {
+  for(size_t i = 0; i < count; ++i) pTarget[i] = pReal[i] * pReal[i] + pImag[i] * pImag[i];
+}
+
+
+/** Complex FFT of size @p n of (pRe, pIm), alternating with (pOtherRe, pOtherIm)
+ *
+ * The twiddles of all stages are concatenated in (pWr, pWi). Returns whether the result ended up
+ * in the other pair.
+ */
+bool complexFft(float* pRe, float* pIm, float* pOtherRe, float* pOtherIm, const float* pWr,
+    const float* pWi, size_t n) {
+  auto swapped = false;
+  for(size_t length = n, stride = 1; length > 1; length /= 2, stride *= 2) {
+    const auto half = length / 2;
+    if(stride == 1)
+      firstStageKernel(pRe, pIm, pOtherRe, pOtherIm, pWr, pWi, half);
+    else
+      stageKernel(pRe, pIm, pOtherRe, pOtherIm, pWr, pWi, half, stride);
+    std::swap(pRe, pOtherRe);
+    std::swap(pIm, pOtherIm);
+    swapped = !swapped;
+    pWr += half;
+    pWi += half;
+  }
+  return swapped;
+}
+}  // namespace
+
+
+RealFft::RealFft(size_t size) {
+  if(size < 2 || (size & (size - 1))) return;
+
+  mSize = size;
+  const auto n = size / 2;
+  mTwiddles.resize(4, n);
+  mScratch.resize(4, n);
+
+  // exp(-2 pi i p / length) for every stage, then exp(-2 pi i k / size)
+  size_t offset = 0;
+  for(size_t length = n; length > 1; length /= 2) {
+    for(size_t p = 0; p < length / 2; ++p, ++offset) {
+      const auto angle = -2. * kPi * double(p) / double(length);
+      mTwiddles.channel(0)[offset] = float(std::cos(angle));
+      mTwiddles.channel(1)[offset] = float(std::sin(angle));
+    }
+  }
+  for(size_t k = 0; k < n; ++k) {
+    const auto angle = -2. * kPi * double(k) / double(size);
+    mTwiddles.channel(2)[k] = float(std::cos(angle));
+    mTwiddles.channel(3)[k] = float(std::sin(angle));
+  }
+}
+
+void RealFft::forward(ArrayView<float> input, Span<float> real, Span<float> imag) {
+  V1_ASSERT(isValid());
+  V1_ASSERT(input.size() == mSize && real.size() == numBins() && imag.size() == numBins());
+  const auto n = mSize / 2;
+
+  float* ppZ[] = {mScratch.channel(0).data(), mScratch.channel(1).data(),
+      mScratch.channel(2).data(), mScratch.channel(3).data()};
+  ops::deinterleave<float>({input.data(), 2, n}, {ppZ, 2, n});
+  if(complexFft(ppZ[0], ppZ[1], ppZ[2], ppZ[3], mTwiddles.constChannel(0).data(),
+         mTwiddles.constChannel(1).data(), n)) {
+    std::swap(ppZ[0], ppZ[2]);
+    std::swap(ppZ[1], ppZ[3]);
+  }
+
+  real[0] = ppZ[0][0] + ppZ[1][0];
+  imag[0] = 0.f;
+  real[n] = ppZ[0][0] - ppZ[1][0];
+  imag[n] = 0.f;
+  splitKernel(ppZ[0], ppZ[1], mTwiddles.constChannel(2).data(), mTwiddles.constChannel(3).data(),
+      real.data(), imag.data(), n);
+}
+
+void RealFft::inverse(ArrayView<float> real, ArrayView<float> imag, Span<float> output) {
+  V1_ASSERT(isValid());
+  V1_ASSERT(real.size() == numBins() && imag.size() == numBins() && output.size() == mSize);
+  const auto n = mSize / 2;
+  const auto scale = 1.f / float(n);
+
+  float* ppZ[] = {mScratch.channel(0).data(), mScratch.channel(1).data(),
+      mScratch.channel(2).data(), mScratch.channel(3).data()};
+  ppZ[0][0] = 0.5f * scale * (real[0] + real[n]);
+  ppZ[1][0] = 0.5f * scale * (real[0] - real[n]);
+  mergeKernel(real.data(), imag.data(), mTwiddles.constChannel(2).data(),
+      mTwiddles.constChannel(3).data(), ppZ[0], ppZ[1], n, scale);
+
+  // the inverse transform is the forward one with real and imaginary parts swapped
+  if(complexFft(ppZ[1], ppZ[0], ppZ[3], ppZ[2], mTwiddles.constChannel(0).data(),
+         mTwiddles.constChannel(1).data(), n)) {
+    std::swap(ppZ[0], ppZ[2]);
+    std::swap(ppZ[1], ppZ[3]);
+  }
+  ops::interleave<float>({ppZ, 2, n}, {output.data(), 2, n});
+}
+
+void magnitude(ArrayView<float> real, ArrayView<float> imag, Span<float> target) {
+  // std::sqrt() may set errno, so it doesn't vectorize
+  power(real, imag, target);
+  for(auto& value : target) value = std::sqrt(value);
+}
+
+void power(ArrayView<float> real, ArrayView<float> imag, Span<float> target) {
+  V1_ASSERT(real.size() == imag.size() && real.size() == target.size());
+  powerKernel(real.data(), imag.data(), target.data(), target.size());
+}
+
+}  // namespace v1util::dsp
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "audioBuffer.hpp"
+
+#include "v1util/base/cpppainrelief.hpp"
+#include "v1util/base/platform.hpp"
+#include "v1util/container/array_view.hpp"
+#include "v1util/container/span.hpp"
+
+#include <cstddef>
+
+namespace v1util::dsp {
+
+/** Plan of a real-input FFT of a power-of-two size
+ *
+ * The real input is transformed as a complex sequence of half the size (even samples as real,
+ * odd samples as imaginary parts) by a radix-2 Stockham FFT, then split into the spectrum of the
+ * real input. Complex values are stored as separate arrays of real and imaginary parts, so that
+ * the butterflies are vectorized like the kernels of dsp::ops.
+ *
+ * The twiddle factors are computed once per plan, in double precision. The plan owns its scratch
+ * buffers, so one plan may not be used from several threads at the same time; copy it instead.
+ */
+class RealFft {
+ public:
+  RealFft() = default;
+  //! @p size: a power of two >= 2; otherwise, the plan is invalid
+  V1_PUBLIC explicit RealFft(size_t size);
+  V1_DEFAULT_CP_MV_MAYTHROW(RealFft)
+
+  bool isValid() const { return mSize > 0; }
+  size_t size() const { return mSize; }
+  //! The bins from DC up to the Nyquist frequency
+  size_t numBins() const { return mSize / 2 + 1; }
+
+  /** The spectrum of @p input, unscaled: X[k] = sum of input[j] * exp(-2 pi i j k / size())
+   *
+   * @p input has size() samples, @p real and @p imag numBins().
+   */
+  V1_PUBLIC void forward(ArrayView<float> input, Span<float> real, Span<float> imag);
+
+  /** The real signal of a spectrum, scaled by 1 / size(), so that it inverts forward()
+   *
+   * The imaginary parts of DC and the Nyquist frequency are ignored.
+   */
+  V1_PUBLIC void inverse(ArrayView<float> real, ArrayView<float> imag, Span<float> output);
+
+ private:
+  size_t mSize = 0;
+  AudioBuffer mTwiddles;  // per stage (real, imag), then for the real split (real, imag)
+  AudioBuffer mScratch;  // two complex sequences of mSize / 2 to alternate, as (real, imag)
+};
+
+//! target[k] = |real[k] + i imag[k]|
+V1_PUBLIC void magnitude(ArrayView<float> real, ArrayView<float> imag, Span<float> target);
+//! target[k] = |real[k] + i imag[k]|^2; has the peaks of magnitude() and skips the square roots
+V1_PUBLIC void power(ArrayView<float> real, ArrayView<float> imag, Span<float> target);
+
+}  // namespace v1util::dsp
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "sampleFormat.hpp"
+
+#include "v1util/base/cpppainrelief.hpp"
+#include "v1util/base/debug.hpp"
+#include "v1util/container/array_view.hpp"
+#include "v1util/container/span.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace v1util { namespace dsp {
+
+//! Every stride-th element, e.g. one channel of interleaved audio; non-owning
+template <typename T>
+class StridedView {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_cv_t<T>;
+    using difference_type = ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    Iterator() = default;
+    Iterator(T* pElement, ptrdiff_t stride) : mpElement(pElement), mStride(stride) {}
+
+    T& operator*() const { return *mpElement; }
+    T* operator->() const { return mpElement; }
+    T& operator[](ptrdiff_t i) const { return mpElement[i * mStride]; }
+
+    Iterator& operator++() { return mpElement += mStride, *this; }
+    Iterator& operator--() { return mpElement -= mStride, *this; }
+    Iterator operator++(int) { return {(mpElement += mStride) - mStride, mStride}; }
+    Iterator operator--(int) { return {(mpElement -= mStride) + mStride, mStride}; }
+    Iterator& operator+=(ptrdiff_t n) { return mpElement += n * mStride, *this; }
+    Iterator& operator-=(ptrdiff_t n) { return mpElement -= n * mStride, *this; }
+    Iterator operator+(ptrdiff_t n) const { return {mpElement + n * mStride, mStride}; }
+    Iterator operator-(ptrdiff_t n) const { return {mpElement - n * mStride, mStride}; }
+    friend Iterator operator+(ptrdiff_t n, const Iterator& i) { return i + n; }
+    ptrdiff_t operator-(const Iterator& o) const { return (mpElement - o.mpElement) / mStride; }
+
+    bool operator==(const Iterator& o) const { return mpElement == o.mpElement; }
+    bool operator!=(const Iterator& o) const { return mpElement != o.mpElement; }
+    bool operator<(const Iterator& o) const { return mpElement < o.mpElement; }
+    bool operator>(const Iterator& o) const { return mpElement > o.mpElement; }
+    bool operator<=(const Iterator& o) const { return mpElement <= o.mpElement; }
+    bool operator>=(const Iterator& o) const { return mpElement >= o.mpElement; }
+
+   private:
+    T* mpElement = nullptr;
+    ptrdiff_t mStride = 1;
+  };
+
+  using value_type = std::remove_cv_t<T>;
+  using iterator = Iterator;
+  using const_iterator = Iterator;
+
+  StridedView() = default;
+  StridedView(T* pFirst, size_t size, size_t stride)
+      : mpFirst(pFirst), mSize(size), mStride(stride) {
+    V1_ASSERT(stride > 0U);
+  }
+  V1_DEFAULT_CP_MV(StridedView);
+
+  T& operator[](size_t i) const {
+    V1_ASSERT(i < mSize);
+    return mpFirst[i * mStride];
+  }
+
+  Iterator begin() const { return {mpFirst, ptrdiff_t(mStride)}; }
+  Iterator end() const { return {mpFirst + mSize * mStride, ptrdiff_t(mStride)}; }
+
+  size_t size() const { return mSize; }
+  bool empty() const { return !mSize; }
+  //! In elements
+  size_t stride() const { return mStride; }
+
+ private:
+  T* mpFirst = nullptr;
+  size_t mSize = 0U;
+  size_t mStride = 1U;
+};
+
+
+//! Interleaved, non-owning block of data: all channels of a sample, then the next sample
+template <typename PSample>
+class InterleavedAudioBlockBase {
+ public:
+  using Sample = std::remove_const_t<PSample>;
+  static_assert(kIsSampleType<Sample>);
+
+  InterleavedAudioBlockBase() = default;
+  InterleavedAudioBlockBase(PSample* pSamples_, int numChannels_, size_t numSamples_)
+      : pSamples(pSamples_), numChannels(numChannels_), numSamples(numSamples_) {
+    V1_ASSERT(numChannels || (!numSamples && !pSamples));
+    V1_ASSERT(!numSamples || pSamples);
+  }
+
+  V1_DEFAULT_CP_MV(InterleavedAudioBlockBase)
+
+  StridedView<const Sample> channel(int channel) const {
+    V1_ASSERT(channel < numChannels);
+    return {pSamples + channel, numSamples, size_t(numChannels)};
+  }
+
+  //! All channels of sample @p i
+  ArrayView<Sample> frame(size_t i) const {
+    V1_ASSERT(i < numSamples);
+    return {pSamples + i * size_t(numChannels), size_t(numChannels)};
+  }
+
+  PSample* pSamples = nullptr;
+  int numChannels = 0;
+  size_t numSamples = 0;
+};
+
+//! Non-owning reference to an immutable block of interleaved audio
+template <typename Sample>
+class BasicConstInterleavedAudioBlock : public InterleavedAudioBlockBase<const Sample> {
+ public:
+  BasicConstInterleavedAudioBlock() = default;
+  BasicConstInterleavedAudioBlock(const Sample* pSamples, int numChannels, size_t numSamples)
+      : InterleavedAudioBlockBase<const Sample>(pSamples, numChannels, numSamples) {}
+
+  V1_DEFAULT_CP_MV(BasicConstInterleavedAudioBlock)
+};
+
+//! Non-owning reference to a block of interleaved audio, e.g. a device buffer
+template <typename Sample>
+class BasicInterleavedAudioBlock : public InterleavedAudioBlockBase<Sample> {
+ public:
+  BasicInterleavedAudioBlock() = default;
+  BasicInterleavedAudioBlock(Sample* pSamples, int numChannels, size_t numSamples)
+      : InterleavedAudioBlockBase<Sample>(pSamples, numChannels, numSamples) {}
+
+  V1_DEFAULT_CP_MV(BasicInterleavedAudioBlock)
+
+  // @{ getters
+  operator BasicConstInterleavedAudioBlock<Sample>() const {
+    return {this->pSamples, this->numChannels, this->numSamples};
+  }
+
+  StridedView<Sample> channel(int channel) {
+    V1_ASSERT(channel < this->numChannels);
+    return {this->pSamples + channel, this->numSamples, size_t(this->numChannels)};
+  }
+
+  Span<Sample> frame(size_t i) {
+    V1_ASSERT(i < this->numSamples);
+    return {this->pSamples + i * size_t(this->numChannels), size_t(this->numChannels)};
+  }
+  // @}
+
+  // @{ setters
+  void clear() {
+    const auto numValues = size_t(this->numChannels) * this->numSamples;
+    for(size_t i = 0; i < numValues; ++i) this->pSamples[i] = Sample(0);
+  }
+  // @}
+};
+
+using ConstInterleavedAudioBlock = BasicConstInterleavedAudioBlock<float>;
+using InterleavedAudioBlock = BasicInterleavedAudioBlock<float>;
+
+}}  // namespace v1util::dsp
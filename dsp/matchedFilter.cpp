@@ -0,0 +1,119 @@
+#include "matchedFilter.hpp"
+
+#include "v1util/base/debug.hpp"
+#include "v1util/base/thread_pool.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+
+namespace v1util::dsp {
+
+namespace {
+// kernels; free functions, because compilers only trust __restrict on parameters
+
+//! (pRe, pIm) *= (pOtherRe, pOtherIm), complex
+V1_TARGET_CLONES void complexMultiplyKernel(float* __restrict pRe, float* __restrict pIm,
+    const float* __restrict pOtherRe, const float* __restrict pOtherIm, size_t count) {
+  for(size_t k = 0; k < count; ++k) {
+    const auto re = pRe[k], im = pIm[k];
+    pRe[k] = re * pOtherRe[k] - im * pOtherIm[k];
+    pIm[k] = re * pOtherIm[k] + im * pOtherRe[k];
+  }
+}
+}  // namespace
+
+
+MatchedFilter::MatchedFilter(int numChannels, ArrayView<float> templateSignal, size_t fftSize) {
+  const auto templateSize = templateSignal.size();
+  if(!fftSize) {
+    fftSize = 2;
+    while(fftSize < 2 * templateSize) fftSize *= 2;
+  }
+  Worker worker;
+  worker.fft = RealFft(fftSize);
+  if(numChannels <= 0 || !templateSize || !worker.fft.isValid() || fftSize < templateSize) return;
+
+  mNumChannels = numChannels;
+  mTemplateSize = templateSize;
+  mHopSize = fftSize - templateSize + 1;
+
+  // the correlation is the convolution with the time-reversed template, or, circularly, the
+  // product with the conjugate spectrum
+  const auto numBins = worker.fft.numBins();
+  worker.spectrum.resize(2, numBins);
+  worker.frame.resize(1, fftSize);
+  worker.frame.clear();
+  auto frame = worker.frame.channel(0);
+  std::copy(templateSignal.begin(), templateSignal.end(), frame.begin());
+  mTemplateSpectrum.resize(2, numBins);
+  worker.fft.forward(frame, mTemplateSpectrum.channel(0), mTemplateSpectrum.channel(1));
+  for(auto& imag : mTemplateSpectrum.channel(1)) imag = -imag;
+
+  mTemplateEnergy = 0.;
+  for(const auto sample : templateSignal) mTemplateEnergy += double(sample) * double(sample);
+
+  mWorkers.push_back(std::move(worker));
+  mInput.resize(numChannels, fftSize);
+  mCorrelation.resize(numChannels, mHopSize);
+  reset();
+}
+
+void MatchedFilter::process(ConstAudioBlock input, AudioBlock output, ThreadPool* pPool) {
+  V1_ASSERT(isValid() && input.numChannels == mNumChannels);
+  V1_ASSERT(output.numChannels == mNumChannels && output.numSamples == input.numSamples);
+
+  const auto newSamplesOffset = fftSize() - mHopSize;
+  for(size_t pos = 0; pos < input.numSamples;) {
+    const auto count = std::min(mHopSize - mHopFill, input.numSamples - pos);
+    for(int chan = 0; chan < mNumChannels; ++chan) {
+      std::memcpy(mInput.channel(chan).data() + newSamplesOffset + mHopFill,
+          input.ppBuffer[chan] + pos, count * sizeof(float));
+      std::memcpy(output.ppBuffer[chan] + pos, mCorrelation.constChannel(chan).data() + mHopFill,
+          count * sizeof(float));
+    }
+    mHopFill += count;
+    pos += count;
+
+    if(mHopFill == mHopSize) {
+      correlateHop(pPool);
+      mHopFill = 0;
+    }
+  }
+}
+
+void MatchedFilter::reset() {
+  mInput.clear();
+  mCorrelation.clear();
+  mHopFill = 0;
+}
+
+void MatchedFilter::correlateHop(ThreadPool* pPool) {
+  if(pPool && mNumChannels > 1) {
+    const auto numWorkers = std::min(size_t(pPool->concurrency()), size_t(mNumChannels));
+    if(mWorkers.size() < numWorkers) mWorkers.resize(numWorkers, mWorkers.front());
+    pPool->parallelFor(numWorkers, [&](size_t iWorker) {
+      for(auto chan = int(iWorker); chan < mNumChannels; chan += int(numWorkers))
+        correlateChannel(mWorkers[iWorker], chan);
+    });
+  } else {
+    for(int chan = 0; chan < mNumChannels; ++chan) correlateChannel(mWorkers.front(), chan);
+  }
+}
+
+void MatchedFilter::correlateChannel(Worker& worker, int chan) {
+  auto real = worker.spectrum.channel(0), imag = worker.spectrum.channel(1);
+  const auto frame = worker.frame.channel(0);
+  auto pInput = mInput.channel(chan).data();
+  worker.fft.forward(mInput.constChannel(chan), real, imag);
+  complexMultiplyKernel(real.data(), imag.data(), mTemplateSpectrum.constChannel(0).data(),
+      mTemplateSpectrum.constChannel(1).data(), real.size());
+  worker.fft.inverse(real, imag, frame);
+
+  // the first hopSize outputs don't wrap around
+  std::memcpy(mCorrelation.channel(chan).data(), frame.data(), mHopSize * sizeof(float));
+  std::memmove(pInput, pInput + mHopSize, (frame.size() - mHopSize) * sizeof(float));
+}
+
+}  // namespace v1util::dsp
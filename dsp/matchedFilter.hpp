@@ -0,0 +1,91 @@
+#pragma once
+
+#include "audioBlock.hpp"
+#include "audioBuffer.hpp"
+#include "fft.hpp"
+
+#include "v1util/base/cpppainrelief.hpp"
+#include "v1util/base/platform.hpp"
+#include "v1util/container/array_view.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace v1util {
+class ThreadPool;
+}
+
+namespace v1util::dsp {
+
+/** Streaming cross-correlation of non-interleaved audio with a template, e.g. a chirp
+ *
+ * Output sample p is sum of input[p - latency() + k] * template[k], so it is largest where the
+ * template starts latency() samples earlier; feed it to a StreamingPeakFinder with a pattern size
+ * of about twice the template size and subtract latency() from the positions of its peaks to get
+ * arrival times. A peak of templateEnergy() is a perfect match at unit gain.
+ *
+ * The correlation is computed by overlap-save: every hopSize() = fftSize - templateSize + 1 input
+ * samples, the last fftSize samples of each channel are transformed by a RealFft, multiplied by
+ * the conjugate spectrum of the template and transformed back, which yields hopSize() valid
+ * outputs. They are written out during the next hop, so the output is delayed by fftSize samples,
+ * as that of Stft. That costs O(log fftSize) per sample instead of the O(templateSize) of a
+ * direct correlation.
+ *
+ * Blocks may have any size; the output doesn't depend on it.
+ */
+class MatchedFilter {
+ public:
+  MatchedFilter() = default;
+  /** @p fftSize: a power of two >= the template size; 0 for the smallest >= twice of it
+   *
+   * Larger FFTs tend to cost less per sample, since more of each is valid output, but add latency.
+   */
+  V1_PUBLIC MatchedFilter(int numChannels, ArrayView<float> templateSignal, size_t fftSize = 0);
+  V1_DEFAULT_CP_MV_MAYTHROW(MatchedFilter)
+
+  bool isValid() const { return mNumChannels > 0; }
+  int numChannels() const { return mNumChannels; }
+  size_t templateSize() const { return mTemplateSize; }
+  size_t fftSize() const { return mWorkers.empty() ? 0 : mWorkers.front().fft.size(); }
+  size_t hopSize() const { return mHopSize; }
+  //! Of the output of process(), in samples
+  size_t latency() const { return fftSize(); }
+  //! The correlation of the template with itself, the sum of its squares
+  double templateEnergy() const { return mTemplateEnergy; }
+
+  /** Write the correlation of @p input to @p output, which has input.numSamples samples
+   *
+   * With a @p pPool, channels are processed in parallel; the first call with a pool allocates
+   * FFT plans for its threads.
+   */
+  V1_PUBLIC void process(ConstAudioBlock input, AudioBlock output, ThreadPool* pPool = nullptr);
+
+  //! Forget all input, as after construction
+  V1_PUBLIC void reset();
+
+ private:
+  //! A plan and its buffers, one per thread
+  struct Worker {
+    RealFft fft;
+    AudioBuffer spectrum;  // real, imag
+    AudioBuffer frame;
+  };
+
+  //! The correlations of the current hop of all channels, from mInput into mCorrelation
+  V1_PUBLIC void correlateHop(ThreadPool* pPool);
+  V1_PUBLIC void correlateChannel(Worker& worker, int chan);
+
+  int mNumChannels = 0;
+  size_t mTemplateSize = 0;
+  size_t mHopSize = 0;
+  double mTemplateEnergy = 0.;
+  AudioBuffer mTemplateSpectrum;  // real, imag of its conjugate
+  std::vector<Worker> mWorkers;  // at least one
+
+  // per stream:
+  AudioBuffer mInput;  // the last fftSize samples
+  AudioBuffer mCorrelation;  // of the last hop, hopSize samples
+  size_t mHopFill = 0;  // input samples of the current hop
+};
+
+}  // namespace v1util::dsp
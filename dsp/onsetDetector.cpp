@@ -0,0 +1,103 @@
+#include "onsetDetector.hpp"
+
+#include <cmath>
+
+
+namespace v1util::dsp {
+
+OnsetDetector::OnsetDetector(int numChannels, size_t patternSize, size_t thresholdWindowSize) {
+  if(numChannels <= 0 || patternSize < 3 || !thresholdWindowSize) return;
+
+  mPatternSize = patternSize;
+  const auto historySize = std::max(size_t(1), thresholdWindowSize / kQuantileStride);
+  mChannels.resize(size_t(numChannels));
+  // the peak finder reports peaks up to about 1.5 patternSize samples late
+  const auto numThresholds = (2 * patternSize + kTileSize - 1) / kTileSize + 1;
+  for(auto& channel : mChannels) {
+    channel.history.resize(historySize);
+    channel.sortedHistory.reserve(historySize);
+    channel.thresholds.resize(numThresholds);
+  }
+  mTile.resize(1, kTileSize);
+  setAttackRelease(0., double(patternSize / 2));
+  reset();
+}
+
+void OnsetDetector::setAttackRelease(double attackSamples, double releaseSamples) {
+  const auto share = [](double samples) {
+    return samples > 0. ? float(std::exp(-1. / samples)) : 0.f;
+  };
+  mAttack = share(attackSamples);
+  mRelease = share(releaseSamples);
+}
+
+void OnsetDetector::setThreshold(double quantile, float scale, float offset) {
+  V1_ASSERT(quantile >= 0. && quantile <= 1. && scale >= 0.f);
+  mQuantile = quantile;
+  mScale = scale;
+  mOffset = offset;
+  for(auto& channel : mChannels) updateThreshold(channel);
+}
+
+void OnsetDetector::reset() {
+  mStreamPos = 0;
+  for(auto& channel : mChannels) {
+    channel.peakFinder = StreamingPeakFinder<float>(mPatternSize);
+    channel.envelope = 0.f;
+    channel.sortedHistory.clear();
+    channel.historyPos = 0;
+    updateThreshold(channel);
+  }
+}
+
+void OnsetDetector::followEnvelope(
+    Channel& channel, const float* pInput, size_t count, float* pTile) const {
+  auto envelope = channel.envelope;
+  for(size_t i = 0; i < count; ++i) {
+    const auto rectified = std::abs(pInput[i]);
+    const auto share = rectified > envelope ? mAttack : mRelease;
+    envelope = rectified + share * (envelope - rectified);
+    pTile[i] = envelope;
+  }
+  channel.envelope = envelope;
+}
+
+void OnsetDetector::rememberEnvelope(Channel& channel, const float* pTile, size_t count) const {
+  auto& history = channel.history;
+  auto& sorted = channel.sortedHistory;
+  for(auto i = (kQuantileStride - mStreamPos % kQuantileStride) % kQuantileStride; i < count;
+      i += kQuantileStride) {
+    const auto value = pTile[i];
+    if(sorted.size() < history.size())
+      sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), value), value);
+    else {
+      // replace the oldest value, moving only the values in between
+      const auto iOld = std::lower_bound(sorted.begin(), sorted.end(), history[channel.historyPos]);
+      const auto iNew = std::lower_bound(sorted.begin(), sorted.end(), value);
+      if(iNew <= iOld) {
+        std::move_backward(iNew, iOld, iOld + 1);
+        *iNew = value;
+      } else {
+        std::move(iOld + 1, iNew, iOld);
+        *(iNew - 1) = value;
+      }
+    }
+
+    history[channel.historyPos] = value;
+    if(++channel.historyPos == history.size()) channel.historyPos = 0;
+  }
+}
+
+void OnsetDetector::updateThreshold(Channel& channel) {
+  auto& threshold = channel.thresholds[mStreamPos / kTileSize % channel.thresholds.size()];
+  const auto& sorted = channel.sortedHistory;
+  if(sorted.empty()) {
+    threshold = mOffset;
+    return;
+  }
+
+  const auto iQuantile = size_t(std::lround(mQuantile * double(sorted.size() - 1)));
+  threshold = mScale * sorted[iQuantile] + mOffset;
+}
+
+}  // namespace v1util::dsp
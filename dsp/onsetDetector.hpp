@@ -0,0 +1,123 @@
+#pragma once
+
+#include "audioBlock.hpp"
+#include "audioBuffer.hpp"
+#include "peakfinder.hpp"
+
+#include "v1util/base/cpppainrelief.hpp"
+#include "v1util/base/debug.hpp"
+#include "v1util/base/platform.hpp"
+#include "v1util/container/array_view.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace v1util::dsp {
+
+/** Onsets of many channels: peaks of their envelopes that exceed an adaptive threshold
+ *
+ * Per channel, the input is rectified and smoothed by a one-pole attack/release follower, and the
+ * envelope is run through a StreamingPeakFinder. Both happen tile by tile: the envelope of
+ * kTileSize samples is computed into a buffer that stays in the L1 cache and is consumed by the
+ * peak finder right away, so the envelope of a block is never stored.
+ *
+ * Instead of a fixed threshold, a peak must reach scale * q + offset, where q is a quantile (the
+ * median by default) of the envelope over the last thresholdWindowSize samples. The envelope is
+ * taken at every kQuantileStride-th sample and kept sorted: a new value costs a binary search and a
+ * short move, the quantile is a lookup. The threshold is updated after every tile, from the
+ * envelope before it, and peaks are compared to the threshold of their tile when the finder
+ * reports them: the finder itself only yields the same peaks for any block sizes if its threshold
+ * is fixed, so it just gets the offset, which still spares it the raw peaks of silence. Tiles are
+ * aligned to the stream position, so the onsets don't depend on the block sizes.
+ */
+class OnsetDetector {
+ public:
+  static constexpr const size_t kTileSize = 256;
+  static constexpr const size_t kQuantileStride = 64;
+
+  OnsetDetector() = default;
+  /** @p patternSize: of the peak finder, onsets are at least patternSize / 2 samples apart
+   *
+   * The envelope has an attack of 0 and a release of patternSize / 2 samples; the threshold is
+   * twice the median plus 1e-3.
+   */
+  V1_PUBLIC OnsetDetector(int numChannels, size_t patternSize, size_t thresholdWindowSize);
+  V1_NO_CP_DEFAULT_MV(OnsetDetector)
+
+  bool isValid() const { return !mChannels.empty(); }
+  int numChannels() const { return int(mChannels.size()); }
+
+  //! Time constants of the envelope follower, in samples; 0 follows immediately
+  V1_PUBLIC void setAttackRelease(double attackSamples, double releaseSamples);
+  //! The threshold becomes @p scale * (the @p quantile of the envelope) + @p offset; @p scale >= 0
+  V1_PUBLIC void setThreshold(double quantile, float scale, float offset);
+
+  //! The threshold for the current tile of @p channel
+  float threshold(int channel) const {
+    const auto& thresholds = mChannels[size_t(channel)].thresholds;
+    return thresholds[mStreamPos / kTileSize % thresholds.size()];
+  }
+
+  /** Call @p onsetHandler(int channel, const PeakFinderValueAtPos<float>&) for every onset
+   *
+   * Stream positions count the samples since construction or reset(). Onsets are reported with the
+   * latency of the peak finder, about patternSize / 2 samples.
+   */
+  template <typename Invokable>
+  void process(ConstAudioBlock input, Invokable&& onsetHandler) {
+    V1_ASSERT(isValid() && input.numChannels == numChannels());
+    const auto pTile = mTile.channel(0).data();
+    for(size_t pos = 0; pos < input.numSamples;) {
+      const auto count = std::min(kTileSize - mStreamPos % kTileSize, input.numSamples - pos);
+      for(int chan = 0; chan < numChannels(); ++chan) {
+        auto& channel = mChannels[size_t(chan)];
+        followEnvelope(channel, input.ppBuffer[chan] + pos, count, pTile);
+        const auto& thresholds = channel.thresholds;
+        channel.peakFinder.process(ArrayView<float>(pTile, count), mStreamPos, mOffset,
+            [&](const PeakFinderValueAtPos<float>& peak) {
+              if(peak.value >= thresholds[peak.streamPos / kTileSize % thresholds.size()])
+                onsetHandler(chan, peak);
+            });
+        rememberEnvelope(channel, pTile, count);
+      }
+
+      mStreamPos += count;
+      pos += count;
+      if(mStreamPos % kTileSize == 0)
+        for(auto& channel : mChannels) updateThreshold(channel);
+    }
+  }
+
+  //! Forget all input, as after construction
+  V1_PUBLIC void reset();
+
+ private:
+  struct Channel {
+    StreamingPeakFinder<float> peakFinder;
+    float envelope = 0.f;
+    std::vector<float> thresholds;  // of the tiles the peak finder may report peaks in, a ring
+    std::vector<float> history;  // every kQuantileStride-th envelope sample, a ring
+    std::vector<float> sortedHistory;  // the same, sorted
+    size_t historyPos = 0;
+  };
+
+  //! The envelope of @p count samples of @p pInput into @p pTile
+  V1_PUBLIC void followEnvelope(
+      Channel& channel, const float* pInput, size_t count, float* pTile) const;
+  V1_PUBLIC void rememberEnvelope(Channel& channel, const float* pTile, size_t count) const;
+  //! From the envelope so far, for the tile at mStreamPos
+  V1_PUBLIC void updateThreshold(Channel& channel);
+
+  size_t mPatternSize = 0;
+  float mAttack = 0.f, mRelease = 0.f;  // the share of the old envelope per sample
+  double mQuantile = 0.5;
+  float mScale = 2.f, mOffset = 1e-3f;
+
+  // per stream:
+  std::vector<Channel> mChannels;
+  AudioBuffer mTile;  // the envelope of kTileSize samples of one channel
+  size_t mStreamPos = 0;
+};
+
+}  // namespace v1util::dsp
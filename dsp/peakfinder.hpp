@@ -7,6 +7,8 @@
 #include "v1util/container/ringbuffer.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <iterator>
 #include <limits>
 
 namespace v1util::dsp {
@@ -471,9 +473,24 @@ class StreamingPeakFinder {
 
   void reconfigure(size_t patternSize) { *this = StreamingPeakFinder(patternSize); }
 
+  size_t patternSize() const { return 2 * mLockoutDistance + 1; }
+  size_t lockoutDistance() const { return mLockoutDistance; }
+
   template <typename View, typename Invokable>
   void process(const View& data, size_t streamPosAtStartOfData, Value peakThreshold,
       Invokable&& handlePeak) {
+    process(data, streamPosAtStartOfData, peakThreshold, handlePeak,
+        [](const PeakFinderRawPeak<Value>&) {});
+  }
+
+  /** As above, and call @p handleRawPeak(const PeakFinderRawPeak<Value>&) for every raw peak
+   *
+   * It's called after the raw peak went into the peak isolator, so after all peaks that are
+   * dominant up until the raw peak were handled.
+   */
+  template <typename View, typename Invokable, typename RawInvokable>
+  void process(const View& data, size_t streamPosAtStartOfData, Value peakThreshold,
+      Invokable&& handlePeak, RawInvokable&& handleRawPeak) {
     auto newStreamPos = streamPosAtStartOfData + data.size();
 
     if(!mIsSubsequentBlock) {
@@ -486,6 +503,7 @@ class StreamingPeakFinder {
           // Check for maximum peak detector delay + blockSize because peaks don't align with blocks
           V1_ASSERT(newStreamPos - rawPeak.streamPos <= ((patternSize() - 2) + 1) + data.size());
           mDominantPeakIsolator.onRawPeakEvent(rawPeak, handlePeak);
+          handleRawPeak(rawPeak);
         });
 
     /*
@@ -503,7 +521,6 @@ class StreamingPeakFinder {
   }
 
  private:
-  size_t patternSize() const { return 2 * mLockoutDistance + 1; }
   size_t maxPlateauLength() const { return patternSize() - 2; }
 
   // const:
@@ -516,4 +533,197 @@ class StreamingPeakFinder {
   size_t mStreamPos = 0U;
 };
 
+
+enum class PeakInterpolation : int {
+  kParabolic,  //!< a parabola through the peak and its neighbours
+  kGaussian  //!< a parabola through their logarithms; exact for Gaussian peaks, needs values > 0
+};
+
+//! Sub-sample offset of a peak from its sample, in [-0.5, 0.5], and the height of the peak
+struct InterpolatedPeak {
+  double offset = 0.;
+  double height = 0.;
+};
+
+/** Interpolate the peak at @p centre from its neighbours @p left and @p right
+ *
+ * @p centre must not be smaller than its neighbours. Gaussian interpolation falls back to the
+ * parabola for values <= 0. The middle of a plateau of three or more samples stays where it is.
+ */
+inline InterpolatedPeak interpolatePeak(
+    double left, double centre, double right, PeakInterpolation interpolation) {
+  const auto isGaussian =
+      interpolation == PeakInterpolation::kGaussian && left > 0. && centre > 0. && right > 0.;
+  if(isGaussian) {
+    left = std::log(left);
+    centre = std::log(centre);
+    right = std::log(right);
+  }
+
+  const auto curvature = left - 2. * centre + right;
+  InterpolatedPeak result;
+  result.offset = curvature < 0. ? 0.5 * (left - right) / curvature : 0.;
+  result.height = centre - 0.25 * (left - right) * result.offset;
+  if(isGaussian) result.height = std::exp(result.height);
+  return result;
+}
+
+/** The largest value of @p samples[2] and the signal between @p samples[1] and @p samples[3], 4x
+ * oversampled
+ *
+ * Oversamples with cubic (Catmull-Rom) interpolation of the 5 consecutive @p samples, a cheap
+ * stand-in for the polyphase FIR of ITU-R BS.1770. A sine at a quarter of the sample rate
+ * sampled 45 degrees off its crests comes out at 0.88 of its amplitude, instead of 0.71.
+ */
+inline double truePeak4x(const double (&samples)[5]) {
+  auto result = samples[2];
+  for(size_t i = 1; i < 3; ++i) {
+    const auto y0 = samples[i - 1], y1 = samples[i], y2 = samples[i + 1], y3 = samples[i + 2];
+    const auto c1 = 0.5 * (y2 - y0);
+    const auto c2 = y0 - 2.5 * y1 + 2. * y2 - 0.5 * y3;
+    const auto c3 = 1.5 * (y1 - y2) + 0.5 * (y3 - y0);
+    for(double t : {0.25, 0.5, 0.75}) result = std::max(result, y1 + t * (c1 + t * (c2 + t * c3)));
+  }
+  return result;
+}
+
+
+//! A peak of SubSamplePeakFinder, with sub-sample estimates
+template <typename Value>
+struct PeakFinderSubSamplePeak : public PeakFinderValueAtPos<Value> {
+  double position = 0.;  //!< streamPos plus the interpolated offset
+  double height = 0.;  //!< of the interpolated peak
+  double truePeak = 0.;  //!< see truePeak4x(); just value if not enabled
+};
+
+/** StreamingPeakFinder that interpolates the position and height of its peaks between samples
+ *
+ * The samples around a peak are taken from the data when the peak detector finds the raw peak,
+ * before the isolator decides whether it's dominant; only the last 4 samples of a block are
+ * remembered for the next. So there is no separate history to read again.
+ *
+ * The interpolation needs the samples next to a peak, which the detector has seen anyway, so the
+ * latency is that of StreamingPeakFinder. The optional true peak needs 2 samples after a peak;
+ * only with a pattern size of 3 can that delay a peak by one sample, until the next process().
+ */
+template <typename Value>
+class SubSamplePeakFinder {
+  static constexpr const size_t kTailSize = 4;
+
+ public:
+  SubSamplePeakFinder() = default;
+  SubSamplePeakFinder(size_t patternSize,
+      PeakInterpolation interpolation = PeakInterpolation::kParabolic, bool withTruePeak = false)
+      : mPeakFinder(patternSize), mInterpolation(interpolation), mWithTruePeak(withTruePeak) {
+    // raw peaks are at least 2 samples apart, the unhandled ones less than lockoutDistance old
+    mNeighbourhoods.setCapacity(mPeakFinder.lockoutDistance() / 2 + 2);
+  }
+  V1_DEFAULT_CP_MV(SubSamplePeakFinder);
+
+  /** Process a block of data like StreamingPeakFinder::process()
+   *
+   * @p handlePeak(const PeakFinderSubSamplePeak<Value>&) is called for every peak.
+   */
+  template <typename View, typename Invokable>
+  void process(const View& data, size_t streamPosAtStartOfData, Value peakThreshold,
+      Invokable&& handlePeak) {
+    if(data.size() <= 0) return;
+
+    const auto iData = data.begin();
+    const auto dataSize = size_t(data.size());
+    if(!mIsSubsequentBlock) {
+      mIsSubsequentBlock = true;
+      std::fill(std::begin(mTail), std::end(mTail), *iData);  // repeat the first sample
+    }
+
+    // [streamPosAtStartOfData - kTailSize, streamPosAtStartOfData + dataSize)
+    const auto valueAt = [&](size_t streamPos) {
+      return streamPos - streamPosAtStartOfData < dataSize
+                 ? double(*(iData + ptrdiff_t(streamPos - streamPosAtStartOfData)))
+                 : double(mTail[streamPos + kTailSize - streamPosAtStartOfData]);
+    };
+
+    // complete the samples after a peak at the end of the last block, and handle it if it's due
+    if(!mNeighbourhoods.empty() && !mNeighbourhoods.back().isComplete) {
+      auto& neighbourhood = mNeighbourhoods.back();
+      neighbourhood.values[4] = valueAt(neighbourhood.streamPos + 2);
+      neighbourhood.isComplete = true;
+    }
+    if(mHasDuePeak) {
+      mHasDuePeak = false;
+      handlePeak(subSamplePeak(mNeighbourhoods.front()));
+      mNeighbourhoods.pop_front();
+    }
+
+    mPeakFinder.process(
+        data, streamPosAtStartOfData, peakThreshold,
+        [&](const PeakFinderValueAtPos<Value>& peak) {
+          while(mNeighbourhoods.front().streamPos != peak.streamPos) mNeighbourhoods.pop_front();
+          if(mNeighbourhoods.front().isComplete) {
+            handlePeak(subSamplePeak(mNeighbourhoods.front()));
+            mNeighbourhoods.pop_front();
+          } else
+            mHasDuePeak = true;
+        },
+        [&](const PeakFinderRawPeak<Value>& rawPeak) {
+          if(rawPeak.type != PeakType::kPeak) return;
+
+          // all raw peaks older than lockoutDistance have been handled or dominated
+          while(!mNeighbourhoods.empty()
+                && rawPeak.streamPos - mNeighbourhoods.front().streamPos
+                       >= mPeakFinder.lockoutDistance())
+            mNeighbourhoods.pop_front();
+
+          Neighbourhood neighbourhood;
+          neighbourhood.streamPos = rawPeak.streamPos;
+          neighbourhood.value = rawPeak.value;
+          // the samples before the middle of a long plateau may be gone, but they are flat anyway
+          const auto lastPos = streamPosAtStartOfData + dataSize - 1;
+          for(size_t i = 0; i < 5; ++i) {
+            const auto streamPos = rawPeak.streamPos + i - 2;
+            const auto isAvailable = ringGreaterEq(streamPos + kTailSize, streamPosAtStartOfData)
+                                     && ringGreaterEq(lastPos, streamPos);
+            neighbourhood.values[i] = isAvailable ? valueAt(streamPos) : double(rawPeak.value);
+          }
+          neighbourhood.isComplete =
+              !mWithTruePeak || ringGreaterEq(lastPos, rawPeak.streamPos + 2);
+          mNeighbourhoods.push_back(neighbourhood);
+        });
+
+    for(size_t i = 0; i < kTailSize; ++i)
+      mTail[i] = Value(valueAt(streamPosAtStartOfData + dataSize - kTailSize + i));
+  }
+
+ private:
+  struct Neighbourhood {
+    size_t streamPos;
+    Value value;
+    double values[5];  // from streamPos - 2 to streamPos + 2
+    bool isComplete;
+  };
+
+  PeakFinderSubSamplePeak<Value> subSamplePeak(const Neighbourhood& neighbourhood) const {
+    const auto& values = neighbourhood.values;
+    const auto interpolated = interpolatePeak(values[1], values[2], values[3], mInterpolation);
+    PeakFinderSubSamplePeak<Value> result;
+    result.streamPos = neighbourhood.streamPos;
+    result.value = neighbourhood.value;
+    result.position = double(neighbourhood.streamPos) + interpolated.offset;
+    result.height = interpolated.height;
+    result.truePeak = mWithTruePeak ? truePeak4x(values) : double(neighbourhood.value);
+    return result;
+  }
+
+  // const:
+  StreamingPeakFinder<Value> mPeakFinder;
+  PeakInterpolation mInterpolation = PeakInterpolation::kParabolic;
+  bool mWithTruePeak = false;
+
+  // non-const:
+  bool mIsSubsequentBlock = false;
+  bool mHasDuePeak = false;  // the oldest neighbourhood, waiting for its last sample
+  Value mTail[kTailSize] = {};  // the last samples of the previous block
+  FixedSizeDeque<Neighbourhood> mNeighbourhoods;  // of raw peaks that may become dominant
+};
+
 }  // namespace v1util::dsp
@@ -0,0 +1,171 @@
+#include "resampler.hpp"
+
+#include "v1util/base/debug.hpp"
+#include "v1util/base/math.hpp"
+#include "v1util/base/thread_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+
+namespace v1util::dsp {
+
+namespace {
+//! Stopband attenuation of the filters, in dB
+constexpr const double kAttenuationDb = 90.;
+
+//! The zeroth order modified Bessel function of the first kind, for the Kaiser window
+double besselI0(double x) {
+  double sum = 1., term = 1.;
+  const auto quarterX2 = x * x / 4.;
+  for(int k = 1; term > 1e-17 * sum; ++k) {
+    term *= quarterX2 / (double(k) * double(k));
+    sum += term;
+  }
+  return sum;
+}
+
+
+// kernels; free functions, because compilers only trust __restrict on parameters
+
+V1_TARGET_CLONES float dotProductKernel(
+    const float* __restrict pA, const float* __restrict pB, size_t count) {
+  constexpr const size_t kLanes = 8;
+  float sums[kLanes] = {};
+  for(size_t i = 0; i < count; i += kLanes) {
+    for(size_t lane = 0; lane < kLanes; ++lane) sums[lane] += pA[i + lane] * pB[i + lane];
+  }
+  return ((sums[0] + sums[1]) + (sums[2] + sums[3])) + ((sums[4] + sums[5]) + (sums[6] + sums[7]));
+}
+}  // namespace
+
+
+Resampler::Resampler(double inputRate, double outputRate, int numChannels, size_t tapsPerPhase) {
+  const auto inputHz = std::llround(inputRate);
+  const auto outputHz = std::llround(outputRate);
+  if(inputHz <= 0 || outputHz <= 0 || numChannels <= 0 || !tapsPerPhase) return;
+
+  mInputRate = uint64_t(inputHz);
+  mOutputRate = uint64_t(outputHz);
+  const auto divisor = std::gcd(mInputRate, mOutputRate);
+  mUp = mOutputRate / divisor;
+  mDown = mInputRate / divisor;
+  mNumChannels = numChannels;
+
+  // at the input rate, tapsPerPhase samples of the lower rate
+  const auto ratio = std::max(1., double(mDown) / double(mUp));
+  mNumTaps = (size_t(std::ceil(double(tapsPerPhase) * ratio)) + 7) / 8 * 8;
+  mNumPhases = size_t(std::min<uint64_t>(mUp, kMaxPhases));
+
+  // transition band of a Kaiser window design, in cycles per sample of the lower rate
+  const auto transition = (kAttenuationDb - 7.95) / (2.285 * 2. * kPi * double(tapsPerPhase));
+  // per input sample; for equal rates, the Nyquist frequency makes the filter a unit impulse
+  const auto cutoff = mUp == mDown ? 0.5 : std::max(0.05, 0.5 - transition / 2.) / ratio;
+  const auto beta = 0.1102 * (kAttenuationDb - 8.7);
+  const auto i0Beta = besselI0(beta);
+  const auto halfLength = double(mNumTaps / 2);
+
+  mFilters.resize((mNumPhases + 1) * mNumTaps);
+  std::vector<double> row(mNumTaps);
+  for(size_t iRow = 0; iRow <= mNumPhases; ++iRow) {
+    const auto fraction = double(iRow) / double(mNumPhases);
+    auto sum = 0.;
+    for(size_t i = 0; i < mNumTaps; ++i) {
+      const auto x = halfLength - 1. + fraction - double(i);
+      const auto u = x / halfLength;
+      const auto window = besselI0(beta * std::sqrt(std::max(0., 1. - u * u))) / i0Beta;
+      const auto arg = 2. * kPi * cutoff * x;
+      const auto sinc = x == 0. ? 1. : std::sin(arg) / arg;
+      row[i] = window * sinc;
+      sum += row[i];
+    }
+    // unity gain at DC for every phase
+    for(size_t i = 0; i < mNumTaps; ++i) mFilters[iRow * mNumTaps + i] = float(row[i] / sum);
+  }
+
+  reset();
+}
+
+size_t Resampler::process(ConstAudioBlock input, AudioBlock output, ThreadPool* pPool) {
+  V1_ASSERT(isValid());
+  V1_ASSERT(input.numChannels == mNumChannels && output.numChannels == mNumChannels);
+
+  // append the input to the history
+  const auto length = mHistoryLength + input.numSamples;
+  if(length > mHistory.numSamples()) {
+    AudioBuffer grown(mHistory.pool());
+    grown.resize(mNumChannels, std::max(length, 2 * mHistory.numSamples()));
+    for(int chan = 0; chan < mNumChannels; ++chan)
+      std::memcpy(grown.channel(chan).data(), mHistory.constChannel(chan).data(),
+          mHistoryLength * sizeof(float));
+    mHistory = std::move(grown);
+  }
+  for(int chan = 0; chan < mNumChannels; ++chan)
+    std::memcpy(mHistory.channel(chan).data() + mHistoryLength, input.channel(chan).data(),
+        input.numSamples * sizeof(float));
+  mHistoryLength = length;
+  V1_ASSERT(mHistoryLength <= size_t(UINT32_MAX));
+
+  // all outputs whose filter lies within the history
+  mSteps.clear();
+  uint64_t start = 0;
+  while(start + mNumTaps <= mHistoryLength) {
+    if(mNumPhases == mUp)
+      mSteps.push_back({uint32_t(start), uint32_t(mPhase), 0.f});
+    else {
+      const auto position = mPhase * mNumPhases;
+      mSteps.push_back({uint32_t(start), uint32_t(position / mUp),
+          float(double(position % mUp) / double(mUp))});
+    }
+    mPhase += mDown;
+    start += mPhase / mUp;
+    mPhase %= mUp;
+  }
+  const auto numOutputs = mSteps.size();
+  V1_ASSERT(numOutputs <= output.numSamples);
+
+  if(pPool && mNumChannels > 1)
+    pPool->parallelFor(size_t(mNumChannels), [&](size_t chan) {
+      processChannel(int(chan), output.channel(int(chan)).subspan(0, numOutputs));
+    });
+  else {
+    for(int chan = 0; chan < mNumChannels; ++chan)
+      processChannel(chan, output.channel(chan).subspan(0, numOutputs));
+  }
+
+  // keep what later outputs need
+  const auto consumed = std::min<uint64_t>(start, mHistoryLength);
+  mHistoryLength -= size_t(consumed);
+  for(int chan = 0; chan < mNumChannels; ++chan) {
+    auto pChannel = mHistory.channel(chan).data();
+    std::memmove(pChannel, pChannel + consumed, mHistoryLength * sizeof(float));
+  }
+  return numOutputs;
+}
+
+void Resampler::reset() {
+  if(!isValid()) return;
+
+  // zeros before the first input, so that output 0 is at its time
+  mHistoryLength = mNumTaps / 2 - 1;
+  mHistory.resize(mNumChannels, std::max<size_t>(mHistory.numSamples(), 2 * mNumTaps));
+  mPhase = 0;
+  mSteps.clear();
+}
+
+void Resampler::processChannel(int chan, Span<float> output) const {
+  const auto pHistory = mHistory.constChannel(chan).data();
+  for(size_t i = 0; i < output.size(); ++i) {
+    const auto& step = mSteps[i];
+    const auto pSamples = pHistory + step.start;
+    const auto pRow = mFilters.data() + size_t(step.row) * mNumTaps;
+    auto sample = dotProductKernel(pSamples, pRow, mNumTaps);
+    if(step.weight != 0.f)
+      sample += step.weight * (dotProductKernel(pSamples, pRow + mNumTaps, mNumTaps) - sample);
+    output[i] = sample;
+  }
+}
+
+}  // namespace v1util::dsp
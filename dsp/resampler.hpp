@@ -0,0 +1,89 @@
+#pragma once
+
+#include "audioBlock.hpp"
+#include "audioBuffer.hpp"
+
+#include "v1util/base/cpppainrelief.hpp"
+#include "v1util/base/platform.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace v1util {
+class ThreadPool;
+}
+
+namespace v1util { namespace dsp {
+
+/** Streaming sample rate converter for non-interleaved audio, with a polyphase FIR filter
+ *
+ * The rates are rounded to Hz and converted by their ratio L/M in lowest terms: output sample k
+ * is the input at time k * M / L. Its filter is a Kaiser-windowed sinc that spans tapsPerPhase
+ * samples at the lower rate, with about 90 dB attenuation from the lower Nyquist frequency on;
+ * with the default taps, the pass band reaches 0.41 of the lower rate. The filter of every phase
+ * is precomputed; with more than kMaxPhases phases, the output is interpolated linearly between
+ * the nearest two.
+ *
+ * Equal rates only delay the input. Blocks may have any size; the output doesn't depend on it.
+ */
+class Resampler {
+ public:
+  static constexpr const size_t kDefaultTapsPerPhase = 64;
+  static constexpr const size_t kMaxPhases = 1024;
+
+  Resampler() = default;
+  V1_PUBLIC Resampler(double inputRate, double outputRate, int numChannels,
+      size_t tapsPerPhase = kDefaultTapsPerPhase);
+  V1_DEFAULT_CP_MV_MAYTHROW(Resampler)
+
+  bool isValid() const { return mNumChannels > 0; }
+  int numChannels() const { return mNumChannels; }
+  double inputRate() const { return double(mInputRate); }
+  double outputRate() const { return double(mOutputRate); }
+  //! Taps per phase at the input rate, a multiple of 8
+  size_t numTaps() const { return mNumTaps; }
+
+  //! Output samples lag behind by this, since the filter needs input beyond their time
+  double latency() const { return double(mNumTaps / 2) * double(mUp) / double(mDown); }
+
+  //! The most output samples that process() writes for @p numInputSamples
+  size_t maxNumOutputSamples(size_t numInputSamples) const {
+    return size_t((uint64_t(numInputSamples) * mUp + mDown - 1) / mDown) + 1;
+  }
+
+  /** Consume all of @p input, write the output samples that are ready into @p output
+   *
+   * @p output needs at least maxNumOutputSamples(input.numSamples) samples. Returns how many
+   * were written. With a @p pPool, channels are processed in parallel.
+   */
+  V1_PUBLIC size_t process(ConstAudioBlock input, AudioBlock output, ThreadPool* pPool = nullptr);
+
+  //! Forget all input, as after construction
+  V1_PUBLIC void reset();
+
+ private:
+  //! An output sample: where its filter starts in mHistory, and between which rows of mFilters
+  struct Step {
+    uint32_t start;
+    uint32_t row;
+    float weight;  // of row + 1
+  };
+
+  void processChannel(int chan, Span<float> output) const;
+
+  uint64_t mInputRate = 0, mOutputRate = 0;
+  uint64_t mUp = 1, mDown = 1;  // L, M
+  int mNumChannels = 0;
+  size_t mNumTaps = 0;
+  size_t mNumPhases = 0;  // rows in mFilters, without the last one (phase 1)
+  std::vector<float> mFilters;  // mNumPhases + 1 rows of mNumTaps
+
+  // per stream:
+  AudioBuffer mHistory;  // the input that is still needed, then the new input
+  size_t mHistoryLength = 0;
+  uint64_t mPhase = 0;  // of the next output, in [0, mUp)
+  std::vector<Step> mSteps;  // of the current process() call
+};
+
+}}  // namespace v1util::dsp
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace v1util { namespace dsp {
+
+//! Whether audio blocks and buffers may hold samples of type @p T
+template <typename T>
+constexpr bool kIsSampleType = std::is_same_v<T, int16_t> || std::is_same_v<T, int32_t>
+                               || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+//! The value of a full-scale sample: 0x7FFF or 0x7FFF'FFFF as in wave files, 1 for floating-point
+template <typename Sample>
+constexpr double kFullScale =
+    std::is_floating_point_v<Sample> ? 1. : double(std::numeric_limits<Sample>::max());
+
+/** Convert one sample to another sample type, with the full scale of kFullScale
+ *
+ * Conversions to PCM round half away from zero and saturate, as in ops::convert(), which is the
+ * vectorized choice for whole channels.
+ */
+template <typename To, typename From>
+inline To convertSample(From sample) {
+  static_assert(kIsSampleType<To> && kIsSampleType<From>);
+
+  if constexpr(std::is_same_v<To, From>)
+    return sample;
+  else if constexpr(std::is_floating_point_v<To>)
+    return To(double(sample) / kFullScale<From>);
+  else {
+    constexpr const auto kCeiling = kFullScale<To>;
+    auto scaled = double(sample) * (kCeiling / kFullScale<From>);
+    if(!(std::abs(scaled) <= kCeiling)) scaled = std::signbit(scaled) ? -kCeiling : kCeiling;
+    return To(scaled + std::copysign(0.5, scaled));
+  }
+}
+
+}}  // namespace v1util::dsp
@@ -0,0 +1,274 @@
+#pragma once
+
+#include "audioBlock.hpp"
+
+#include "v1util/base/cpppainrelief.hpp"
+#include "v1util/base/debug.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace v1util { namespace dsp {
+
+//! Statistics of the last windowSize samples of a channel
+struct SlidingWindowValues {
+  float min = 0.f;
+  float max = 0.f;
+  float mean = 0.f;
+  float rms = 0.f;
+  float variance = 0.f;  // of the population in the window
+};
+
+//! Per-sample outputs of SlidingWindowStats; empty blocks are skipped
+struct SlidingWindowOutputs {
+  AudioBlock min;
+  AudioBlock max;
+  AudioBlock mean;
+  AudioBlock rms;
+  AudioBlock variance;
+};
+
+
+/** Moving min/max/mean/RMS/variance over the last windowSize samples of many channels
+ *
+ * The stream is cut into segments of windowSize samples. Each window spans the end of the
+ * previous segment and the start of the current one, so min and max are the extremes of a suffix
+ * of the previous segment and a prefix of the current one (van Herk/Gil-Werman). The suffix
+ * extremes are computed once per segment, so every sample costs three comparisons per extreme,
+ * regardless of the data.
+ *
+ * Sums are running, Kahan-compensated sums of the samples minus a shift; the sample that
+ * leaves the window is subtracted. At the end of each segment, the window is exactly that segment,
+ * so the sums are recomputed from it, shifted by its mean. Thus rounding errors don't accumulate
+ * across segments and the variance doesn't suffer from cancellation.
+ *
+ * Until windowSize samples have been seen, the statistics cover the samples seen so far.
+ */
+class SlidingWindowStats {
+ public:
+  SlidingWindowStats() = default;
+  SlidingWindowStats(int numChannels, size_t windowSize) { reconfigure(numChannels, windowSize); }
+  V1_DEFAULT_CP_MV(SlidingWindowStats);
+
+  void reconfigure(int numChannels, size_t windowSize) {
+    V1_ASSERT(numChannels >= 0);
+    V1_ASSERT(windowSize > 0U);
+    mWindowSize = windowSize;
+    mChannels.assign(size_t(numChannels), Channel(windowSize));
+    reset();
+  }
+
+  void reset() {
+    for(auto& channel : mChannels) channel.reset();
+    mSegmentPos = 0;
+    mNumSeen = 0;
+  }
+
+  /** Feed a block of @p in.numChannels channels, optionally writing per-sample statistics
+   *
+   * The non-empty blocks of @p outputs need the size of @p in; they may alias it.
+   */
+  void process(ConstAudioBlock in, const SlidingWindowOutputs& outputs = {}) {
+    V1_ASSERT(size_t(in.numChannels) == mChannels.size());
+    size_t done = 0;
+    while(done < in.numSamples) {
+      const auto count = std::min(in.numSamples - done, mWindowSize - mSegmentPos);
+      for(int iChan = 0; iChan < in.numChannels; ++iChan) {
+        processSegmentPart(
+            mChannels[size_t(iChan)], in.ppBuffer[iChan] + done, count, iChan, done, outputs);
+      }
+
+      mSegmentPos += count;
+      mNumSeen = std::min(mNumSeen + count, mWindowSize);
+      done += count;
+      if(mSegmentPos == mWindowSize) {
+        for(auto& channel : mChannels) channel.finishSegment();
+        mSegmentPos = 0;
+      }
+    }
+  }
+
+  //! The statistics of the window that ends with the last processed sample
+  SlidingWindowValues current(int channel) const {
+    V1_ASSERT(size_t(channel) < mChannels.size());
+    if(!mNumSeen) return {};
+
+    const auto& state = mChannels[size_t(channel)];
+    const auto lastPos = mSegmentPos ? mSegmentPos - 1 : mWindowSize - 1;
+    auto min = mSegmentPos ? std::min(state.prefixMin, state.suffixMin[lastPos + 1])
+                           : state.suffixMin[0];
+    auto max = mSegmentPos ? std::max(state.prefixMax, state.suffixMax[lastPos + 1])
+                           : state.suffixMax[0];
+    SlidingWindowValues result;
+    result.min = min;
+    result.max = max;
+    state.moments(double(mNumSeen), &result.mean, &result.rms, &result.variance);
+    return result;
+  }
+
+  size_t windowSize() const { return mWindowSize; }
+  int numChannels() const { return int(mChannels.size()); }
+
+ private:
+  struct Channel {
+    explicit Channel(size_t windowSize)
+        : segment(windowSize), previous(windowSize), suffixMin(windowSize + 1),
+          suffixMax(windowSize + 1) {}
+    V1_DEFAULT_CP_MV(Channel);
+
+    void reset() {
+      std::fill(previous.begin(), previous.end(), 0.f);
+      std::fill(suffixMin.begin(), suffixMin.end(), std::numeric_limits<float>::infinity());
+      std::fill(suffixMax.begin(), suffixMax.end(), -std::numeric_limits<float>::infinity());
+      prefixMin = std::numeric_limits<float>::infinity();
+      prefixMax = -std::numeric_limits<float>::infinity();
+      shift = sum = sumCompensation = sumSq = sumSqCompensation = 0.;
+    }
+
+    //! Computes the suffix extremes and resynchronizes the sums
+    void finishSegment() {
+      const auto size = segment.size();
+      for(size_t i = size; i-- > 0;) {
+        suffixMin[i] = std::min(segment[i], suffixMin[i + 1]);
+        suffixMax[i] = std::max(segment[i], suffixMax[i + 1]);
+      }
+      prefixMin = std::numeric_limits<float>::infinity();
+      prefixMax = -std::numeric_limits<float>::infinity();
+
+      // double sums of at most windowSize floats are exact enough, in lanes for speed
+      constexpr const size_t kLanes = 4;
+      const auto vectorSize = size - size % kLanes;
+      double sums[kLanes] = {};
+      for(size_t i = 0; i < vectorSize; i += kLanes)
+        for(size_t lane = 0; lane < kLanes; ++lane) sums[lane] += double(segment[i + lane]);
+      for(size_t i = vectorSize; i < size; ++i) sums[0] += double(segment[i]);
+      shift = ((sums[0] + sums[1]) + (sums[2] + sums[3])) / double(size);
+
+      double deviations[kLanes] = {};
+      double deviationSqs[kLanes] = {};
+      for(size_t i = 0; i < size; ++i) {
+        const auto deviation = double(segment[i]) - shift;
+        deviations[i % kLanes] += deviation;
+        deviationSqs[i % kLanes] += deviation * deviation;
+      }
+      sum = (deviations[0] + deviations[1]) + (deviations[2] + deviations[3]);
+      sumSq = (deviationSqs[0] + deviationSqs[1]) + (deviationSqs[2] + deviationSqs[3]);
+      sumCompensation = sumSqCompensation = 0.;
+
+      segment.swap(previous);
+    }
+
+    void moments(double count, float* pMean, float* pRms, float* pVariance) const {
+      const auto deviationMean = (sum - sumCompensation) / count;
+      const auto mean = shift + deviationMean;
+      const auto variance =
+          std::max((sumSq - sumSqCompensation) / count - deviationMean * deviationMean, 0.);
+      *pMean = float(mean);
+      *pRms = float(std::sqrt(variance + mean * mean));
+      *pVariance = float(variance);
+    }
+
+    //! Kahan; the shift keeps sum and values of similar magnitude, and there are no branches
+    static inline void addCompensated(double& sum, double& compensation, double value) {
+      const auto corrected = value - compensation;
+      const auto newSum = sum + corrected;
+      compensation = (newSum - sum) - corrected;
+      sum = newSum;
+    }
+
+    std::vector<float> segment;   // the samples of the current segment
+    std::vector<float> previous;  // those of the previous one, zeros initially
+    std::vector<float> suffixMin;  // of the previous segment, +1 for the empty suffix
+    std::vector<float> suffixMax;
+    float prefixMin = 0.f;  // of the current segment
+    float prefixMax = 0.f;
+
+    double shift = 0.;  // the sums are of the samples minus this
+    double sum = 0.;
+    double sumCompensation = 0.;
+    double sumSq = 0.;
+    double sumSqCompensation = 0.;
+  };
+
+  void processSegmentPart(Channel& state, const float* pSamples, size_t count, int iChan,
+      size_t outOffset, const SlidingWindowOutputs& outputs) {
+    const auto pos = mSegmentPos;
+    auto* pSegment = state.segment.data() + pos;
+    const auto* pPrevious = state.previous.data() + pos;
+
+    // min/max: prefix of this segment plus the suffix of the previous one
+    const bool wantsMin = outputs.min.numSamples;
+    const bool wantsMax = outputs.max.numSamples;
+    auto prefixMin = state.prefixMin;
+    auto prefixMax = state.prefixMax;
+    for(size_t i = 0; i < count; ++i) {
+      const auto sample = pSamples[i];
+      pSegment[i] = sample;
+      prefixMin = std::min(prefixMin, sample);
+      prefixMax = std::max(prefixMax, sample);
+      if(wantsMin)
+        outputs.min.ppBuffer[iChan][outOffset + i] =
+            std::min(prefixMin, state.suffixMin[pos + i + 1]);
+      if(wantsMax)
+        outputs.max.ppBuffer[iChan][outOffset + i] =
+            std::max(prefixMax, state.suffixMax[pos + i + 1]);
+    }
+    state.prefixMin = prefixMin;
+    state.prefixMax = prefixMax;
+
+    // sums: add the new sample, subtract the one leaving the window (0 in the first segment)
+    const bool wantsMoments =
+        outputs.mean.numSamples || outputs.rms.numSamples || outputs.variance.numSamples;
+    if(!wantsMoments) {
+      // only the sums at the end are needed: add up the changes in independent lanes
+      constexpr const size_t kLanes = 4;
+      double deltas[kLanes] = {};
+      double deltaSqs[kLanes] = {};
+      const auto vectorCount = count - count % kLanes;
+      for(size_t i = 0; i < vectorCount; i += kLanes) {
+        for(size_t lane = 0; lane < kLanes; ++lane) {
+          const auto deviation = double(pSegment[i + lane]) - state.shift;
+          const auto leaving = double(pPrevious[i + lane]) - state.shift;
+          deltas[lane] += deviation - leaving;
+          deltaSqs[lane] += deviation * deviation - leaving * leaving;
+        }
+      }
+      for(size_t i = vectorCount; i < count; ++i) {
+        const auto deviation = double(pSegment[i]) - state.shift;
+        const auto leaving = double(pPrevious[i]) - state.shift;
+        deltas[0] += deviation - leaving;
+        deltaSqs[0] += deviation * deviation - leaving * leaving;
+      }
+      Channel::addCompensated(state.sum, state.sumCompensation,
+          (deltas[0] + deltas[1]) + (deltas[2] + deltas[3]));
+      Channel::addCompensated(state.sumSq, state.sumSqCompensation,
+          (deltaSqs[0] + deltaSqs[1]) + (deltaSqs[2] + deltaSqs[3]));
+      return;
+    }
+
+    auto numSeen = mNumSeen;
+    for(size_t i = 0; i < count; ++i) {
+      const auto deviation = double(pSegment[i]) - state.shift;
+      const auto leaving = double(pPrevious[i]) - state.shift;
+      Channel::addCompensated(state.sum, state.sumCompensation, deviation - leaving);
+      Channel::addCompensated(state.sumSq, state.sumSqCompensation,
+          deviation * deviation - leaving * leaving);
+      numSeen = std::min(numSeen + 1, mWindowSize);
+
+      float mean, rms, variance;
+      state.moments(double(numSeen), &mean, &rms, &variance);
+      if(outputs.mean.numSamples) outputs.mean.ppBuffer[iChan][outOffset + i] = mean;
+      if(outputs.rms.numSamples) outputs.rms.ppBuffer[iChan][outOffset + i] = rms;
+      if(outputs.variance.numSamples) outputs.variance.ppBuffer[iChan][outOffset + i] = variance;
+    }
+  }
+
+  size_t mWindowSize = 0U;
+  std::vector<Channel> mChannels;
+  size_t mSegmentPos = 0U;  // samples in the current segment
+  size_t mNumSeen = 0U;     // saturates at mWindowSize
+};
+
+}}  // namespace v1util::dsp
@@ -0,0 +1,89 @@
+#include "stft.hpp"
+
+#include "v1util/base/math.hpp"
+
+#include <cmath>
+
+
+namespace v1util::dsp {
+
+namespace {
+// kernels; free functions, because compilers only trust __restrict on parameters
+
+V1_TARGET_CLONES void multiplyKernel(const float* __restrict pSource,
+    const float* __restrict pWindow, float* __restrict pTarget, size_t count) {
+  for(size_t i = 0; i < count; ++i) pTarget[i] = pSource[i] * pWindow[i];
+}
+
+V1_TARGET_CLONES void multiplyAddKernel(const float* __restrict pSource,
+    const float* __restrict pWindow, float* __restrict pTarget, size_t count) {
+  for(size_t i = 0; i < count; ++i) pTarget[i] += pSource[i] * pWindow[i];
+}
+}  // namespace
+
+
+Stft::Stft(int numChannels, size_t fftSize, size_t hopSize) {
+  mFft = RealFft(fftSize);
+  if(numChannels <= 0 || !mFft.isValid() || !hopSize || (hopSize & (hopSize - 1))
+      || 2 * hopSize > fftSize) {
+    mFft = RealFft();
+    return;
+  }
+
+  mNumChannels = numChannels;
+  mHopSize = hopSize;
+
+  // the squares of the window overlap to fftSize / (2 hopSize) everywhere
+  mWindows.resize(2, fftSize);
+  const auto synthesisGain = 2. * double(hopSize) / double(fftSize);
+  for(size_t i = 0; i < fftSize; ++i) {
+    const auto window = std::sin(kPi * double(i) / double(fftSize));
+    mWindows.channel(0)[i] = float(window);
+    mWindows.channel(1)[i] = float(window * synthesisGain);
+  }
+
+  mInput.resize(numChannels, fftSize);
+  mOverlap.resize(numChannels, fftSize);
+  mReal.resize(numChannels, mFft.numBins());
+  mImag.resize(numChannels, mFft.numBins());
+  mFrame.resize(1, fftSize);
+}
+
+void Stft::reset() {
+  mInput.clear();
+  mOverlap.clear();
+  mHopFill = 0;
+  mFrameIndex = 0;
+}
+
+void Stft::analyzeFrame() {
+  const auto frame = mFrame.channel(0);
+  for(int chan = 0; chan < mNumChannels; ++chan) {
+    multiplyKernel(mInput.constChannel(chan).data(), mWindows.constChannel(0).data(), frame.data(),
+        frame.size());
+    mFft.forward(frame, mReal.channel(chan), mImag.channel(chan));
+  }
+}
+
+void Stft::synthesizeFrame() {
+  const auto frame = mFrame.channel(0);
+  for(int chan = 0; chan < mNumChannels; ++chan) {
+    auto pOverlap = mOverlap.channel(chan).data();
+    std::memmove(pOverlap, pOverlap + mHopSize, (frame.size() - mHopSize) * sizeof(float));
+    std::memset(pOverlap + frame.size() - mHopSize, 0, mHopSize * sizeof(float));
+
+    mFft.inverse(mReal.constChannel(chan), mImag.constChannel(chan), frame);
+    multiplyAddKernel(frame.data(), mWindows.constChannel(1).data(), pOverlap, frame.size());
+  }
+}
+
+void Stft::nextFrame() {
+  for(int chan = 0; chan < mNumChannels; ++chan) {
+    auto pInput = mInput.channel(chan).data();
+    std::memmove(pInput, pInput + mHopSize, (fftSize() - mHopSize) * sizeof(float));
+  }
+  mHopFill = 0;
+  ++mFrameIndex;
+}
+
+}  // namespace v1util::dsp
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "audioBlock.hpp"
+#include "audioBuffer.hpp"
+#include "fft.hpp"
+
+#include "v1util/base/cpppainrelief.hpp"
+#include "v1util/base/debug.hpp"
+#include "v1util/base/platform.hpp"
+#include "v1util/container/array_view.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace v1util::dsp {
+
+//! The spectra of all channels at one hop of a Stft
+struct StftFrame {
+  /** Frames are counted from 0
+   *
+   * Frame k covers the input samples [(k + 1) * hopSize - fftSize, (k + 1) * hopSize); the stream
+   * starts after fftSize - hopSize zeros.
+   */
+  size_t index;
+  AudioBlock real;  //!< numBins() per channel
+  AudioBlock imag;
+};
+
+/** Streaming short-time Fourier transform of non-interleaved audio, with overlap-add resynthesis
+ *
+ * Every hopSize input samples, the last fftSize samples of each channel are weighted by a
+ * square-root Hann window and transformed by a RealFft. A frame handler gets the spectra and may
+ * change them. For resynthesis, the spectra are transformed back, weighted by the window again and
+ * overlap-added, which reconstructs unchanged spectra exactly. The output is delayed by fftSize
+ * samples.
+ *
+ * Blocks may have any size; the frames and the output don't depend on it.
+ */
+class Stft {
+ public:
+  Stft() = default;
+  //! @p fftSize: a power of two; @p hopSize: a power of two, at most half of @p fftSize
+  V1_PUBLIC Stft(int numChannels, size_t fftSize, size_t hopSize);
+  V1_DEFAULT_CP_MV_MAYTHROW(Stft)
+
+  bool isValid() const { return mNumChannels > 0; }
+  int numChannels() const { return mNumChannels; }
+  size_t fftSize() const { return mFft.size(); }
+  size_t hopSize() const { return mHopSize; }
+  size_t numBins() const { return mFft.numBins(); }
+  //! Of the output of process(), in samples
+  size_t latency() const { return fftSize(); }
+  //! The analysis window
+  ArrayView<float> window() const { return mWindows.constChannel(0); }
+
+  //! Call @p frameHandler(StftFrame&) for every frame that @p input completes
+  template <typename Invokable>
+  void analyze(ConstAudioBlock input, Invokable&& frameHandler) {
+    run<false>(input, nullptr, frameHandler);
+  }
+
+  /** As analyze(), and write the resynthesized frames to @p output
+   *
+   * @p frameHandler(StftFrame&) may change the spectra of the frame. @p output has
+   * input.numSamples samples.
+   */
+  template <typename Invokable>
+  void process(ConstAudioBlock input, AudioBlock output, Invokable&& frameHandler) {
+    V1_ASSERT(output.numChannels == mNumChannels && output.numSamples == input.numSamples);
+    run<true>(input, output.ppBuffer, frameHandler);
+  }
+
+  //! Forget all input, as after construction
+  V1_PUBLIC void reset();
+
+ private:
+  template <bool kResynthesize, typename Invokable>
+  void run(ConstAudioBlock input, float* const* ppOutput, Invokable& frameHandler) {
+    V1_ASSERT(isValid() && input.numChannels == mNumChannels);
+    const auto newSamplesOffset = fftSize() - mHopSize;
+    for(size_t pos = 0; pos < input.numSamples;) {
+      const auto count = std::min(mHopSize - mHopFill, input.numSamples - pos);
+      for(int chan = 0; chan < mNumChannels; ++chan) {
+        std::memcpy(mInput.channel(chan).data() + newSamplesOffset + mHopFill,
+            input.ppBuffer[chan] + pos, count * sizeof(float));
+        if constexpr(kResynthesize)
+          std::memcpy(ppOutput[chan] + pos, mOverlap.constChannel(chan).data() + mHopFill,
+              count * sizeof(float));
+      }
+      mHopFill += count;
+      pos += count;
+
+      if(mHopFill == mHopSize) {
+        analyzeFrame();
+        StftFrame frame{mFrameIndex, mReal.audioBlock(), mImag.audioBlock()};
+        frameHandler(frame);
+        if constexpr(kResynthesize) synthesizeFrame();
+        nextFrame();
+      }
+    }
+  }
+
+  //! The spectra of mInput into mReal, mImag
+  V1_PUBLIC void analyzeFrame();
+  //! Overlap-add the signal of mReal, mImag to mOverlap, after moving it by a hop
+  V1_PUBLIC void synthesizeFrame();
+  V1_PUBLIC void nextFrame();
+
+  int mNumChannels = 0;
+  size_t mHopSize = 0;
+  RealFft mFft;
+  AudioBuffer mWindows;  // analysis, synthesis (scaled for unity gain)
+
+  // per stream:
+  AudioBuffer mInput;  // the last fftSize samples
+  AudioBuffer mOverlap;  // fftSize samples, the first hopSize of them complete
+  AudioBuffer mReal, mImag;
+  AudioBuffer mFrame;  // one channel of fftSize samples
+  size_t mHopFill = 0;  // input samples of the current hop
+  size_t mFrameIndex = 0;
+};
+
+}  // namespace v1util::dsp
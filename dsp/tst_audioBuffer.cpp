@@ -0,0 +1,135 @@
+#include "audioBuffer.hpp"
+
+#include "doctest/doctest.h"
+
+#include <cstdint>
+#include <utility>
+
+namespace v1util::dsp::test {
+
+namespace {
+template <typename Sample>
+bool isAligned(const Sample* pSamples) {
+  return reinterpret_cast<uintptr_t>(pSamples) % kAudioBufferAlignment == 0;
+}
+}  // namespace
+
+TEST_CASE("AudioBuffer-layout") {
+  AudioBuffer buffer(3, 100);
+  CHECK(buffer.numChannels() == 3);
+  CHECK(buffer.numSamples() == 100U);
+  CHECK(buffer.channelStride() == 112U);
+  for(int chan = 0; chan < 3; ++chan) {
+    CHECK(isAligned(buffer.channel(chan).data()));
+    for(auto sample : buffer.constChannel(chan)) CHECK(sample == 0.f);
+  }
+  CHECK(buffer.channel(1).data() - buffer.channel(0).data() == 112);
+}
+
+TEST_CASE("AudioBuffer-sampleTypes") {
+  BasicAudioBuffer<int16_t> ints16(2, 100);
+  CHECK(ints16.channelStride() == 128U);
+  CHECK(isAligned(ints16.channel(1).data()));
+
+  ints16.audioBlock().fill(0, 20000);
+  ints16.audioBlock().fill(1, -3);
+  ints16.audioBlock().applyGain(2.f);
+  CHECK(ints16.constChannel(0)[99] == 0x7FFF);
+  CHECK(ints16.constChannel(1)[0] == -6);
+  ints16.audioBlock().applyGain(-0.25f);
+  CHECK(ints16.constChannel(1)[0] == 2);  // rounds half away from zero
+
+  BasicAudioBuffer<double> doubles(1, 9);
+  CHECK(doubles.channelStride() == 16U);
+  doubles.audioBlock().fill(0.5);
+  doubles.audioBlock().applyGain(0.5f);
+  CHECK(doubles.constChannel(0)[8] == 0.25);
+
+  AudioBufferPool pool;
+  pool.reserve<int16_t>(2, 1000, 1);
+  BasicAudioBuffer<int16_t> pooled(2, 1000, &pool);
+  CHECK(pool.numFree() == 0U);
+}
+
+TEST_CASE("AudioBuffer-capacity_reuse") {
+  AudioBuffer buffer(2, 256);
+  buffer.audioBlock().fill(1.f);
+  const auto* pFirst = buffer.channel(0).data();
+  const auto capacity = buffer.capacity();
+
+  // down and back up to the same size, and more channels of fewer samples
+  buffer.resize(1, 10);
+  CHECK(buffer.channel(0).data() == pFirst);
+  buffer.resize(2, 256);
+  CHECK(buffer.channel(0).data() == pFirst);
+  CHECK(buffer.constChannel(1)[255] == 0.f);
+  buffer.resize(4, 100);
+  CHECK(buffer.capacity() == capacity);
+  CHECK(isAligned(buffer.channel(3).data()));
+
+  buffer.resize(4, 1000);
+  CHECK(buffer.capacity() > capacity);
+
+  buffer.resize(0, 0);
+  CHECK(buffer.audioBlock().ppBuffer == nullptr);
+  CHECK(buffer.capacity() > capacity);
+}
+
+TEST_CASE("AudioBuffer-copy_move") {
+  AudioBuffer buffer(2, 20);
+  buffer.channel(1)[19] = 5.f;
+
+  AudioBuffer copy(buffer);
+  CHECK(copy.constChannel(1)[19] == 5.f);
+  auto& alias = copy;
+  copy = alias;
+  CHECK(copy.constChannel(1)[19] == 5.f);
+
+  AudioBuffer moved(std::move(copy));
+  CHECK(moved.constChannel(1)[19] == 5.f);
+  CHECK(copy.numSamples() == 0U);
+  CHECK(copy.capacity() == 0U);
+
+  buffer = std::move(moved);
+  CHECK(buffer.constChannel(1)[19] == 5.f);
+  copy = buffer;
+  CHECK(copy.constChannel(1)[19] == 5.f);
+}
+
+TEST_CASE("AudioBufferPool") {
+  AudioBufferPool pool;
+  pool.reserve(2, 512, 3);
+  CHECK(pool.numFree() == 3U);
+
+  {
+    AudioBuffer a(2, 512, &pool);
+    AudioBuffer b(1, 100, &pool);
+    CHECK(pool.numFree() == 1U);
+    CHECK(isAligned(b.channel(0).data()));
+
+    AudioBuffer copy(a);
+    CHECK(copy.pool() == &pool);
+    CHECK(pool.numFree() == 0U);
+  }
+  CHECK(pool.numFree() == 3U);
+
+  // released storage is handed out again instead of new one
+  AudioBuffer buffer(&pool);
+  buffer.resize(2, 500);
+  CHECK(pool.numFree() == 2U);
+  buffer.destroy();
+  buffer.resize(2, 512);
+  CHECK(pool.numFree() == 2U);
+
+  // larger storage comes from the heap, but is pooled, too; only it fits the next buffer
+  buffer.resize(8, 4096);
+  CHECK(pool.numFree() == 3U);
+  const auto pSamples = buffer.channel(0).data();
+  buffer.destroy();
+  CHECK(pool.numFree() == 4U);
+  buffer.resize(8, 4000);
+  CHECK(buffer.channel(0).data() == pSamples);
+  CHECK(pool.numFree() == 3U);
+}
+
+}  // namespace v1util::dsp::test
@@ -0,0 +1,169 @@
+#include "biquad.hpp"
+
+#include "audioBuffer.hpp"
+
+#include "v1util/base/math.hpp"
+
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace v1util::dsp::test {
+
+namespace {
+AudioBuffer noiseBuffer(int numChannels, size_t numSamples) {
+  AudioBuffer buffer(numChannels, numSamples);
+  std::mt19937 rng(5U);
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  for(int chan = 0; chan < numChannels; ++chan)
+    for(auto& sample : buffer.channel(chan)) sample = distribution(rng);
+  return buffer;
+}
+
+//! Filter all of @p buffer in place, in blocks of @p blockSize
+void processAll(BiquadCascade& cascade, AudioBuffer& buffer, size_t blockSize) {
+  std::vector<float*> ppBlock(size_t(buffer.numChannels()));
+  for(size_t pos = 0; pos < buffer.numSamples(); pos += blockSize) {
+    for(int chan = 0; chan < buffer.numChannels(); ++chan)
+      ppBlock[size_t(chan)] = buffer.channel(chan).data() + pos;
+    cascade.process(
+        {ppBlock.data(), buffer.numChannels(), std::min(blockSize, buffer.numSamples() - pos)});
+  }
+}
+
+//! Direct form I in double precision
+std::vector<double> referenceFilter(
+    ArrayView<float> input, const std::vector<BiquadCoefficients>& stages) {
+  std::vector<double> samples(input.begin(), input.end());
+  for(const auto& c : stages) {
+    double x1 = 0., x2 = 0., y1 = 0., y2 = 0.;
+    for(auto& sample : samples) {
+      const auto y = c.b0 * sample + c.b1 * x1 + c.b2 * x2 - c.a1 * y1 - c.a2 * y2;
+      x2 = x1;
+      x1 = sample;
+      y2 = y1;
+      y1 = y;
+      sample = y;
+    }
+  }
+  return samples;
+}
+}  // namespace
+
+TEST_CASE("BiquadCascade-reference") {
+  const std::vector<BiquadCoefficients> stages = {BiquadCoefficients::highPass(48000., 40.),
+      BiquadCoefficients::peaking(48000., 3000., 2., 6.),
+      BiquadCoefficients::lowPass(48000., 8000., 0.9)};
+
+  // 11 channels: a group of 8 and one of 3
+  const auto input = noiseBuffer(11, 3000);
+  for(size_t blockSize : {1, 63, 3000}) {
+    CAPTURE(blockSize);
+    BiquadCascade cascade(11, stages.size());
+    REQUIRE(cascade.isValid());
+    for(size_t i = 0; i < stages.size(); ++i) cascade.setCoefficients(i, stages[i]);
+
+    auto output = input;
+    processAll(cascade, output, blockSize);
+    // the 40 Hz high-pass has poles close to 1, so float states are off by about 1e-4
+    for(int chan = 0; chan < 11; ++chan) {
+      const auto expected = referenceFilter(input.constChannel(chan), stages);
+      auto maxError = 0.;
+      for(size_t i = 0; i < expected.size(); ++i)
+        maxError = std::max(maxError, std::abs(output.constChannel(chan)[i] - expected[i]));
+      CHECK(maxError < 1e-3);
+    }
+  }
+}
+
+TEST_CASE("BiquadCascade-response") {
+  const auto lowPass = BiquadCoefficients::lowPass(48000., 1000.);
+  CHECK(lowPass.gainAt(48000., 0.) == doctest::Approx(1.).epsilon(1e-5));
+  CHECK(lowPass.gainAt(48000., 1000.) == doctest::Approx(1. / kSqrt2).epsilon(1e-5));
+  CHECK(BiquadCoefficients::bandPass(48000., 5000., 3.).gainAt(48000., 5000.)
+        == doctest::Approx(1.).epsilon(1e-5));
+  CHECK(BiquadCoefficients::notch(48000., 5000., 3.).gainAt(48000., 5000.) < 1e-3);
+  CHECK(BiquadCoefficients::peaking(48000., 5000., 1., -6.).gainAt(48000., 5000.)
+        == doctest::Approx(std::pow(10., -6. / 20.)).epsilon(1e-5));
+
+  // steady-state amplitude of sines
+  for(double freqHz : {100., 1000., 6000.}) {
+    AudioBuffer buffer(1, 9600);
+    for(size_t i = 0; i < 9600; ++i)
+      buffer.channel(0)[i] = float(std::sin(2. * kPi * freqHz * double(i) / 48000.));
+    BiquadCascade cascade(1, 1);
+    cascade.setCoefficients(0, lowPass);
+    processAll(cascade, buffer, 480);
+    const auto peak = *std::max_element(buffer.constChannel(0).begin() + 4800,
+        buffer.constChannel(0).end());
+    CHECK(peak == doctest::Approx(lowPass.gainAt(48000., freqHz)).epsilon(2e-3));
+  }
+}
+
+TEST_CASE("BiquadCascade-dcAndPreEmphasis") {
+  AudioBuffer buffer(2, 48000);
+  buffer.audioBlock().fill(0.5f);
+  BiquadCascade cascade(2, 2);
+  cascade.setCoefficients(0, BiquadCoefficients::dcBlocker(48000., 10.));
+  processAll(cascade, buffer, 1024);
+  CHECK(std::abs(buffer.constChannel(1)[47999]) < 1e-4f);
+
+  BiquadCascade preEmphasis(1, 1);
+  preEmphasis.setCoefficients(0, BiquadCoefficients::preEmphasis(0.97f));
+  auto ramp = noiseBuffer(1, 100);
+  const auto input = ramp;
+  processAll(preEmphasis, ramp, 7);
+  for(size_t i = 1; i < 100; ++i)
+    CHECK(ramp.constChannel(0)[i]
+          == doctest::Approx(input.constChannel(0)[i] - 0.97f * input.constChannel(0)[i - 1]));
+}
+
+TEST_CASE("BiquadCascade-smoothing") {
+  BiquadCoefficients halfGain;
+  halfGain.b0 = 0.5f;
+
+  for(size_t blockSize : {1, 50, 1000}) {
+    CAPTURE(blockSize);
+    AudioBuffer buffer(3, 1000);
+    buffer.audioBlock().fill(1.f);
+    BiquadCascade cascade(3, 1);
+    cascade.setCoefficients(0, halfGain, 300);
+    CHECK(cascade.coefficients(0).b0 == 0.5f);
+    processAll(cascade, buffer, blockSize);
+
+    // a linear ramp from 1 to 0.5, without jumps
+    const auto channel = buffer.constChannel(2);
+    for(size_t i = 0; i < 300; ++i)
+      REQUIRE(channel[i] == doctest::Approx(1. - 0.5 * double(i) / 300.).epsilon(1e-5));
+    for(size_t i = 300; i < 1000; ++i) REQUIRE(channel[i] == 0.5f);
+  }
+
+  // ramps start where the last one is
+  AudioBuffer buffer(1, 100);
+  buffer.audioBlock().fill(1.f);
+  BiquadCascade cascade(1, 1);
+  cascade.setCoefficients(0, halfGain, 200);
+  processAll(cascade, buffer, 100);
+  cascade.setCoefficients(0, BiquadCoefficients(), 50);
+  buffer.audioBlock().fill(1.f);
+  processAll(cascade, buffer, 100);
+  CHECK(buffer.constChannel(0)[0] == doctest::Approx(0.75f));
+  CHECK(buffer.constChannel(0)[50] == 1.f);
+}
+
+TEST_CASE("BiquadCascade-reset") {
+  BiquadCascade cascade(1, 1);
+  cascade.setCoefficients(0, BiquadCoefficients::lowPass(48000., 100.));
+  auto buffer = noiseBuffer(1, 100);
+  processAll(cascade, buffer, 100);
+  cascade.reset();
+
+  AudioBuffer silence(1, 10);
+  processAll(cascade, silence, 10);
+  CHECK(*std::max_element(silence.constChannel(0).begin(), silence.constChannel(0).end()) == 0.f);
+}
+
+}  // namespace v1util::dsp::test
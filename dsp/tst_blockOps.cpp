@@ -0,0 +1,193 @@
+#include "blockOps.hpp"
+
+#include "audioBuffer.hpp"
+
+#include "v1util/container/range.hpp"
+
+#include "doctest/doctest.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace v1util::dsp::test {
+
+namespace {
+std::vector<float> makeSamples(size_t size, float amplitude) {
+  std::vector<float> samples(size);
+  std::mt19937 rng(0xB10CU);
+  std::uniform_real_distribution<float> distribution(-amplitude, amplitude);
+  for(auto& sample : samples) sample = distribution(rng);
+  return samples;
+}
+
+//! Odd sizes and offsets, so that both vector and tail paths run
+const size_t kSizes[] = {0, 1, 15, 100, 1029};
+}  // namespace
+
+TEST_CASE("blockOps-instructionSet") {
+  const std::string instructionSet = ops::instructionSet();
+  CHECK(!instructionSet.empty());
+}
+
+TEST_CASE("blockOps-gain_mix") {
+  for(auto size : kSizes) {
+    const auto source = makeSamples(size + 1, 1.f);
+    auto target = makeSamples(size + 1, 0.5f);
+    const auto sourceView = make_array_view(source).subview(1, size);
+    auto targetSpan = make_span(target).subspan(1, size);
+
+    auto expected = target;
+    for(size_t i = 0; i < size; ++i) expected[i + 1] += 0.25f * source[i + 1];
+    ops::mix(sourceView, targetSpan, 0.25f);
+    CHECK(target == expected);
+
+    for(size_t i = 0; i < size; ++i) expected[i + 1] *= -2.f;
+    ops::applyGain(targetSpan, -2.f);
+    CHECK(target == expected);
+
+    // ramps: from the start gain, towards the end gain
+    const auto step = size ? (1.f - 0.5f) / float(size) : 0.f;
+    for(size_t i = 0; i < size; ++i)
+      expected[i + 1] += (0.5f + step * float(i)) * source[i + 1];
+    ops::mixWithRamp(sourceView, targetSpan, 0.5f, 1.f);
+    for(size_t i = 0; i < size; ++i)
+      REQUIRE(target[i + 1] == doctest::Approx(expected[i + 1]).epsilon(1e-6));
+
+    for(size_t i = 0; i < size; ++i) expected[i + 1] = target[i + 1] * (1.f - step * float(i));
+    ops::applyGainRamp(targetSpan, 1.f, 0.5f);
+    for(size_t i = 0; i < size; ++i)
+      REQUIRE(target[i + 1] == doctest::Approx(expected[i + 1]).epsilon(1e-6));
+    CHECK(target[0] == expected[0]);
+  }
+}
+
+TEST_CASE("blockOps-metering") {
+  CHECK(ops::peak(ArrayView<float>()) == 0.f);
+  CHECK(ops::rms(ArrayView<float>()) == 0.f);
+
+  for(auto size : kSizes) {
+    if(!size) continue;
+    auto samples = makeSamples(size, 2.f);
+    samples[size / 2] = -3.f;
+    CHECK(ops::peak(make_array_view(samples)) == 3.f);
+
+    double sumSq = 0.;
+    for(auto sample : samples) sumSq += double(sample) * sample;
+    CHECK(ops::rms(make_array_view(samples))
+          == doctest::Approx(std::sqrt(sumSq / double(size))).epsilon(1e-6));
+  }
+
+  AudioBuffer buffer(2, 50);
+  buffer.channel(1)[10] = -0.5f;
+  float peaks[2], rmss[2];
+  ops::peak(buffer.constAudioBlock(), make_span(peaks, 2));
+  ops::rms(buffer.constAudioBlock(), make_span(rmss, 2));
+  CHECK(peaks[0] == 0.f);
+  CHECK(peaks[1] == 0.5f);
+  CHECK(rmss[1] == doctest::Approx(std::sqrt(0.25 / 50.)));
+}
+
+TEST_CASE("blockOps-clip_flushDenormals") {
+  const auto kDenormal = std::numeric_limits<float>::denorm_min() * 5.f;
+  const auto kInf = std::numeric_limits<float>::infinity();
+  std::vector<float> samples = {0.5f, -0.5f, 1.5f, -1.5f, kInf, -kInf, kDenormal, -kDenormal, 0.f,
+      std::numeric_limits<float>::min()};
+
+  auto clipped = samples;
+  ops::clip(make_span(clipped), 1.f);
+  CHECK(clipped == std::vector<float>{0.5f, -0.5f, 1.f, -1.f, 1.f, -1.f, kDenormal, -kDenormal,
+                       0.f, std::numeric_limits<float>::min()});
+
+  ops::flushDenormals(make_span(samples));
+  CHECK(samples[6] == 0.f);
+  CHECK(std::signbit(samples[7]));
+  CHECK(samples[7] == 0.f);
+  CHECK(samples[9] == std::numeric_limits<float>::min());
+  CHECK(samples[4] == kInf);
+}
+
+TEST_CASE("blockOps-convert") {
+  const std::vector<float> samples = {0.f, 0.5f, -0.5f, 1.f, -1.f, 2.f, -2.f, 1e-6f};
+
+  std::vector<int16_t> ints16(samples.size());
+  ops::convert(make_array_view(samples), make_span(ints16));
+  CHECK(ints16 == std::vector<int16_t>{0, 16384, -16384, 32767, -32767, 32767, -32767, 0});
+
+  std::vector<int32_t> ints32(samples.size());
+  ops::convert(make_array_view(samples), make_span(ints32));
+  CHECK(ints32[1] == 1073741824);
+  CHECK(ints32[3] == 0x7FFF'FFFF);
+  CHECK(ints32[6] == -0x7FFF'FFFF);
+  CHECK(ints32[7] == 2147);
+
+  std::vector<float> back(samples.size());
+  ops::convert(make_array_view(ints16), make_span(back));
+  CHECK(back[3] == 1.f);
+  CHECK(back[2] == doctest::Approx(-0.5f).epsilon(1e-4));
+  ops::convert(make_array_view(ints32), make_span(back));
+  CHECK(back[4] == -1.f);
+  CHECK(back[1] == 0.5f);
+}
+
+TEST_CASE("blockOps-convertSample") {
+  CHECK(convertSample<int16_t>(0.5f) == 16384);
+  CHECK(convertSample<int16_t>(-2.) == -0x7FFF);
+  CHECK(convertSample<int16_t>(std::numeric_limits<float>::quiet_NaN()) == 0x7FFF);
+  CHECK(convertSample<int32_t>(int16_t(0x7FFF)) == 0x7FFF'FFFF);
+  CHECK(convertSample<int16_t>(int32_t(-0x4000'0000)) == -16384);
+  CHECK(convertSample<double>(int16_t(-0x7FFF)) == -1.);
+  CHECK(convertSample<float>(0.25) == 0.25f);
+}
+
+TEST_CASE("blockOps-convertBlocks") {
+  AudioBuffer floats(2, 19);
+  for(int chan = 0; chan < 2; ++chan)
+    for(size_t i = 0; i < 19; ++i) floats.channel(chan)[i] = float(i) / 9.f - 1.f;
+
+  BasicAudioBuffer<int16_t> ints16(2, 19);
+  BasicAudioBuffer<int32_t> ints32(2, 19);
+  BasicAudioBuffer<double> doubles(2, 19);
+  ops::convert(floats.constAudioBlock(), ints16.audioBlock());
+  ops::convert(ints16.constAudioBlock(), ints32.audioBlock());
+  ops::convert(ints32.audioBlock(), doubles.audioBlock());  // mutable sources convert, too
+  for(size_t i = 0; i < 19; ++i) {
+    const auto sample = floats.constChannel(1)[i];
+    REQUIRE(ints16.constChannel(1)[i] == convertSample<int16_t>(sample));
+    REQUIRE(doubles.constChannel(1)[i] == doctest::Approx(sample).epsilon(1e-4));
+  }
+  CHECK(ints32.constChannel(0)[18] == 0x7FFF'FFFF);
+
+  AudioBuffer back(2, 19);
+  ops::convert(doubles.constAudioBlock(), back.audioBlock());
+  ops::convert(back.constAudioBlock(), floats.audioBlock());
+  CHECK(floats.constChannel(0)[0] == -1.f);
+
+  // transposes of any sample type
+  std::vector<int16_t> interleaved(2 * 19);
+  ops::interleave(
+      ints16.constAudioBlock(), BasicInterleavedAudioBlock<int16_t>(interleaved.data(), 2, 19));
+  CHECK(interleaved[3] == ints16.constChannel(1)[1]);
+  BasicAudioBuffer<int16_t> deinterleaved(2, 19);
+  ops::deinterleave(BasicConstInterleavedAudioBlock<int16_t>(interleaved.data(), 2, 19),
+      deinterleaved.audioBlock());
+  CHECK(pmrange::equal(deinterleaved.constChannel(1), ints16.constChannel(1)));
+}
+
+TEST_CASE("blockOps-blocks") {
+  AudioBuffer source(3, 33), target(3, 33);
+  ops::fill(source.audioBlock(), 0.5f);
+  ops::copy(source.constAudioBlock(), target.audioBlock());
+  ops::mix(source.constAudioBlock(), target.audioBlock(), 2.f);
+  for(int chan = 0; chan < 3; ++chan)
+    for(auto sample : target.constChannel(chan)) CHECK(sample == 1.5f);
+
+  ops::clip(target.audioBlock(), 1.f);
+  ops::applyGain(target.audioBlock(), 0.5f);
+  CHECK(target.constChannel(2)[32] == 0.5f);
+}
+
+}  // namespace v1util::dsp::test
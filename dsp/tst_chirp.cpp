@@ -0,0 +1,101 @@
+#include "chirp.hpp"
+
+#include "audioBuffer.hpp"
+
+#include "v1util/container/range.hpp"
+
+#include "doctest/doctest.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace v1util::dsp::test {
+
+namespace {
+constexpr const double kSampleRate = 48000.;
+constexpr const long double kPiL = 3.141592653589793238462643383279502884L;
+
+//! The exact sweep at sample @p n, in long double and without fades
+double referenceChirp(ChirpSweep sweep, double startHz, double endHz, double durationS, size_t n) {
+  const auto t = (long double)(n) / (long double)kSampleRate;
+  long double turns;
+  if(sweep == ChirpSweep::kLinear)
+    turns = startHz * t + (endHz - startHz) * t * t / (2.L * durationS);
+  else {
+    const auto octaves = std::log((long double)endHz / startHz) / durationS;
+    turns = startHz * std::expm1(octaves * t) / octaves;
+  }
+  return double(std::sin(2.L * kPiL * (turns - std::floor(turns))));
+}
+}  // namespace
+
+TEST_CASE("ChirpGen-accuracy") {
+  for(auto sweep : {ChirpSweep::kLinear, ChirpSweep::kExponential}) {
+    ChirpGen<double> chirp(kSampleRate, 20., 20000., 2., 0., sweep);
+    std::vector<double> samples(chirp.lengthSmpl());
+    CHECK(chirp.fillBlock(make_span(samples)) == size_t(2 * kSampleRate));
+    CHECK(chirp.done());
+
+    double maxError = 0.;
+    for(size_t i = 0; i < samples.size(); ++i)
+      maxError = std::max(maxError,
+          std::abs(samples[i] - referenceChirp(sweep, 20., 20000., 2., i)));
+    // up to 20000 cycles
+    CHECK(maxError < 2e-11 + 2e-15 * 20000.);
+  }
+}
+
+TEST_CASE("ChirpGen-blocks") {
+  for(auto sweep : {ChirpSweep::kLinear, ChirpSweep::kExponential}) {
+    ChirpGen<float> chirp(8000.f, 100.f, 3000.f, 1.f, 0.1f, sweep);
+    REQUIRE(chirp.lengthSmpl() == 8000U);
+    std::vector<float> whole(chirp.lengthSmpl());
+    CHECK(chirp.fillBlock(make_span(whole)) == 8000U);
+    CHECK(chirp.fillBlock(make_span(whole)) == 0U);
+
+    // resumable in blocks of any size, with the same result
+    chirp.seek(0);
+    std::vector<float> blocks(chirp.lengthSmpl() + 100, 2.f);
+    size_t pos = 0;
+    for(size_t blockSize = 1; !chirp.done(); blockSize = blockSize * 3 + 1) {
+      auto block = make_span(blocks).subspan(pos, std::min(blockSize, blocks.size() - pos));
+      pos += chirp.fillBlock(block);
+      CHECK(chirp.position() == pos);
+    }
+    CHECK(pos == 8000U);
+    CHECK(blocks[8000] == 2.f);
+    blocks.resize(8000);
+    CHECK(blocks == whole);
+  }
+}
+
+TEST_CASE("ChirpGen-fades") {
+  ChirpGen<double> chirp(kSampleRate, 1000., 2000., 0.1, 0.01);
+  std::vector<double> samples(chirp.lengthSmpl());
+  chirp.fillBlock(make_span(samples));
+
+  const size_t numFade = 480;
+  for(size_t i = 0; i < samples.size(); ++i) {
+    auto gain = 1.;
+    if(i < numFade)
+      gain = std::exp(-5. * double(numFade - 1 - i) / double(numFade));
+    else if(i >= samples.size() - numFade)
+      gain = std::exp(-5. * double(i - (samples.size() - numFade)) / double(numFade));
+    REQUIRE(samples[i]
+            == doctest::Approx(gain * referenceChirp(ChirpSweep::kLinear, 1000., 2000., 0.1, i))
+                   .epsilon(1e-9));
+  }
+}
+
+TEST_CASE("ChirpGen-audioBlock") {
+  ChirpGen<double> chirp(kSampleRate, 500., 500., 0.01, 0., ChirpSweep::kExponential);
+  BasicAudioBuffer<int16_t> buffer(3, 1000);
+  CHECK(chirp.fillBlock(buffer.audioBlock()) == 480U);
+  CHECK(pmrange::equal(buffer.constChannel(0), buffer.constChannel(2)));
+  CHECK(buffer.constChannel(1)[479] == convertSample<int16_t>(referenceChirp(
+                                           ChirpSweep::kLinear, 500., 500., 0.01, 479)));
+  CHECK(buffer.constChannel(1)[480] == 0);
+}
+
+}  // namespace v1util::dsp::test
@@ -0,0 +1,79 @@
+#include "fft.hpp"
+
+#include "v1util/base/math.hpp"
+
+#include "doctest/doctest.h"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace v1util::dsp::test {
+
+namespace {
+//! Uniform noise in [-1, 1)
+std::vector<float> noise(size_t size, uint32_t seed) {
+  std::vector<float> samples(size);
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  for(auto& sample : samples) sample = distribution(rng);
+  return samples;
+}
+}  // namespace
+
+TEST_CASE("RealFft-dft") {
+  for(size_t size = 2; size <= 4096; size *= 2) {
+    CAPTURE(size);
+    RealFft fft(size);
+    REQUIRE(fft.isValid());
+    REQUIRE(fft.numBins() == size / 2 + 1);
+
+    const auto input = noise(size, uint32_t(size));
+    std::vector<float> real(fft.numBins()), imag(fft.numBins());
+    fft.forward(make_array_view(input), make_span(real), make_span(imag));
+
+    // against a DFT in double precision; the error grows with the log of the size
+    auto maxError = 0.;
+    for(size_t k = 0; k < fft.numBins(); ++k) {
+      double expectedReal = 0., expectedImag = 0.;
+      for(size_t j = 0; j < size; ++j) {
+        const auto angle = -2. * kPi * double((j * k) % size) / double(size);
+        expectedReal += input[j] * std::cos(angle);
+        expectedImag += input[j] * std::sin(angle);
+      }
+      maxError = std::max(maxError, std::hypot(real[k] - expectedReal, imag[k] - expectedImag));
+    }
+    CHECK(maxError < 1e-6 * std::sqrt(double(size)) * std::log2(double(size) + 1.));
+  }
+}
+
+TEST_CASE("RealFft-roundtrip") {
+  for(size_t size : {2, 4, 8, 64, 1024, 8192}) {
+    CAPTURE(size);
+    RealFft fft(size);
+    const auto input = noise(size, 7U);
+    std::vector<float> real(fft.numBins()), imag(fft.numBins()), output(size);
+    fft.forward(make_array_view(input), make_span(real), make_span(imag));
+    fft.inverse(make_array_view(real), make_array_view(imag), make_span(output));
+    for(size_t i = 0; i < size; ++i) REQUIRE(output[i] == doctest::Approx(input[i]).epsilon(1e-5));
+  }
+}
+
+TEST_CASE("RealFft-sine") {
+  RealFft fft(256);
+  std::vector<float> input(256), real(129), imag(129), magnitudes(129);
+  for(size_t i = 0; i < 256; ++i) input[i] = float(std::cos(2. * kPi * 10. * double(i) / 256.));
+  fft.forward(make_array_view(input), make_span(real), make_span(imag));
+  magnitude(make_array_view(real), make_array_view(imag), make_span(magnitudes));
+  for(size_t k = 0; k < 129; ++k)
+    CHECK(magnitudes[k] == doctest::Approx(k == 10 ? 128. : 0.).epsilon(1e-5).scale(128.));
+}
+
+TEST_CASE("RealFft-invalid") {
+  CHECK(!RealFft().isValid());
+  CHECK(!RealFft(1).isValid());
+  CHECK(!RealFft(48).isValid());
+}
+
+}  // namespace v1util::dsp::test
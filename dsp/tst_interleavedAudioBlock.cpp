@@ -0,0 +1,82 @@
+#include "interleavedAudioBlock.hpp"
+
+#include "audioBuffer.hpp"
+#include "blockOps.hpp"
+
+#include "v1util/container/range.hpp"
+
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace v1util::dsp::test {
+
+TEST_CASE("InterleavedAudioBlock-views") {
+  std::vector<float> samples = {0.f, 10.f, 20.f, 1.f, 11.f, 21.f, 2.f, 12.f, 22.f};
+  InterleavedAudioBlock block(samples.data(), 3, 3);
+
+  auto middle = block.channel(1);
+  CHECK(middle.size() == 3U);
+  CHECK(middle.stride() == 3U);
+  CHECK(middle[2] == 12.f);
+  CHECK(std::vector<float>(middle.begin(), middle.end()) == std::vector<float>{10.f, 11.f, 12.f});
+  CHECK(middle.end() - middle.begin() == 3);
+  CHECK(*pmrange::max_element(middle) == 12.f);
+
+  for(auto& sample : block.channel(2)) sample += 1.f;
+  CHECK(samples[8] == 23.f);
+  std::reverse(block.channel(0).begin(), block.channel(0).end());
+  CHECK(samples[0] == 2.f);
+  CHECK(samples[6] == 0.f);
+
+  CHECK(block.frame(1).size() == 3U);
+  CHECK(block.frame(1)[2] == 22.f);
+  block.frame(0)[1] = -1.f;
+
+  ConstInterleavedAudioBlock constBlock = block;
+  CHECK(constBlock.channel(1)[0] == -1.f);
+  CHECK(constBlock.frame(2)[0] == 0.f);
+
+  block.clear();
+  CHECK(pmrange::all_of(samples, [](float sample) { return sample == 0.f; }));
+}
+
+TEST_CASE("InterleavedAudioBlock-transpose") {
+  for(int numChannels : {1, 2, 3, 4, 5, 8}) {
+    for(size_t numSamples : {0, 1, 63, 64, 65, 200}) {
+      std::vector<float> interleaved(size_t(numChannels) * numSamples);
+      for(size_t i = 0; i < interleaved.size(); ++i) interleaved[i] = float(i);
+
+      AudioBuffer buffer(numChannels, numSamples);
+      ops::deinterleave(ConstInterleavedAudioBlock(interleaved.data(), numChannels, numSamples),
+          buffer.audioBlock());
+      for(int chan = 0; chan < numChannels; ++chan) {
+        for(size_t i = 0; i < numSamples; ++i)
+          REQUIRE(buffer.constChannel(chan)[i] == float(i * size_t(numChannels) + size_t(chan)));
+      }
+
+      std::vector<float> back(interleaved.size(), -1.f);
+      ops::interleave(buffer.constAudioBlock(),
+          InterleavedAudioBlock(back.data(), numChannels, numSamples));
+      CHECK(back == interleaved);
+
+      // only the first channels of a wider layout
+      if(numChannels > 1) {
+        AudioBuffer first(1, numSamples);
+        ops::deinterleave(ConstInterleavedAudioBlock(interleaved.data(), numChannels, numSamples),
+            first.audioBlock());
+        if(numSamples)
+          CHECK(first.constChannel(0)[numSamples - 1]
+                == interleaved[interleaved.size() - size_t(numChannels)]);
+
+        std::fill(back.begin(), back.end(), -1.f);
+        ops::interleave(
+            first.constAudioBlock(), InterleavedAudioBlock(back.data(), numChannels, numSamples));
+        if(numSamples) CHECK(back[1] == -1.f);
+      }
+    }
+  }
+}
+
+}  // namespace v1util::dsp::test
@@ -0,0 +1,141 @@
+#include "matchedFilter.hpp"
+
+#include "audioBuffer.hpp"
+#include "chirp.hpp"
+#include "peakfinder.hpp"
+
+#include "v1util/base/thread_pool.hpp"
+
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace v1util::dsp::test {
+
+namespace {
+AudioBuffer matchedNoise(int numChannels, size_t numSamples, uint32_t seed) {
+  AudioBuffer buffer(numChannels, numSamples);
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  for(int chan = 0; chan < numChannels; ++chan)
+    for(auto& sample : buffer.channel(chan)) sample = distribution(rng);
+  return buffer;
+}
+
+//! Run all of @p input through @p filter in blocks of @p blockSize
+AudioBuffer correlateAll(MatchedFilter& filter, const AudioBuffer& input, size_t blockSize,
+    ThreadPool* pPool = nullptr) {
+  AudioBuffer output(input.numChannels(), input.numSamples());
+  std::vector<const float*> ppInput(size_t(input.numChannels()));
+  std::vector<float*> ppOutput(size_t(input.numChannels()));
+  for(size_t pos = 0; pos < input.numSamples(); pos += blockSize) {
+    const auto count = std::min(blockSize, input.numSamples() - pos);
+    for(int chan = 0; chan < input.numChannels(); ++chan) {
+      ppInput[size_t(chan)] = input.constChannel(chan).data() + pos;
+      ppOutput[size_t(chan)] = output.channel(chan).data() + pos;
+    }
+    filter.process({ppInput.data(), input.numChannels(), count},
+        {ppOutput.data(), input.numChannels(), count}, pPool);
+  }
+  return output;
+}
+}  // namespace
+
+TEST_CASE("MatchedFilter-direct") {
+  const auto input = matchedNoise(2, 3000, 5);
+  const auto templateSignal = matchedNoise(1, 37, 9);
+  const auto taps = templateSignal.constChannel(0);
+
+  for(size_t fftSize : {0, 64, 512}) {
+    MatchedFilter filter(2, taps, fftSize);
+    REQUIRE(filter.isValid());
+    CHECK(filter.templateSize() == 37);
+    CHECK(filter.hopSize() == filter.fftSize() - 36);
+    if(!fftSize) CHECK(filter.fftSize() == 128);
+
+    for(size_t blockSize : {1, 100, 3000}) {
+      CAPTURE(fftSize);
+      CAPTURE(blockSize);
+      filter.reset();
+      const auto output = correlateAll(filter, input, blockSize);
+
+      auto maxError = 0.;
+      for(int chan = 0; chan < 2; ++chan)
+        for(size_t i = 0; i < input.numSamples(); ++i) {
+          auto expected = 0.;
+          for(size_t k = 0; k < taps.size(); ++k) {
+            const auto pos = i + k - filter.latency();
+            if(pos < input.numSamples())
+              expected += double(input.constChannel(chan)[pos]) * double(taps[k]);
+          }
+          maxError = std::max(maxError, std::abs(double(output.constChannel(chan)[i]) - expected));
+        }
+      CHECK(maxError < 1e-4);
+    }
+  }
+}
+
+TEST_CASE("MatchedFilter-chirpArrivals") {
+  // a 20 ms chirp, at different times in quiet noise on two channels
+  constexpr const float kSampleRate = 48000.f;
+  ChirpGen<float> chirp(kSampleRate, 500.f, 12000.f, 0.02f, 0.002f);
+  AudioBuffer templateSignal(1, chirp.lengthSmpl());
+  chirp.fillBlock(templateSignal.channel(0));
+
+  auto input = matchedNoise(2, 24000, 13);
+  for(int chan = 0; chan < 2; ++chan)
+    for(auto& sample : input.channel(chan)) sample *= 0.1f;
+  const std::vector<std::vector<size_t>> arrivals = {{1000, 9001, 17333}, {5555, 12000}};
+  for(int chan = 0; chan < 2; ++chan)
+    for(auto arrival : arrivals[size_t(chan)])
+      for(size_t i = 0; i < templateSignal.numSamples(); ++i)
+        input.channel(chan)[arrival + i] += 0.5f * templateSignal.constChannel(0)[i];
+
+  MatchedFilter filter(2, templateSignal.constChannel(0));
+  REQUIRE(filter.isValid());
+  const auto output = correlateAll(filter, input, 480);
+
+  for(int chan = 0; chan < 2; ++chan) {
+    CAPTURE(chan);
+    StreamingPeakFinder<float> peakFinder(2 * filter.templateSize() + 1);
+    std::vector<size_t> found;
+    const auto correlation = output.constChannel(chan);
+    for(size_t pos = 0; pos < correlation.size(); pos += 480)
+      peakFinder.process(correlation.subview(pos, 480), pos,
+          float(0.25 * filter.templateEnergy()),
+          [&](const PeakFinderValueAtPos<float>& peak) {
+            found.push_back(peak.streamPos - filter.latency());
+          });
+    CHECK(found == arrivals[size_t(chan)]);
+  }
+}
+
+TEST_CASE("MatchedFilter-threadPool") {
+  const auto input = matchedNoise(5, 4000, 17);
+  const auto templateSignal = matchedNoise(1, 100, 19);
+  MatchedFilter serial(5, templateSignal.constChannel(0));
+  MatchedFilter parallel(5, templateSignal.constChannel(0));
+  ThreadPool pool(3);
+  const auto expected = correlateAll(serial, input, 333);
+  const auto output = correlateAll(parallel, input, 333, &pool);
+  for(int chan = 0; chan < 5; ++chan)
+    CHECK(std::equal(output.constChannel(chan).begin(), output.constChannel(chan).end(),
+        expected.constChannel(chan).begin()));
+}
+
+TEST_CASE("MatchedFilter-invalid") {
+  const std::vector<float> ones(100, 1.f);
+  const auto templateSignal = make_array_view(ones);
+  CHECK(!MatchedFilter().isValid());
+  CHECK(!MatchedFilter(0, templateSignal).isValid());
+  CHECK(!MatchedFilter(1, ArrayView<float>()).isValid());
+  CHECK(!MatchedFilter(1, templateSignal, 64).isValid());
+  CHECK(!MatchedFilter(1, templateSignal, 300).isValid());
+  CHECK(MatchedFilter(1, templateSignal, 128).isValid());
+}
+
+}  // namespace v1util::dsp::test
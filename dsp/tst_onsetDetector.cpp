@@ -0,0 +1,141 @@
+#include "onsetDetector.hpp"
+
+#include "audioBuffer.hpp"
+
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace v1util::dsp::test {
+
+namespace {
+constexpr const size_t kNumSamples = 48000;
+const std::vector<size_t> sQuietBursts = {4000, 9000, 14000};
+const std::vector<size_t> sLoudBursts = {32000, 38000, 44000};
+
+//! Uniform noise in [-1, 1)
+class Noise {
+ public:
+  float operator()() { return mDistribution(mRng); }
+
+ private:
+  std::mt19937 mRng{7U};
+  std::uniform_real_distribution<float> mDistribution{-1.f, 1.f};
+};
+
+/** Channel 0: noise that fades from -40 to -20 dB between 16000 and 28000, bursts 20 dB above it
+ *
+ * Channel 1: silence with one faint burst.
+ */
+AudioBuffer onsetSignal() {
+  AudioBuffer buffer(2, kNumSamples);
+  Noise noise;
+  auto channel = buffer.channel(0);
+  for(size_t i = 0; i < kNumSamples; ++i) {
+    const auto level = 0.01 * std::pow(10., std::clamp((double(i) - 16000.) / 12000., 0., 1.));
+    channel[i] = float(level) * noise();
+  }
+
+  const auto addBurst = [&](int chan, size_t start, float amplitude) {
+    for(size_t i = 0; i < 2000; ++i)
+      buffer.channel(chan)[start + i] += amplitude * float(std::exp(-double(i) / 300.)) * noise();
+  };
+  for(auto start : sQuietBursts) addBurst(0, start, 0.1f);
+  for(auto start : sLoudBursts) addBurst(0, start, 1.f);
+  addBurst(1, 10000, 0.01f);
+  return buffer;
+}
+
+using Onsets = std::vector<std::pair<int, size_t>>;
+
+Onsets detectAll(OnsetDetector& detector, const AudioBuffer& input, size_t blockSize) {
+  Onsets onsets;
+  const float* ppBlock[2];
+  for(size_t pos = 0; pos < input.numSamples(); pos += blockSize) {
+    for(int chan = 0; chan < 2; ++chan) ppBlock[chan] = input.constChannel(chan).data() + pos;
+    detector.process({ppBlock, 2, std::min(blockSize, input.numSamples() - pos)},
+        [&](int chan, const PeakFinderValueAtPos<float>& onset) {
+          onsets.emplace_back(chan, onset.streamPos);
+        });
+  }
+
+  // by channel; the peak finders report them at times that depend on the block sizes
+  std::sort(onsets.begin(), onsets.end());
+  return onsets;
+}
+}  // namespace
+
+TEST_CASE("OnsetDetector-adaptiveThreshold") {
+  const auto input = onsetSignal();
+  OnsetDetector detector(2, 2001, 2400);
+  REQUIRE(detector.isValid());
+  const auto onsets = detectAll(detector, input, 480);
+
+  // every burst, within its first 200 samples, and nothing in the noise, however loud
+  std::vector<size_t> bursts = sQuietBursts;
+  bursts.insert(bursts.end(), sLoudBursts.begin(), sLoudBursts.end());
+  REQUIRE(onsets.size() == bursts.size() + 1);
+  for(size_t i = 0; i < bursts.size(); ++i) {
+    CAPTURE(bursts[i]);
+    CHECK(onsets[i].first == 0);
+    CHECK(onsets[i].second >= bursts[i]);
+    CHECK(onsets[i].second < bursts[i] + 200);
+  }
+  CHECK(onsets.back().first == 1);
+  CHECK(onsets.back().second >= 10000);
+  CHECK(onsets.back().second < 10200);
+
+  // a fixed threshold above the quiet bursts fires in the loud noise
+  OnsetDetector fixed(2, 2001, 2400);
+  fixed.setThreshold(0., 0.f, 0.05f);
+  const auto isInNoise = [&](const std::pair<int, size_t>& onset) {
+    return std::none_of(bursts.begin(), bursts.end(),
+        [&](size_t start) { return onset.second >= start && onset.second < start + 200; });
+  };
+  const auto fixedOnsets = detectAll(fixed, input, 480);
+  CHECK(std::count_if(fixedOnsets.begin(), fixedOnsets.end(), isInNoise) > 1);
+}
+
+TEST_CASE("OnsetDetector-blockSizes") {
+  const auto input = onsetSignal();
+  OnsetDetector detector(2, 201, 2000);
+  detector.setAttackRelease(2., 50.);
+  detector.setThreshold(0.9, 1.5f, 1e-3f);
+  const auto expected = detectAll(detector, input, kNumSamples);
+  CHECK(expected.size() > 6);
+
+  for(size_t blockSize : {1, 100, 4097}) {
+    CAPTURE(blockSize);
+    detector.reset();
+    CHECK(detectAll(detector, input, blockSize) == expected);
+  }
+}
+
+TEST_CASE("OnsetDetector-threshold") {
+  OnsetDetector detector(1, 11, 1600);
+  CHECK(detector.threshold(0) == 1e-3f);
+
+  // the envelope of DC is DC
+  AudioBuffer dc(1, 3000);
+  dc.audioBlock().fill(-0.5f);
+  detector.process(dc.constAudioBlock(), [](int, const PeakFinderValueAtPos<float>&) {});
+  CHECK(detector.threshold(0) == doctest::Approx(1.001f));
+  detector.setThreshold(0.5, 1.f, 0.f);
+  CHECK(detector.threshold(0) == doctest::Approx(0.5f));
+
+  detector.reset();
+  CHECK(detector.threshold(0) == 0.f);
+}
+
+TEST_CASE("OnsetDetector-invalid") {
+  CHECK(!OnsetDetector().isValid());
+  CHECK(!OnsetDetector(0, 11, 100).isValid());
+  CHECK(!OnsetDetector(1, 2, 100).isValid());
+  CHECK(!OnsetDetector(1, 11, 0).isValid());
+}
+
+}  // namespace v1util::dsp::test
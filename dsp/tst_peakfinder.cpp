@@ -10,6 +10,7 @@
 #  include <random>
 #endif
 
+#include <cmath>
 #include <sstream>
 #include <vector>
 
@@ -836,6 +837,126 @@ TEST_CASE("StreamingPeakFinder-specialCases") {
   runPeakFinderAndCheckPeaks({9, 10, 7, 4, 9, 9, 8, 5}, 4, 2, {1});
 }
 
+TEST_CASE("interpolatePeak") {
+  // exact for parabolas and Gaussians, respectively
+  const auto parabola = [](double x) { return 3. - 2. * (x - 0.3) * (x - 0.3); };
+  auto peak =
+      interpolatePeak(parabola(-1.), parabola(0.), parabola(1.), PeakInterpolation::kParabolic);
+  CHECK(peak.offset == doctest::Approx(0.3));
+  CHECK(peak.height == doctest::Approx(3.));
+
+  const auto gaussian = [](double x) { return 2. * std::exp(-(x + 0.4) * (x + 0.4) / 2.); };
+  peak = interpolatePeak(gaussian(-1.), gaussian(0.), gaussian(1.), PeakInterpolation::kGaussian);
+  CHECK(peak.offset == doctest::Approx(-0.4));
+  CHECK(peak.height == doctest::Approx(2.));
+  peak = interpolatePeak(gaussian(-1.), gaussian(0.), gaussian(1.), PeakInterpolation::kParabolic);
+  CHECK(peak.offset < -0.3);
+  CHECK(peak.offset > -0.5);
+
+  // plateaus, and values <= 0 fall back to the parabola
+  CHECK(interpolatePeak(0., 1., 1., PeakInterpolation::kParabolic).offset == 0.5);
+  CHECK(interpolatePeak(1., 1., 1., PeakInterpolation::kGaussian).offset == 0.);
+  peak = interpolatePeak(-1., 1., 0., PeakInterpolation::kGaussian);
+  CHECK(peak.offset == doctest::Approx(1. / 6.));
+}
+
+TEST_CASE("truePeak4x") {
+  // a sine at a quarter of the sample rate, sampled 45 degrees off its crests
+  double samples[5];
+  for(size_t i = 0; i < 5; ++i) samples[i] = std::sin(kPi / 2. * (double(i) - 1.5));
+  CHECK(samples[2] == doctest::Approx(std::sqrt(0.5)));
+  CHECK(truePeak4x(samples) == doctest::Approx(0.884).epsilon(1e-3));
+
+  // never below the sample
+  const double peak[5] = {0., 1., 2., 1., 0.};
+  CHECK(truePeak4x(peak) == 2.);
+}
+
+namespace {
+constexpr const double sPulsePositions[] = {20.3, 60.7, 101.5, 140., 183.9};
+
+//! Gaussian pulses of different heights, sigma 2
+std::vector<float> pulses() {
+  std::vector<float> result(200);
+  for(size_t i = 0; i < result.size(); ++i)
+    for(size_t iPulse = 0; iPulse < std::size(sPulsePositions); ++iPulse) {
+      const auto x = double(i) - sPulsePositions[iPulse];
+      result[i] += float((1. + 0.1 * double(iPulse)) * std::exp(-x * x / 8.));
+    }
+  return result;
+}
+
+//! The peaks, and the number of blocks that were processed when they were reported
+template <typename PeakFinder, typename Peak>
+std::vector<std::pair<Peak, size_t>> runWithBlockSize(
+    PeakFinder& peakFinder, const std::vector<float>& data, size_t blockSize) {
+  std::vector<std::pair<Peak, size_t>> result;
+  size_t numBlocks = 0;
+  for(size_t pos = 0; pos < data.size(); pos += blockSize) {
+    ++numBlocks;
+    peakFinder.process(make_array_view(data).subview(pos, std::min(blockSize, data.size() - pos)),
+        pos, 0.5f, [&](const Peak& peak) { result.emplace_back(peak, numBlocks); });
+  }
+  return result;
+}
+}  // namespace
+
+TEST_CASE("SubSamplePeakFinder-positions") {
+  const auto data = pulses();
+  for(size_t blockSize : {size_t(1), size_t(7), data.size()}) {
+    CAPTURE(blockSize);
+    SubSamplePeakFinder<float> peakFinder(9, PeakInterpolation::kGaussian, true);
+    const auto peaks =
+        runWithBlockSize<SubSamplePeakFinder<float>, PeakFinderSubSamplePeak<float>>(
+            peakFinder, data, blockSize);
+    REQUIRE(peaks.size() == std::size(sPulsePositions));
+    for(size_t i = 0; i < peaks.size(); ++i) {
+      const auto& peak = peaks[i].first;
+      CAPTURE(i);
+      CHECK(peak.position == doctest::Approx(sPulsePositions[i]).epsilon(1e-5));
+      CHECK(peak.height == doctest::Approx(1. + 0.1 * double(i)).epsilon(1e-5));
+      CHECK(peak.truePeak >= double(peak.value));
+      CHECK(peak.truePeak <= peak.height + 1e-3);
+      CHECK(peak.value == data[peak.streamPos]);
+    }
+  }
+}
+
+TEST_CASE("SubSamplePeakFinder-latency") {
+  // peaks at the end of blocks
+  std::vector<float> data(64);
+  for(size_t i = 3; i < data.size(); i += 6) data[i] = 1.f;
+
+  for(size_t patternSize : {3, 5, 11}) {
+    for(size_t blockSize : {1, 4, 5}) {
+      CAPTURE(patternSize);
+      CAPTURE(blockSize);
+      StreamingPeakFinder<float> plain(patternSize);
+      const auto expected =
+          runWithBlockSize<StreamingPeakFinder<float>, PeakFinderValueAtPos<float>>(
+              plain, data, blockSize);
+      REQUIRE(!expected.empty());
+
+      for(bool withTruePeak : {false, true}) {
+        CAPTURE(withTruePeak);
+        SubSamplePeakFinder<float> peakFinder(
+            patternSize, PeakInterpolation::kParabolic, withTruePeak);
+        const auto peaks =
+            runWithBlockSize<SubSamplePeakFinder<float>, PeakFinderSubSamplePeak<float>>(
+                peakFinder, data, blockSize);
+        // the last peak may still wait for its samples after the end
+        REQUIRE(peaks.size() >= expected.size() - 1);
+        for(size_t i = 0; i < peaks.size(); ++i) {
+          CHECK(peaks[i].first.streamPos == expected[i].first.streamPos);
+          const auto delay = withTruePeak && patternSize == 3 ? 1 : 0;
+          CHECK(peaks[i].second <= expected[i].second + delay);
+          CHECK(peaks[i].first.position == double(peaks[i].first.streamPos));
+        }
+      }
+    }
+  }
+}
+
 #ifdef V1_PEAKFINDER_FUZZING
 TEST_CASE("StreamingPeakFinder-fuzzing") {
   std::random_device rd;
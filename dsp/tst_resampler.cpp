@@ -0,0 +1,136 @@
+#include "resampler.hpp"
+
+#include "audioBuffer.hpp"
+#include "blockOps.hpp"
+
+#include "v1util/base/math.hpp"
+#include "v1util/base/thread_pool.hpp"
+#include "v1util/container/range.hpp"
+
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace v1util::dsp::test {
+
+namespace {
+//! A sine of @p freqHz at @p sampleRate, with a different phase per channel
+AudioBuffer sineBuffer(int numChannels, size_t numSamples, double sampleRate, double freqHz) {
+  AudioBuffer buffer(numChannels, numSamples);
+  for(int chan = 0; chan < numChannels; ++chan)
+    for(size_t i = 0; i < numSamples; ++i)
+      buffer.channel(chan)[i] =
+          float(std::sin(2. * kPi * freqHz * double(i) / sampleRate + double(chan)));
+  return buffer;
+}
+
+//! All output for @p input, in blocks of @p blockSize
+AudioBuffer resampleAll(
+    Resampler& resampler, ConstAudioBlock input, size_t blockSize, ThreadPool* pPool = nullptr) {
+  AudioBuffer output(input.numChannels, resampler.maxNumOutputSamples(input.numSamples));
+  AudioBuffer inputBlock(input.numChannels, blockSize);
+  AudioBuffer outputBlock(input.numChannels, resampler.maxNumOutputSamples(blockSize));
+  size_t numOutputs = 0;
+  for(size_t pos = 0; pos < input.numSamples; pos += blockSize) {
+    const auto count = std::min(blockSize, input.numSamples - pos);
+    for(int chan = 0; chan < input.numChannels; ++chan)
+      std::copy_n(input.channel(chan).data() + pos, count, inputBlock.channel(chan).data());
+    const auto numNew = resampler.process(
+        {inputBlock.constAudioBlock().ppBuffer, input.numChannels, count},
+        outputBlock.audioBlock(), pPool);
+    REQUIRE(numNew <= resampler.maxNumOutputSamples(count));
+    for(int chan = 0; chan < input.numChannels; ++chan)
+      std::copy_n(outputBlock.constChannel(chan).data(), numNew,
+          output.channel(chan).data() + numOutputs);
+    numOutputs += numNew;
+  }
+
+  AudioBuffer result(input.numChannels, numOutputs);
+  for(int chan = 0; chan < input.numChannels; ++chan)
+    std::copy_n(output.constChannel(chan).data(), numOutputs, result.channel(chan).data());
+  return result;
+}
+
+//! The largest deviation from a sine of @p freqHz, ignoring @p margin samples at either end
+double maxSineError(ConstAudioBlock output, double sampleRate, double freqHz, size_t margin) {
+  auto maxError = 0.;
+  for(int chan = 0; chan < output.numChannels; ++chan)
+    for(size_t i = margin; i + margin < output.numSamples; ++i) {
+      const auto expected = std::sin(2. * kPi * freqHz * double(i) / sampleRate + double(chan));
+      maxError = std::max(maxError, std::abs(output.channel(chan)[i] - expected));
+    }
+  return maxError;
+}
+}  // namespace
+
+TEST_CASE("Resampler-sine") {
+  for(auto rates : {std::pair{44100., 48000.}, std::pair{48000., 44100.}, std::pair{48000., 96000.},
+          std::pair{96000., 48000.}, std::pair{44100., 44101.}, std::pair{48000., 48000.}}) {
+    CAPTURE(rates.first);
+    CAPTURE(rates.second);
+    const auto input = sineBuffer(2, 20000, rates.first, 1000.);
+    Resampler resampler(rates.first, rates.second, 2);
+    REQUIRE(resampler.isValid());
+    CHECK(resampler.numTaps() % 8 == 0U);
+
+    const auto output = resampleAll(resampler, input.constAudioBlock(), 1000);
+    // all but the latency
+    const auto expectedCount = 20000. * rates.second / rates.first - resampler.latency();
+    CHECK(std::abs(double(output.numSamples()) - expectedCount) <= 2.);
+    CHECK(maxSineError(output.constAudioBlock(), rates.second, 1000.,
+              size_t(resampler.latency()) + 1)
+          < 1e-3);
+  }
+}
+
+TEST_CASE("Resampler-blockSizes") {
+  const auto input = sineBuffer(3, 10000, 44100., 3000.);
+  Resampler resampler(44100., 48000., 3);
+  const auto whole = resampleAll(resampler, input.constAudioBlock(), 10000);
+
+  for(size_t blockSize : {1, 7, 64, 1001}) {
+    resampler.reset();
+    const auto blocks = resampleAll(resampler, input.constAudioBlock(), blockSize);
+    REQUIRE(blocks.numSamples() == whole.numSamples());
+    for(int chan = 0; chan < 3; ++chan)
+      CHECK(pmrange::equal(blocks.constChannel(chan), whole.constChannel(chan)));
+  }
+}
+
+TEST_CASE("Resampler-antiAliasing") {
+  // 30 kHz is above the output Nyquist frequency; downsampling must remove it
+  const auto input = sineBuffer(1, 20000, 96000., 30000.);
+  Resampler resampler(96000., 48000., 1);
+  const auto output = resampleAll(resampler, input.constAudioBlock(), 512);
+  const auto margin = size_t(resampler.latency()) + 1;
+  CHECK(ops::peak({output.constChannel(0).data() + margin, output.numSamples() - 2 * margin})
+        < 1e-4f);
+
+  // and upsampling must not mirror 18 kHz at 48 kHz into 30 kHz
+  const auto low = sineBuffer(1, 20000, 48000., 18000.);
+  Resampler upsampler(48000., 96000., 1);
+  const auto upsampled = resampleAll(upsampler, low.constAudioBlock(), 512);
+  CHECK(maxSineError(upsampled.constAudioBlock(), 96000., 18000., 200) < 1e-3);
+}
+
+TEST_CASE("Resampler-threadPool") {
+  const auto input = sineBuffer(8, 5000, 44100., 440.);
+  Resampler serial(44100., 48000., 8);
+  Resampler parallel(44100., 48000., 8);
+  ThreadPool pool(3);
+  const auto serialOutput = resampleAll(serial, input.constAudioBlock(), 256);
+  const auto parallelOutput = resampleAll(parallel, input.constAudioBlock(), 256, &pool);
+  REQUIRE(parallelOutput.numSamples() == serialOutput.numSamples());
+  for(int chan = 0; chan < 8; ++chan)
+    CHECK(pmrange::equal(parallelOutput.constChannel(chan), serialOutput.constChannel(chan)));
+}
+
+TEST_CASE("Resampler-invalid") {
+  CHECK(!Resampler().isValid());
+  CHECK(!Resampler(0., 48000., 1).isValid());
+  CHECK(!Resampler(48000., 44100., 0).isValid());
+}
+
+}  // namespace v1util::dsp::test
@@ -0,0 +1,110 @@
+#include "slidingWindowStats.hpp"
+
+#include "audioBuffer.hpp"
+
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace v1util::dsp::test {
+
+namespace {
+SlidingWindowValues bruteForce(const float* pSamples, size_t end, size_t windowSize) {
+  const auto begin = end > windowSize ? end - windowSize : 0;
+  SlidingWindowValues result;
+  result.min = *std::min_element(pSamples + begin, pSamples + end);
+  result.max = *std::max_element(pSamples + begin, pSamples + end);
+  double sum = 0., sumSq = 0.;
+  for(auto i = begin; i < end; ++i) {
+    sum += pSamples[i];
+    sumSq += double(pSamples[i]) * pSamples[i];
+  }
+  const auto count = double(end - begin);
+  result.mean = float(sum / count);
+  result.rms = float(std::sqrt(sumSq / count));
+  double m2 = 0.;
+  for(auto i = begin; i < end; ++i) m2 += (pSamples[i] - sum / count) * (pSamples[i] - sum / count);
+  result.variance = float(m2 / count);
+  return result;
+}
+
+AudioBuffer makeSignal(int numChannels, size_t numSamples, float offset) {
+  AudioBuffer buffer(numChannels, numSamples);
+  std::mt19937 rng(0xABCDU);
+  std::uniform_real_distribution<float> distribution(-0.5f, 0.5f);
+  for(int chan = 0; chan < numChannels; ++chan)
+    for(auto& sample : buffer.channel(chan))
+      sample = offset + float(chan + 1) * distribution(rng);
+  return buffer;
+}
+}  // namespace
+
+TEST_CASE("SlidingWindowStats-per_sample") {
+  constexpr const size_t kNumSamples = 1000;
+  const auto input = makeSignal(2, kNumSamples, 0.25f);
+
+  for(size_t windowSize : {1, 7, 64, 2000}) {
+    SlidingWindowStats stats(2, windowSize);
+    AudioBuffer min(2, kNumSamples), max(2, kNumSamples), mean(2, kNumSamples),
+        rms(2, kNumSamples), variance(2, kNumSamples);
+
+    // odd block sizes, across segment boundaries
+    size_t offset = 0;
+    for(size_t blockSize = 1; offset < kNumSamples; blockSize = blockSize * 3 % 97 + 1) {
+      const auto count = std::min(blockSize, kNumSamples - offset);
+      const float* ppIn[] = {input.constChannel(0).data() + offset,
+          input.constChannel(1).data() + offset};
+      auto subBlock = [&](AudioBuffer& buffer, float** ppChannels) {
+        ppChannels[0] = buffer.channel(0).data() + offset;
+        ppChannels[1] = buffer.channel(1).data() + offset;
+        return AudioBlock(ppChannels, 2, count);
+      };
+      float* ppMin[2], *ppMax[2], *ppMean[2], *ppRms[2], *ppVariance[2];
+      stats.process(ConstAudioBlock(ppIn, 2, count),
+          {subBlock(min, ppMin), subBlock(max, ppMax), subBlock(mean, ppMean),
+              subBlock(rms, ppRms), subBlock(variance, ppVariance)});
+      offset += count;
+    }
+
+    for(int chan = 0; chan < 2; ++chan) {
+      const auto* pIn = input.constChannel(chan).data();
+      for(size_t i = 0; i < kNumSamples; ++i) {
+        const auto expected = bruteForce(pIn, i + 1, windowSize);
+        REQUIRE(min.channel(chan)[i] == expected.min);
+        REQUIRE(max.channel(chan)[i] == expected.max);
+        REQUIRE(mean.channel(chan)[i] == doctest::Approx(expected.mean).epsilon(1e-5));
+        REQUIRE(rms.channel(chan)[i] == doctest::Approx(expected.rms).epsilon(1e-5));
+        REQUIRE(variance.channel(chan)[i] == doctest::Approx(expected.variance).epsilon(1e-4));
+      }
+
+      const auto current = stats.current(chan);
+      const auto expected = bruteForce(pIn, kNumSamples, windowSize);
+      CHECK(current.min == expected.min);
+      CHECK(current.max == expected.max);
+      CHECK(current.mean == doctest::Approx(expected.mean).epsilon(1e-5));
+    }
+  }
+}
+
+TEST_CASE("SlidingWindowStats-no_drift") {
+  // a large DC offset with small variations over many windows
+  constexpr const size_t kNumSamples = 1U << 18;
+  constexpr const size_t kWindowSize = 100;
+  const auto input = makeSignal(1, kNumSamples, 1000.f);
+
+  SlidingWindowStats stats(1, kWindowSize);
+  stats.process(input.constAudioBlock());
+
+  const auto current = stats.current(0);
+  const auto expected = bruteForce(input.constChannel(0).data(), kNumSamples, kWindowSize);
+  CHECK(current.mean == doctest::Approx(expected.mean).epsilon(1e-6));
+  CHECK(current.variance == doctest::Approx(expected.variance).epsilon(1e-3));
+
+  stats.reset();
+  CHECK(stats.current(0).max == 0.f);
+}
+
+}  // namespace v1util::dsp::test
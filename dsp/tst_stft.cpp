@@ -0,0 +1,121 @@
+#include "stft.hpp"
+
+#include "audioBuffer.hpp"
+#include "peakfinder.hpp"
+
+#include "v1util/base/math.hpp"
+
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace v1util::dsp::test {
+
+namespace {
+AudioBuffer noiseBuffer(int numChannels, size_t numSamples) {
+  AudioBuffer buffer(numChannels, numSamples);
+  std::mt19937 rng(3U);
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  for(int chan = 0; chan < numChannels; ++chan)
+    for(auto& sample : buffer.channel(chan)) sample = distribution(rng);
+  return buffer;
+}
+
+//! Run all of @p input through @p stft in blocks of @p blockSize
+template <typename Invokable>
+AudioBuffer processAll(Stft& stft, const AudioBuffer& input, size_t blockSize, Invokable handler) {
+  AudioBuffer output(input.numChannels(), input.numSamples());
+  std::vector<const float*> ppInput(size_t(input.numChannels()));
+  std::vector<float*> ppOutput(size_t(input.numChannels()));
+  for(size_t pos = 0; pos < input.numSamples(); pos += blockSize) {
+    const auto count = std::min(blockSize, input.numSamples() - pos);
+    for(int chan = 0; chan < input.numChannels(); ++chan) {
+      ppInput[size_t(chan)] = input.constChannel(chan).data() + pos;
+      ppOutput[size_t(chan)] = output.channel(chan).data() + pos;
+    }
+    stft.process({ppInput.data(), input.numChannels(), count},
+        {ppOutput.data(), input.numChannels(), count}, handler);
+  }
+  return output;
+}
+}  // namespace
+
+TEST_CASE("Stft-reconstruction") {
+  const auto input = noiseBuffer(2, 5000);
+  for(auto sizes : {std::pair<size_t, size_t>{256, 128}, {256, 64}, {1024, 256}}) {
+    for(size_t blockSize : {1, 100, 5000}) {
+      CAPTURE(sizes.first);
+      CAPTURE(blockSize);
+      Stft stft(2, sizes.first, sizes.second);
+      REQUIRE(stft.isValid());
+
+      size_t numFrames = 0;
+      const auto output = processAll(stft, input, blockSize, [&](const StftFrame& frame) {
+        CHECK(frame.index == numFrames);
+        CHECK(frame.real.numSamples == sizes.first / 2 + 1);
+        ++numFrames;
+      });
+      CHECK(numFrames == 5000 / sizes.second);
+
+      // the input, delayed
+      const auto latency = stft.latency();
+      for(int chan = 0; chan < 2; ++chan) {
+        for(size_t i = 0; i < latency; ++i)
+          REQUIRE(output.constChannel(chan)[i] == doctest::Approx(0.).epsilon(1e-5));
+        for(size_t i = latency; i < 5000; ++i)
+          REQUIRE(output.constChannel(chan)[i]
+                  == doctest::Approx(input.constChannel(chan)[i - latency]).epsilon(1e-5));
+      }
+    }
+  }
+}
+
+TEST_CASE("Stft-modification") {
+  const auto input = noiseBuffer(1, 4000);
+  Stft stft(1, 512, 128);
+  const auto output = processAll(stft, input, 333, [](StftFrame& frame) {
+    frame.real.applyGain(0.5f);
+    frame.imag.applyGain(0.5f);
+  });
+  for(size_t i = 512; i < 4000; ++i)
+    REQUIRE(output.constChannel(0)[i]
+            == doctest::Approx(0.5f * input.constChannel(0)[i - 512]).epsilon(1e-5));
+}
+
+TEST_CASE("Stft-spectralPeaks") {
+  // two sines in the middle of bins 20 and 70, found by the peak finder in every frame
+  constexpr const size_t kFftSize = 512;
+  AudioBuffer input(1, 4096);
+  for(size_t i = 0; i < 4096; ++i)
+    input.channel(0)[i] = float(std::sin(2. * kPi * 20. * double(i) / kFftSize)
+                                + 0.3 * std::sin(2. * kPi * 70. * double(i) / kFftSize));
+
+  Stft stft(1, kFftSize, kFftSize / 4);
+  std::vector<float> power(stft.numBins());
+  size_t numFrames = 0;
+  stft.analyze(input.constAudioBlock(), [&](StftFrame& frame) {
+    if(frame.index < 3) return;  // not all input yet
+    dsp::power(frame.real.channel(0), frame.imag.channel(0), make_span(power));
+
+    std::vector<size_t> peakBins;
+    StreamingPeakFinder<float> peakFinder(9);
+    peakFinder.process(make_array_view(power), 0, 1.f,
+        [&](const PeakFinderValueAtPos<float>& peak) { peakBins.push_back(peak.streamPos); });
+    CHECK(peakBins == std::vector<size_t>{20, 70});
+    ++numFrames;
+  });
+  CHECK(numFrames == 4096 / 128 - 3);
+}
+
+TEST_CASE("Stft-invalid") {
+  CHECK(!Stft().isValid());
+  CHECK(!Stft(0, 256, 64).isValid());
+  CHECK(!Stft(1, 250, 50).isValid());
+  CHECK(!Stft(1, 256, 256).isValid());
+  CHECK(!Stft(1, 256, 48).isValid());
+}
+
+}  // namespace v1util::dsp::test
@@ -1,12 +1,19 @@
 #include "waveIo.hpp"
 
 #include "audioBuffer.hpp"
+#include "peakfinder.hpp"
 
+#include "v1util/base/math.hpp"
 #include "v1util/container/range.hpp"
 #include "v1util/stl-plus/filesystem.hpp"
 
 #include "doctest/doctest.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
 namespace v1util::dsp::io::test {
 
 TEST_CASE("WaveReader-1channel") {
@@ -80,4 +87,92 @@ TEST_CASE("Wave-roundtrip") {
   CHECK(pmrange::approxEqual(buf.channel(2), samples3, 4e-5f));
 }
 
+TEST_CASE("WaveReader-sampleTypes") {
+  auto samples = {0.f, -0.2f, -0.5f, -0.3f, 0.3f, 1.f, 0.f, -1.f};
+
+  for(auto filename : {"wave-1ch-PCM16.wav", "wave-1ch-PCM32.wav", "wave-1ch-float32.wav"}) {
+    BasicAudioBuffer<int16_t> ints16(1, 8);
+    BasicAudioBuffer<double> doubles(1, 8);
+    CHECK(WaveReader(testFilesPath() / "dsp" / filename).read(ints16.audioBlock()) == 8);
+    CHECK(WaveReader(testFilesPath() / "dsp" / filename).read(doubles.audioBlock()) == 8);
+
+    auto iSample = samples.begin();
+    for(size_t i = 0; i < 8; ++i, ++iSample) {
+      CHECK(std::abs(ints16.constChannel(0)[i] - *iSample * 0x7FFF) <= 1.f);
+      CHECK(doubles.constChannel(0)[i] == doctest::Approx(*iSample).epsilon(4e-5));
+    }
+  }
+}
+
+TEST_CASE("WaveReader-int16_peaks") {
+  // 16 bit samples stay 16 bit all the way to the peak finder
+  BasicAudioBuffer<int16_t> buf(1, 8);
+  auto reader = WaveReader(testFilesPath() / "dsp/wave-1ch-PCM16.wav");
+  CHECK(reader.read(buf.audioBlock()) == 8);
+
+  std::vector<PeakFinderValueAtPos<int16_t>> peaks;
+  StreamingPeakFinder<int16_t> peakFinder(3);
+  peakFinder.process(buf.constChannel(0), 0, int16_t(0x4000),
+      [&](const PeakFinderValueAtPos<int16_t>& peak) { peaks.push_back(peak); });
+  REQUIRE(peaks.size() == 1U);
+  CHECK(peaks[0].streamPos == 5U);
+  CHECK(peaks[0].value == 0x7FFF);
+
+  // and back into a file, unchanged
+  WaveInfo format = reader.format();
+  auto writer = WaveWriter(std::tmpfile(), format);
+  CHECK(writer.write(buf.constAudioBlock()));
+  auto pFile = writer.release();
+  ::fseek(pFile, 0, SEEK_SET);
+
+  BasicAudioBuffer<int16_t> readBack(1, 8);
+  CHECK(WaveReader(pFile).read(readBack.audioBlock()) == 8);
+  CHECK(pmrange::equal(readBack.constChannel(0), buf.constChannel(0)));
+}
+
+TEST_CASE("ResamplingWaveReader") {
+  WaveInfo format;
+  format.sampleRate = 44100.;
+  format.numChannels = 2;
+  format.isFloatingPoint = true;
+  format.bitsPerSample = 32;
+
+  AudioBuffer sine(2, 44100);
+  for(int chan = 0; chan < 2; ++chan)
+    for(size_t i = 0; i < 44100; ++i)
+      sine.channel(chan)[i] = float(std::sin(2. * kPi * 1000. * double(i) / 44100. + chan));
+
+  auto writer = WaveWriter(std::tmpfile(), format);
+  CHECK(writer.write(sine.audioBlock()));
+  auto pFile = writer.release();
+  ::fseek(pFile, 0, SEEK_SET);
+
+  auto reader = ResamplingWaveReader(WaveReader(pFile), 48000.);
+  REQUIRE(reader.isOpen());
+  CHECK(reader.format().sampleRate == 48000.);
+  CHECK(reader.format().numChannels == 2U);
+  REQUIRE(reader.format().numSamples == 48000U);
+
+  AudioBuffer resampled(2, 50000);
+  AudioBuffer block(2, 1000);
+  size_t numRead = 0;
+  while(!reader.empty()) {
+    const auto count = reader.read(block.audioBlock());
+    REQUIRE(count > 0U);
+    for(int chan = 0; chan < 2; ++chan)
+      std::copy_n(block.constChannel(chan).data(), count, resampled.channel(chan).data() + numRead);
+    numRead += count;
+  }
+  CHECK(numRead == 48000U);
+  CHECK(reader.samplePos() == 48000U);
+
+  auto maxError = 0.;
+  for(int chan = 0; chan < 2; ++chan)
+    for(size_t i = 100; i < 47900; ++i) {
+      const auto expected = std::sin(2. * kPi * 1000. * double(i) / 48000. + chan);
+      maxError = std::max(maxError, std::abs(resampled.constChannel(chan)[i] - expected));
+    }
+  CHECK(maxError < 1e-3);
+}
+
 }  // namespace v1util::dsp::io::test
@@ -1,5 +1,7 @@
 #include "waveIo.hpp"
 
+#include "blockOps.hpp"
+
 #include "v1util/base/alloca.hpp"
 #include "v1util/base/debug.hpp"
 #include "v1util/base/endianness.hpp"
@@ -8,6 +10,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <type_traits>
 
 
 namespace v1util::dsp::io {
@@ -155,84 +158,111 @@ bool writeWaveInfo(FILE* pFile, const v1util::dsp::io::WaveInfo& info) {
   return K(OK);
 }
 
-template <typename T, typename SignedT, uint32_t FullScaleValue>
+/* T is how samples are stored in the file, FileSample what they mean, e.g. uint16_t and int16_t */
+
+//! Samples of all channels that are converted at a time, so that they stay in the L1 cache
+constexpr const size_t kConversionTileValues = 4096;
+
+template <typename T, typename FileSample, typename Sample>
 void deinterleaveAndConvertAudio(ArrayView<T> interleavedSource,
     unsigned int numSourceChannels,
-    AudioBlock deinterleavedTarget,
+    BasicAudioBlock<Sample> deinterleavedTarget,
     size_t targetOffset) {
+  static_assert(sizeof(T) == sizeof(FileSample));
+  static_assert(V1_ENDIANNESS == V1_ENDIANNESS_LITTLE);
   V1_ASSUME(deinterleavedTarget.numChannels > 0);
   V1_ASSERT(interleavedSource.size() <= numSourceChannels * deinterleavedTarget.numSamples);
   V1_ASSERT(interleavedSource.size() % size_t(deinterleavedTarget.numChannels) == 0);
-  auto numSamples = interleavedSource.size() / size_t(numSourceChannels);
-
-  /*
-   * Scatter samples by channel, since we assume numChannels < numSamples and
-   * thus a smaller stride when iterating over all samples of one channel.
-   * Also, we don't assume that channel pointers in deinterleavedTarget have
-   * the same stride.
-   */
-  auto iSourceBegin = interleavedSource.begin();
-  for(int chan = 0; chan < deinterleavedTarget.numChannels; ++chan) {
-    auto iSource = iSourceBegin + chan;
-    auto iTarget = deinterleavedTarget.channel(chan).begin() + targetOffset;
-    for(size_t i = 0; i < numSamples; ++i)
-      if constexpr(FullScaleValue == 0) {
-        static_assert(V1_ENDIANNESS == V1_ENDIANNESS_LITTLE);
-        *(iTarget + i) = *(iSource + i * numSourceChannels);
-      } else {
-        auto nativeSample = le2nat(*(iSource + i * numSourceChannels));
-        if constexpr(sizeof(T) < 4)
-          *(iTarget + i) = float(SignedT(nativeSample)) / float(FullScaleValue);
-        else
-          *(iTarget + i) = float(double(SignedT(nativeSample)) / double(FullScaleValue));
-      }
+  const auto numSamples = interleavedSource.size() / size_t(numSourceChannels);
+  const auto numChannels = deinterleavedTarget.numChannels;
+  const auto* pSource = reinterpret_cast<const FileSample*>(interleavedSource.data());
+
+  auto ppTarget = (Sample**)V1_ALLOCA(sizeof(Sample*) * size_t(numChannels));
+  for(int chan = 0; chan < numChannels; ++chan)
+    ppTarget[chan] = deinterleavedTarget.ppBuffer[chan] + targetOffset;
+
+  if constexpr(std::is_same_v<FileSample, Sample>) {
+    // nothing to convert, only to transpose
+    ops::deinterleave(
+        BasicConstInterleavedAudioBlock<Sample>(pSource, int(numSourceChannels), numSamples),
+        BasicAudioBlock<Sample>(ppTarget, numChannels, numSamples));
+  } else {
+    // transpose a tile into scratch channels, then convert them channel by channel
+    const auto tileSize = std::max(kConversionTileValues / size_t(numChannels), size_t(1));
+    auto pScratch = (FileSample*)V1_ALLOCA(sizeof(FileSample) * tileSize * size_t(numChannels));
+    auto ppScratch = (FileSample**)V1_ALLOCA(sizeof(FileSample*) * size_t(numChannels));
+    for(int chan = 0; chan < numChannels; ++chan)
+      ppScratch[chan] = pScratch + size_t(chan) * tileSize;
+
+    for(size_t begin = 0; begin < numSamples; begin += tileSize) {
+      const auto count = std::min(tileSize, numSamples - begin);
+      BasicAudioBlock<FileSample> scratch(ppScratch, numChannels, count);
+      ops::deinterleave(BasicConstInterleavedAudioBlock<FileSample>(
+                            pSource + begin * numSourceChannels, int(numSourceChannels), count),
+          scratch);
+      ops::convert(BasicConstAudioBlock<FileSample>(scratch),
+          BasicAudioBlock<Sample>(ppTarget, numChannels, count));
+      for(int chan = 0; chan < numChannels; ++chan) ppTarget[chan] += count;
+    }
   }
 }
 
-template <typename T, typename SignedT, uint32_t FullScaleValue>
-void convertAndInterleaveAudio(
-    ConstAudioBlock deinterleavedSource, size_t sourceOffset, Span<T> interleavedTarget) {
+template <typename T, typename FileSample, typename Sample>
+void convertAndInterleaveAudio(BasicConstAudioBlock<Sample> deinterleavedSource,
+    size_t sourceOffset,
+    Span<T> interleavedTarget) {
+  static_assert(sizeof(T) == sizeof(FileSample));
+  static_assert(V1_ENDIANNESS == V1_ENDIANNESS_LITTLE);
   V1_ASSUME(deinterleavedSource.numChannels > 0);
   V1_ASSERT(
       interleavedTarget.size() <= deinterleavedSource.numChannels * deinterleavedSource.numSamples);
   V1_ASSERT(interleavedTarget.size() % size_t(deinterleavedSource.numChannels) == 0);
-  auto numSamples = interleavedTarget.size() / size_t(deinterleavedSource.numChannels);
-
-  /* Gather samples by channel, see deinterleaveAndConvertAudio. */
-  auto iTargetBegin = interleavedTarget.begin();
-  for(int chan = 0; chan < deinterleavedSource.numChannels; ++chan) {
-    auto iTarget = iTargetBegin + chan;
-    auto iSource = deinterleavedSource.channel(chan).begin() + sourceOffset;
-    for(size_t i = 0; i < numSamples; ++i)
-      if constexpr(FullScaleValue == 0) {
-        static_assert(V1_ENDIANNESS == V1_ENDIANNESS_LITTLE);
-        *(iTarget + i * deinterleavedSource.numChannels) = *(iSource + i);
-      } else {
-        T nativeSample;
-        if constexpr(sizeof(T) < 4)
-          nativeSample = T(SignedT(*(iSource + i) * float(FullScaleValue)));
-        else
-          nativeSample = T(SignedT(double(*(iSource + i)) * double(FullScaleValue)));
-        *(iTarget + i * deinterleavedSource.numChannels) = nat2le(nativeSample);
-      }
+  const auto numChannels = deinterleavedSource.numChannels;
+  const auto numSamples = interleavedTarget.size() / size_t(numChannels);
+  auto* pTarget = reinterpret_cast<FileSample*>(interleavedTarget.data());
+
+  auto ppSource = (const Sample**)V1_ALLOCA(sizeof(Sample*) * size_t(numChannels));
+  for(int chan = 0; chan < numChannels; ++chan)
+    ppSource[chan] = deinterleavedSource.ppBuffer[chan] + sourceOffset;
+
+  if constexpr(std::is_same_v<FileSample, Sample>) {
+    ops::interleave(BasicConstAudioBlock<Sample>(ppSource, numChannels, numSamples),
+        BasicInterleavedAudioBlock<Sample>(pTarget, numChannels, numSamples));
+  } else {
+    /* Convert into scratch channels, then transpose, see deinterleaveAndConvertAudio. */
+    const auto tileSize = std::max(kConversionTileValues / size_t(numChannels), size_t(1));
+    auto pScratch = (FileSample*)V1_ALLOCA(sizeof(FileSample) * tileSize * size_t(numChannels));
+    auto ppScratch = (FileSample**)V1_ALLOCA(sizeof(FileSample*) * size_t(numChannels));
+    for(int chan = 0; chan < numChannels; ++chan)
+      ppScratch[chan] = pScratch + size_t(chan) * tileSize;
+
+    for(size_t begin = 0; begin < numSamples; begin += tileSize) {
+      const auto count = std::min(tileSize, numSamples - begin);
+      BasicAudioBlock<FileSample> scratch(ppScratch, numChannels, count);
+      ops::convert(BasicConstAudioBlock<Sample>(ppSource, numChannels, count), scratch);
+      ops::interleave(BasicConstAudioBlock<FileSample>(scratch),
+          BasicInterleavedAudioBlock<FileSample>(
+              pTarget + begin * size_t(numChannels), numChannels, count));
+      for(int chan = 0; chan < numChannels; ++chan) ppSource[chan] += count;
+    }
   }
 }
 
 
-template <typename T, typename SignedT, uint32_t FullScaleValue>
+template <typename T, typename FileSample, typename Sample>
 size_t readDeinterleaveConvert(FILE* pSource,
     Span<T>
         buffer,
     size_t numSamples,
     unsigned int numSourceChannels,
-    AudioBlock target) {
+    BasicAudioBlock<Sample> target) {
   size_t samplesRead = 0;
   while(samplesRead < numSamples) {
     auto bytesReadIntoBuffer = ::fread(buffer.data(), 1, buffer.size() * sizeof(T), pSource);
     auto samplesReadIntoBuffer = bytesReadIntoBuffer / (sizeof(T) * size_t(numSourceChannels));
     if(!samplesReadIntoBuffer) return samplesRead;
 
-    deinterleaveAndConvertAudio<T, SignedT, FullScaleValue>(
+    deinterleaveAndConvertAudio<T, FileSample>(
         buffer.view().first(samplesReadIntoBuffer * numSourceChannels),
         numSourceChannels,
         target,
@@ -244,15 +274,14 @@ size_t readDeinterleaveConvert(FILE* pSource,
   return samplesRead;
 }
 
-template <typename T, typename SignedT, uint32_t FullScaleValue>
-bool convertInterleaveWrite(ConstAudioBlock source, Span<T> buffer, FILE* pTarget) {
+template <typename T, typename FileSample, typename Sample>
+bool convertInterleaveWrite(BasicConstAudioBlock<Sample> source, Span<T> buffer, FILE* pTarget) {
   auto numSamples = size_t(source.numSamples);
   size_t samplesWritten = 0;
   while(samplesWritten < numSamples) {
     auto valuesToWrite =
         std::min(source.numChannels * (numSamples - samplesWritten), buffer.size());
-    convertAndInterleaveAudio<T, SignedT, FullScaleValue>(
-        source, samplesWritten, buffer.first(valuesToWrite));
+    convertAndInterleaveAudio<T, FileSample>(source, samplesWritten, buffer.first(valuesToWrite));
 
     auto valuesWritten = ::fwrite(buffer.data(), sizeof(T), valuesToWrite, pTarget);
     if(valuesWritten != valuesToWrite) return !K(OK);
@@ -305,7 +334,8 @@ WaveReader& WaveReader::operator=(WaveReader&& other) noexcept {
 }
 
 
-decltype(AudioBlock::numSamples) WaveReader::read(AudioBlock target) {
+template <typename Sample>
+decltype(AudioBlock::numSamples) WaveReader::read(BasicAudioBlock<Sample> target) {
   if(!mpFile) {
     V1_INVALID();
     return 0;
@@ -331,18 +361,18 @@ decltype(AudioBlock::numSamples) WaveReader::read(AudioBlock target) {
     break;
 
   case 16:
-    samplesRead = readDeinterleaveConvert<uint16_t, int16_t, 0x7FFFU>(toFile(mpFile),
+    samplesRead = readDeinterleaveConvert<uint16_t, int16_t>(toFile(mpFile),
         Span<uint16_t>((uint16_t*)pBuffer, bufferSizeB / bytesPerValue), numSamplesToRead,
         mInfo.numChannels, target);
     break;
 
   case 32:
     if(mInfo.isFloatingPoint)
-      samplesRead = readDeinterleaveConvert<float, float, 0U>(toFile(mpFile),
+      samplesRead = readDeinterleaveConvert<float, float>(toFile(mpFile),
           Span<float>((float*)pBuffer, bufferSizeB / bytesPerValue), numSamplesToRead,
           mInfo.numChannels, target);
     else
-      samplesRead = readDeinterleaveConvert<uint32_t, int32_t, 0x7FFF'FFFFUL>(toFile(mpFile),
+      samplesRead = readDeinterleaveConvert<uint32_t, int32_t>(toFile(mpFile),
           Span<uint32_t>((uint32_t*)pBuffer, bufferSizeB / bytesPerValue), numSamplesToRead,
           mInfo.numChannels, target);
     break;
@@ -354,6 +384,11 @@ decltype(AudioBlock::numSamples) WaveReader::read(AudioBlock target) {
   return (unsigned int)samplesRead;
 }
 
+template size_t WaveReader::read(BasicAudioBlock<int16_t>);
+template size_t WaveReader::read(BasicAudioBlock<int32_t>);
+template size_t WaveReader::read(BasicAudioBlock<float>);
+template size_t WaveReader::read(BasicAudioBlock<double>);
+
 FILE* WaveReader::release() {
   auto pFile = mpFile;
 
@@ -364,6 +399,62 @@ FILE* WaveReader::release() {
 }
 
 
+ResamplingWaveReader::ResamplingWaveReader(
+    WaveReader&& reader, double outputRate, size_t tapsPerPhase)
+    : mReader(std::move(reader)) {
+  if(!mReader.isOpen()) return;
+
+  const auto& inputFormat = mReader.format();
+  mResampler =
+      Resampler(inputFormat.sampleRate, outputRate, int(inputFormat.numChannels), tapsPerPhase);
+  if(!mResampler.isValid()) return;
+
+  mInfo = inputFormat;
+  mInfo.sampleRate = mResampler.outputRate();
+  const auto numInputSamples = uint64_t(inputFormat.numSamples - mReader.samplePos());
+  const auto up = uint64_t(mResampler.outputRate()), down = uint64_t(mResampler.inputRate());
+  mInfo.numSamples = (unsigned int)((numInputSamples * up + down - 1) / down);
+
+  mInput.resize(int(mInfo.numChannels), kInputBlockSize);
+  mOutput.resize(int(mInfo.numChannels), mResampler.maxNumOutputSamples(kInputBlockSize));
+}
+
+decltype(AudioBlock::numSamples) ResamplingWaveReader::read(AudioBlock target) {
+  if(!isOpen()) {
+    V1_INVALID();
+    return 0;
+  }
+
+  V1_ASSERT(target.numChannels >= 0 && ((unsigned int)(target.numChannels)) <= mInfo.numChannels);
+
+  const auto numSamplesToRead = std::min(size_t(mInfo.numSamples - mSamplePos), target.numSamples);
+  size_t samplesRead = 0;
+  while(samplesRead < numSamplesToRead) {
+    if(mOutputPos == mOutputEnd) {
+      // after the end of the file, zeros flush out the filter
+      const auto numRead = mReader.empty() ? 0U : mReader.read(mInput.audioBlock());
+      if(numRead < kInputBlockSize) {
+        for(int chan = 0; chan < mInput.numChannels(); ++chan)
+          std::fill(mInput.channel(chan).begin() + numRead, mInput.channel(chan).end(), 0.f);
+      }
+      mOutputPos = 0;
+      mOutputEnd = mResampler.process(mInput.constAudioBlock(), mOutput.audioBlock());
+      continue;
+    }
+
+    const auto count = std::min(mOutputEnd - mOutputPos, numSamplesToRead - samplesRead);
+    for(int chan = 0; chan < target.numChannels; ++chan)
+      std::copy_n(mOutput.constChannel(chan).data() + mOutputPos, count,
+          target.channel(chan).data() + samplesRead);
+    mOutputPos += count;
+    samplesRead += count;
+  }
+
+  mSamplePos += (unsigned int)samplesRead;
+  return (unsigned int)samplesRead;
+}
+
+
 /******************************************************************************/
 
 WaveWriter::WaveWriter(
@@ -411,7 +502,8 @@ WaveWriter& WaveWriter::operator=(WaveWriter&& other) noexcept {
 }
 
 
-bool WaveWriter::write(ConstAudioBlock source) {
+template <typename Sample>
+bool WaveWriter::write(BasicConstAudioBlock<Sample> source) {
   if(!mpFile) {
     V1_INVALID();
     return false;
@@ -435,16 +527,16 @@ bool WaveWriter::write(ConstAudioBlock source) {
     break;
 
   case 16:
-    ok = convertInterleaveWrite<uint16_t, int16_t, 0x7FFFU>(
+    ok = convertInterleaveWrite<uint16_t, int16_t>(
         source, Span<uint16_t>((uint16_t*)pBuffer, bufferSizeB / bytesPerValue), toFile(mpFile));
     break;
 
   case 32:
     if(mInfo.isFloatingPoint)
-      ok = convertInterleaveWrite<float, float, 0U>(
+      ok = convertInterleaveWrite<float, float>(
           source, Span<float>((float*)pBuffer, bufferSizeB / bytesPerValue), toFile(mpFile));
     else
-      ok = convertInterleaveWrite<uint32_t, int32_t, 0x7FFF'FFFFU>(
+      ok = convertInterleaveWrite<uint32_t, int32_t>(
           source, Span<uint32_t>((uint32_t*)pBuffer, bufferSizeB / bytesPerValue), toFile(mpFile));
     break;
 
@@ -455,6 +547,11 @@ bool WaveWriter::write(ConstAudioBlock source) {
   return ok;
 }
 
+template bool WaveWriter::write(BasicConstAudioBlock<int16_t>);
+template bool WaveWriter::write(BasicConstAudioBlock<int32_t>);
+template bool WaveWriter::write(BasicConstAudioBlock<float>);
+template bool WaveWriter::write(BasicConstAudioBlock<double>);
+
 FILE* WaveWriter::release() {
   if(mpFile) writeWaveInfo(mpFile, mInfo);
 
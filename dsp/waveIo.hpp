@@ -1,6 +1,8 @@
 #pragma once
 
 #include "audioBlock.hpp"
+#include "audioBuffer.hpp"
+#include "resampler.hpp"
 
 #include "v1util/base/cpppainrelief.hpp"
 #include "v1util/stl-plus/filesystem-fwd.hpp"
@@ -46,8 +48,13 @@ class WaveReader {
   inline bool empty() const { return mpFile && mSamplePos >= mInfo.numSamples; }
   inline unsigned int samplePos() const { return mSamplePos; }
 
-  //! Reads samples into @p target, returning how many samples were read
-  decltype(AudioBlock::numSamples) read(AudioBlock target);
+  /** Reads samples into @p target, returning how many samples were read
+   *
+   * For int16_t, int32_t, float and double samples. If they are what the file contains, e.g.
+   * int16_t from a 16 bit file, they are copied without conversion, see convertSample().
+   */
+  template <typename Sample>
+  decltype(AudioBlock::numSamples) read(BasicAudioBlock<Sample> target);
 
   //! Relinquishes access to the current file handle, returning it.
   FILE* release();
@@ -58,6 +65,42 @@ class WaveReader {
   unsigned int mSamplePos = 0U;
 };
 
+/** A WaveReader whose output is converted to another sample rate, see Resampler
+ *
+ * format() reports the output rate and length: the input length, scaled by the ratio of the
+ * rates and rounded up. Output sample k is at input time k * inputRate / outputRate, without the
+ * latency of the Resampler.
+ */
+class ResamplingWaveReader {
+ public:
+  ResamplingWaveReader() = default;
+  ResamplingWaveReader(WaveReader&& reader, double outputRate,
+      size_t tapsPerPhase = Resampler::kDefaultTapsPerPhase);
+  V1_NO_CP_DEFAULT_MV(ResamplingWaveReader)
+
+  inline bool isOpen() const { return mReader.isOpen() && mResampler.isValid(); }
+  inline const WaveInfo& format() const { return mInfo; }
+
+  //! Returns whether all output has been read
+  inline bool empty() const { return isOpen() && mSamplePos >= mInfo.numSamples; }
+  inline unsigned int samplePos() const { return mSamplePos; }
+
+  //! Reads resampled samples into @p target, returning how many samples were read
+  decltype(AudioBlock::numSamples) read(AudioBlock target);
+
+ private:
+  static constexpr const size_t kInputBlockSize = 4096;
+
+  WaveReader mReader;
+  Resampler mResampler;
+  WaveInfo mInfo;
+  unsigned int mSamplePos = 0U;
+
+  AudioBuffer mInput;
+  AudioBuffer mOutput;  // resampled, [mOutputPos, mOutputEnd) not read yet
+  size_t mOutputPos = 0, mOutputEnd = 0;
+};
+
 /** Blocking RIFF Wave ("WAV") writer
  *
  * Caveat: This is just a bare-bones implementation.
@@ -78,8 +121,13 @@ class WaveWriter {
   inline bool isOpen() const { return mpFile; }
   inline const WaveInfo& format() const { return mInfo; }
 
-  //! Returns whether writing all samples was successful
-  bool write(ConstAudioBlock source);
+  //! Returns whether writing all samples was successful; converts as WaveReader::read() does
+  template <typename Sample>
+  bool write(BasicConstAudioBlock<Sample> source);
+  template <typename Sample>
+  bool write(BasicAudioBlock<Sample> source) {
+    return write(BasicConstAudioBlock<Sample>(source));
+  }
 
   //! Relinquishes access to the current file handle, returning it.
   FILE* release();
@@ -0,0 +1,216 @@
+#include "bench_baseline.hpp"
+
+#include "v1util/container/array_view.hpp"
+#include "v1util/stats/rank_test.hpp"
+#include "v1util/stl-plus/filesystem.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace v1util::bench {
+
+void SampleCollectingReporter::Report(const std::string& name, const std::string& params,
+    sltbench::Verdict verdict, std::chrono::nanoseconds timingResult) {
+  if(verdict == sltbench::Verdict::CRASHED) {
+    std::cerr << "ERROR: " << name << '/' << params << " crashed" << std::endl;
+    return;
+  }
+
+  auto key = std::make_pair(name, params);
+  auto iEntry = mIndexByNameAndArg.find(key);
+  if(iEntry == mIndexByNameAndArg.end()) {
+    iEntry = mIndexByNameAndArg.emplace(std::move(key), mResults.size()).first;
+    mResults.push_back({name, params, {}});
+  }
+  mResults[iEntry->second].samplesNs.push_back(double(timingResult.count()));
+}
+
+void SampleCollectingReporter::ReportWarning(sltbench::RunWarning warning) {
+  if(warning == sltbench::RunWarning::DEBUG_BUILD && !mWarnedAboutDebugBuild) {
+    mWarnedAboutDebugBuild = true;
+    std::cerr << "WARNING: benchmarks are compiled in debug mode" << std::endl;
+  }
+}
+
+
+/*
+ * Baseline files are JSON:
+ *   {"benchmarks": [{"name": "foo", "arg": "16", "samplesNs": [1234, 1240, ...]}, ...]}
+ *
+ * The reader only understands this very format, not JSON in general.
+ */
+
+namespace {
+
+void writeJsonString(std::ostream& os, const std::string& string) {
+  os << '"';
+  for(auto c : string) {
+    if(c == '"' || c == '\\')
+      os << '\\' << c;
+    else if(uint8_t(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", unsigned(c));
+      os << escaped;
+    } else
+      os << c;
+  }
+  os << '"';
+}
+
+class BaselineParser {
+ public:
+  explicit BaselineParser(std::string text) : mText(std::move(text)) {}
+
+  bool parse(std::vector<BenchmarkSamples>* pResults) {
+    if(!expect('{') || !expectKey("benchmarks") || !expect('[')) return false;
+    if(consume(']')) return expect('}');
+
+    do {
+      BenchmarkSamples samples;
+      if(!expect('{')) return false;
+      if(!expectKey("name") || !parseString(&samples.name) || !expect(',')) return false;
+      if(!expectKey("arg") || !parseString(&samples.arg) || !expect(',')) return false;
+      if(!expectKey("samplesNs") || !expect('[')) return false;
+      if(!consume(']')) {
+        do {
+          double value;
+          if(!parseNumber(&value)) return false;
+          samples.samplesNs.push_back(value);
+        } while(consume(','));
+        if(!expect(']')) return false;
+      }
+      if(!expect('}')) return false;
+      pResults->push_back(std::move(samples));
+    } while(consume(','));
+
+    return expect(']') && expect('}');
+  }
+
+ private:
+  void skipWhitespace() {
+    while(mPos < mText.size() && std::isspace(uint8_t(mText[mPos]))) ++mPos;
+  }
+
+  bool consume(char c) {
+    skipWhitespace();
+    if(mPos >= mText.size() || mText[mPos] != c) return false;
+    ++mPos;
+    return true;
+  }
+
+  bool expect(char c) {
+    if(consume(c)) return true;
+    std::cerr << "ERROR: baseline: expected '" << c << "' at offset " << mPos << std::endl;
+    return false;
+  }
+
+  bool expectKey(const char* pKey) {
+    std::string key;
+    if(!parseString(&key) || key != pKey || !expect(':')) {
+      std::cerr << "ERROR: baseline: expected key \"" << pKey << '"' << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool parseString(std::string* pString) {
+    if(!expect('"')) return false;
+    pString->clear();
+    while(mPos < mText.size()) {
+      auto c = mText[mPos++];
+      if(c == '"') return true;
+      if(c == '\\') {
+        if(mPos >= mText.size()) break;
+        c = mText[mPos++];
+        if(c == 'u') {
+          if(mPos + 4 > mText.size()) break;
+          c = char(std::strtoul(mText.substr(mPos, 4).c_str(), nullptr, 16));
+          mPos += 4;
+        }
+      }
+      pString->push_back(c);
+    }
+    return false;
+  }
+
+  bool parseNumber(double* pValue) {
+    skipWhitespace();
+    const char* pStart = mText.c_str() + mPos;
+    char* pEnd = nullptr;
+    *pValue = std::strtod(pStart, &pEnd);
+    if(pEnd == pStart) return false;
+    mPos += size_t(pEnd - pStart);
+    return true;
+  }
+
+  std::string mText;
+  size_t mPos = 0;
+};
+
+}  // namespace
+
+
+bool writeBaseline(
+    const std::filesystem::path& path, const std::vector<BenchmarkSamples>& results) {
+  std::ofstream file(path, std::ios_base::out | std::ios_base::trunc);
+  if(!file.good()) return false;
+
+  file << "{\"benchmarks\": [";
+  for(size_t i = 0; i < results.size(); ++i) {
+    const auto& samples = results[i];
+    file << (i ? ",\n  " : "\n  ") << "{\"name\": ";
+    writeJsonString(file, samples.name);
+    file << ", \"arg\": ";
+    writeJsonString(file, samples.arg);
+    file << ", \"samplesNs\": [";
+    for(size_t j = 0; j < samples.samplesNs.size(); ++j)
+      file << (j ? ", " : "") << int64_t(samples.samplesNs[j]);
+    file << "]}";
+  }
+  file << "\n]}\n";
+
+  return file.good();
+}
+
+bool readBaseline(const std::filesystem::path& path, std::vector<BenchmarkSamples>* pResults) {
+  std::ifstream file(path);
+  if(!file.good()) return false;
+
+  std::string text{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  pResults->clear();
+  return BaselineParser(std::move(text)).parse(pResults);
+}
+
+
+size_t reportSlowdowns(const std::vector<BenchmarkSamples>& baseline,
+    const std::vector<BenchmarkSamples>& current, double alpha, double minMedianRatio) {
+  size_t numSlowdowns = 0;
+  for(const auto& samples : current) {
+    auto iBaseline = std::find_if(baseline.begin(), baseline.end(), [&](const auto& candidate) {
+      return candidate.name == samples.name && candidate.arg == samples.arg;
+    });
+    if(iBaseline == baseline.end()) {
+      std::cout << "new: " << samples.name << '/' << samples.arg << std::endl;
+      continue;
+    }
+
+    const auto verdict = stats::detectSlowdown(make_array_view(iBaseline->samplesNs),
+        make_array_view(samples.samplesNs), alpha, minMedianRatio);
+    if(!verdict.isSlowdown) continue;
+
+    ++numSlowdowns;
+    char ratio[32];
+    snprintf(ratio, sizeof(ratio), "%+.1f%% (p = %.4f)", (verdict.medianRatio - 1.) * 100.,
+        verdict.pValue);
+    std::cout << "SLOWDOWN: " << samples.name << '/' << samples.arg << ": " << ratio << std::endl;
+  }
+
+  return numSlowdowns;
+}
+
+}  // namespace v1util::bench
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "v1util/stl-plus/filesystem-fwd.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace v1util::bench {
+
+//! Repeated timings of a single benchmark + argument combination
+struct BenchmarkSamples {
+  std::string name;
+  std::string arg;
+  std::vector<double> samplesNs;
+};
+
+//! sltbench reporter that collects the results of repeated runs instead of printing them
+class SampleCollectingReporter : public sltbench::reporter::IReporter {
+ public:
+  void ReportBenchmarkStarted() override {}
+  void ReportBenchmarkFinished() override {}
+  void Report(const std::string& name, const std::string& params, sltbench::Verdict verdict,
+      std::chrono::nanoseconds timingResult) override;
+  void ReportWarning(sltbench::RunWarning warning) override;
+
+  //! In order of first appearance
+  const std::vector<BenchmarkSamples>& results() const { return mResults; }
+
+ private:
+  std::vector<BenchmarkSamples> mResults;
+  std::map<std::pair<std::string, std::string>, size_t> mIndexByNameAndArg;
+  bool mWarnedAboutDebugBuild = false;
+};
+
+bool writeBaseline(const std::filesystem::path& path, const std::vector<BenchmarkSamples>& results);
+bool readBaseline(const std::filesystem::path& path, std::vector<BenchmarkSamples>* pResults);
+
+/** Print all benchmarks of @p current that are significantly slower than in @p baseline
+ *
+ * @return the number of slowdowns
+ */
+size_t reportSlowdowns(const std::vector<BenchmarkSamples>& baseline,
+    const std::vector<BenchmarkSamples>& current, double alpha, double minMedianRatio);
+
+}  // namespace v1util::bench
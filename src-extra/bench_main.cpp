@@ -0,0 +1,127 @@
+#include "bench_baseline.hpp"
+
+#include "v1util/base/platform.hpp"
+#include "v1util/base/thread.hpp"
+#include "v1util/stl-plus/filesystem.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+/*
+ * Entry point of v1util-bench
+ *
+ * Pass --reporter=json (or csv) for machine-readable results, --filter=<regex> to select
+ * benchmarks and --heatup=off to skip the CPU warm-up.
+ *
+ * Regression tracking:
+ *   --save-baseline=<file.json>     run all benchmarks --repetitions times and store the timings
+ *   --compare-baseline=<file.json>  run them again and report significant slowdowns only;
+ *                                   exits with 2 if there are any
+ *   --repetitions=<n>               defaults to 10; each repetition yields one sample
+ *   --alpha=<p>                     significance level, defaults to 0.01
+ *   --min-slowdown=<ratio>          ignore slowdowns of the median below, defaults to 1.02
+ *   --cpu=<index>                   pin the benchmarks to a logical CPU, defaults to 0
+ */
+
+namespace v1util::bench {
+namespace {
+
+std::string_view optionValue(int argc, char** argv, std::string_view option) {
+  for(int i = 1; i < argc; ++i) {
+    auto arg = std::string_view(argv[i]);
+    if(arg.size() > option.size() && arg.substr(0, option.size()) == option
+        && arg[option.size()] == '=')
+      return arg.substr(option.size() + 1);
+  }
+  return {};
+}
+
+//! Reduce noise: pin to a single CPU, raise priority, check for frequency scaling
+void calmDown(unsigned int cpuIndex) {
+  if(!setCurrentThreadAffinity(cpuIndex))
+    std::cerr << "WARNING: could not pin the benchmarks to CPU " << cpuIndex << std::endl;
+  if(!setCurrentThreadPriority(ThreadPriority::kHigh))
+    std::cerr << "NOTE: running with normal priority (no privileges for real-time scheduling)"
+              << std::endl;
+
+#if defined(V1_OS_LINUX)
+  auto governorPath = "/sys/devices/system/cpu/cpu" + std::to_string(cpuIndex)
+                      + "/cpufreq/scaling_governor";
+  std::ifstream governorFile(governorPath);
+  std::string governor;
+  if(governorFile >> governor && governor != "performance")
+    std::cerr << "WARNING: CPU frequency governor is '" << governor
+              << "', consider 'performance' for stable results" << std::endl;
+#endif
+}
+
+int runBaselineMode(int argc, char** argv) {
+  const auto savePath = optionValue(argc, argv, "--save-baseline");
+  const auto comparePath = optionValue(argc, argv, "--compare-baseline");
+
+  const auto repetitionsStr = optionValue(argc, argv, "--repetitions");
+  const auto alphaStr = optionValue(argc, argv, "--alpha");
+  const auto minSlowdownStr = optionValue(argc, argv, "--min-slowdown");
+  const auto cpuStr = optionValue(argc, argv, "--cpu");
+  const auto repetitions =
+      repetitionsStr.empty() ? 10 : std::atoi(std::string(repetitionsStr).c_str());
+  const auto alpha = alphaStr.empty() ? 0.01 : std::atof(std::string(alphaStr).c_str());
+  const auto minSlowdown =
+      minSlowdownStr.empty() ? 1.02 : std::atof(std::string(minSlowdownStr).c_str());
+  const auto cpuIndex = cpuStr.empty() ? 0 : std::atoi(std::string(cpuStr).c_str());
+  if(repetitions < 2 || cpuIndex < 0) {
+    std::cerr << "ERROR: need at least 2 repetitions and a valid CPU index" << std::endl;
+    return 1;
+  }
+
+  std::vector<BenchmarkSamples> baseline;
+  if(!comparePath.empty() && !readBaseline(std::filesystem::path(comparePath), &baseline)) {
+    std::cerr << "ERROR: could not read baseline " << comparePath << std::endl;
+    return 1;
+  }
+
+  calmDown(unsigned(cpuIndex));
+
+  sltbench::Init(argc, argv);
+  auto pCollector = new SampleCollectingReporter;
+  sltbench::GetConfig().SetReporter(std::unique_ptr<sltbench::reporter::IReporter>(pCollector));
+
+  for(int repetition = 0; repetition < repetitions; ++repetition) {
+    std::cerr << "repetition " << (repetition + 1) << '/' << repetitions << std::endl;
+    if(sltbench::Run() != 0) return 1;
+    sltbench::GetConfig().GetPrivate().SetHeatupRequired(false);  // once is enough
+  }
+
+  if(!savePath.empty() && !writeBaseline(std::filesystem::path(savePath), pCollector->results())) {
+    std::cerr << "ERROR: could not write baseline " << savePath << std::endl;
+    return 1;
+  }
+
+  if(!comparePath.empty()) {
+    const auto numSlowdowns =
+        reportSlowdowns(baseline, pCollector->results(), alpha, minSlowdown);
+    std::cout << numSlowdowns << " significant slowdown(s)" << std::endl;
+    if(numSlowdowns) return 2;
+  }
+
+  return 0;
+}
+
+}  // namespace
+}  // namespace v1util::bench
+
+
+int main(int argc, char** argv) {
+  using namespace v1util::bench;
+  if(!optionValue(argc, argv, "--save-baseline").empty()
+      || !optionValue(argc, argv, "--compare-baseline").empty())
+    return runBaselineMode(argc, argv);
+
+  return sltbench::Main(argc, argv);
+}
@@ -2,12 +2,13 @@
 
 #include "v1util/base/cpppainrelief.hpp"
 #include "v1util/base/debug.hpp"
+#include "v1util/base/thread_pool.hpp"
 #include "v1util/container/array_view.hpp"
-#include "v1util/container/range.hpp"
 
 #include <algorithm>
 #include <cfloat>
-#include <numeric>
+#include <cmath>
+#include <vector>
 
 
 namespace v1util { namespace stats {
@@ -17,42 +18,177 @@ struct DblMinMaxAvg {
   double min = 0.;
   double avg = 0.;
   double max = 0.;
+  double stddev = 0.;  // sample standard deviation; 0 for fewer than 2 elements
 };
 
+
+namespace detail {
+struct AggregatorMoments {
+  size_t count = 0;
+  double sum = 0.;
+  double min = DBL_MAX;
+  double max = -DBL_MAX;
+  double m2 = 0.;  // sum of squared deviations from the mean
+};
+
+constexpr const size_t kAggregatorLanes = 8;
+constexpr const size_t kAggregatorBlockSize = 1024;
+
+/** Moments of up to a few kAggregatorBlockSize elements
+ *
+ * The accumulators are split into independent lanes so that the compiler vectorizes the loops
+ * without reassociating floating point math. The second pass for the squared deviations reads
+ * the block again while it is still in L1.
+ */
+template <typename T>
+AggregatorMoments blockMoments(const T* pElements, size_t count) {
+  constexpr const size_t kLanes = kAggregatorLanes;
+  double sums[kLanes] = {};
+  double mins[kLanes];
+  double maxs[kLanes];
+  std::fill(mins, mins + kLanes, DBL_MAX);
+  std::fill(maxs, maxs + kLanes, -DBL_MAX);
+
+  const size_t vectorCount = count - count % kLanes;
+  for(size_t i = 0; i < vectorCount; i += kLanes) {
+    for(size_t lane = 0; lane < kLanes; ++lane) {
+      const auto element = double(pElements[i + lane]);
+      sums[lane] += element;
+      mins[lane] = element < mins[lane] ? element : mins[lane];
+      maxs[lane] = element > maxs[lane] ? element : maxs[lane];
+    }
+  }
+  for(size_t i = vectorCount; i < count; ++i) {
+    const auto element = double(pElements[i]);
+    sums[0] += element;
+    mins[0] = element < mins[0] ? element : mins[0];
+    maxs[0] = element > maxs[0] ? element : maxs[0];
+  }
+
+  AggregatorMoments result;
+  result.count = count;
+  for(size_t lane = 0; lane < kLanes; ++lane) {
+    result.sum += sums[lane];
+    result.min = std::min(result.min, mins[lane]);
+    result.max = std::max(result.max, maxs[lane]);
+  }
+
+  const auto mean = result.sum / double(count);
+  double m2s[kLanes] = {};
+  for(size_t i = 0; i < vectorCount; i += kLanes) {
+    for(size_t lane = 0; lane < kLanes; ++lane) {
+      const auto deviation = double(pElements[i + lane]) - mean;
+      m2s[lane] += deviation * deviation;
+    }
+  }
+  for(size_t i = vectorCount; i < count; ++i) {
+    const auto deviation = double(pElements[i]) - mean;
+    m2s[0] += deviation * deviation;
+  }
+  for(size_t lane = 0; lane < kLanes; ++lane) result.m2 += m2s[lane];
+
+  return result;
+}
+
+//! Chan et al.'s pairwise update
+inline void mergeMoments(AggregatorMoments& target, const AggregatorMoments& other) {
+  if(!other.count) return;
+  if(!target.count) {
+    target = other;
+    return;
+  }
+
+  const auto count = target.count + other.count;
+  const auto delta = other.sum / double(other.count) - target.sum / double(target.count);
+  target.m2 +=
+      other.m2 + delta * delta * (double(target.count) * double(other.count) / double(count));
+  target.count = count;
+  target.sum += other.sum;
+  target.min = std::min(target.min, other.min);
+  target.max = std::max(target.max, other.max);
+}
+}  // namespace detail
+
+
+/** Count, minimum, average, maximum and standard deviation of a stream of values
+ *
+ * Arrays are aggregated in a single pass over cache-sized blocks, so feeding arrays is much
+ * faster than feeding single values. Aggregators of disjoint parts of a stream can be merged,
+ * e.g. the per-thread results of feedParallel().
+ */
 class MinAvgMaxAggregator {
  public:
+  //! feedParallel() splits the input into chunks of this many elements
+  static constexpr const size_t kParallelChunkSize = 64 * detail::kAggregatorBlockSize;
+
   MinAvgMaxAggregator() = default;
   V1_DEFAULT_CP_MV(MinAvgMaxAggregator);
 
   template <typename T>
   void feed(v1util::ArrayView<T> elements) {
-    mGlobalCount += elements.size();
-    mGlobalSum = pmrange::accumulate(elements, mGlobalSum);
-    auto minmax = pmrange::minmax_element(elements);
-    mGlobalMin = std::min(double(*minmax.first), mGlobalMin);
-    mGlobalMax = std::max(double(*minmax.second), mGlobalMax);
+    const auto* pElements = elements.data();
+    for(size_t offset = 0; offset < elements.size(); offset += detail::kAggregatorBlockSize) {
+      const auto count = std::min(detail::kAggregatorBlockSize, elements.size() - offset);
+      detail::mergeMoments(mMoments, detail::blockMoments(pElements + offset, count));
+    }
   }
 
-  bool hasStats() const { return mGlobalCount > 0; }
+  void feed(double element) {
+    // Welford's update
+    const auto oldMean = mMoments.count ? mMoments.sum / double(mMoments.count) : element;
+    mMoments.count++;
+    mMoments.sum += element;
+    mMoments.m2 += (element - oldMean) * (element - mMoments.sum / double(mMoments.count));
+    mMoments.min = std::min(element, mMoments.min);
+    mMoments.max = std::max(element, mMoments.max);
+  }
+
+  /** Like feed(), but chunks of @p elements are aggregated on @p pool
+   *
+   * The chunks don't depend on the number of threads and are merged in order, so the result is
+   * the same on every machine. Inputs of a single chunk are fed on the calling thread.
+   */
+  template <typename T>
+  void feedParallel(v1util::ArrayView<T> elements, ThreadPool& pool = ThreadPool::global()) {
+    const auto numChunks = (elements.size() + kParallelChunkSize - 1) / kParallelChunkSize;
+    if(numChunks <= 1) {
+      feed(elements);
+      return;
+    }
+
+    std::vector<MinAvgMaxAggregator> partials(numChunks);
+    pool.parallelFor(numChunks, [&](size_t iChunk) {
+      const auto offset = iChunk * kParallelChunkSize;
+      partials[iChunk].feed(
+          elements.subview(offset, std::min(kParallelChunkSize, elements.size() - offset)));
+    });
+    for(const auto& partial : partials) merge(partial);
+  }
+
+  //! Add the values fed to @p other, as if they were fed to this aggregator
+  void merge(const MinAvgMaxAggregator& other) { detail::mergeMoments(mMoments, other.mMoments); }
+
+  bool hasStats() const { return mMoments.count > 0; }
 
   DblMinMaxAvg stats() const {
     V1_ASSERT(hasStats());
-    return {mGlobalCount, mGlobalMin, mGlobalSum / double(mGlobalCount), mGlobalMax};
+    const auto count = mMoments.count;
+    const auto stddev = count > 1 ? std::sqrt(mMoments.m2 / double(count - 1)) : 0.;
+    return {count, mMoments.min, mMoments.sum / double(count), mMoments.max, stddev};
   }
 
 
-  void _overrideData(size_t count, double sum, double max, double min) {
-    mGlobalCount = count;
-    mGlobalSum = sum;
-    mGlobalMax = max;
-    mGlobalMin = min;
+  //! @p stddev: the sample standard deviation, as in DblMinMaxAvg
+  void _overrideData(size_t count, double sum, double max, double min, double stddev = 0.) {
+    mMoments.count = count;
+    mMoments.sum = sum;
+    mMoments.max = max;
+    mMoments.min = min;
+    mMoments.m2 = count > 1 ? stddev * stddev * double(count - 1) : 0.;
   }
 
  private:
-  size_t mGlobalCount = 0;
-  double mGlobalSum = 0;
-  double mGlobalMax = -DBL_MAX;
-  double mGlobalMin = DBL_MAX;
+  detail::AggregatorMoments mMoments;
 };
 
 
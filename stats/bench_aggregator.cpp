@@ -0,0 +1,164 @@
+#include "aggregator.hpp"
+#include "histogram.hpp"
+#include "linear_regression.hpp"
+#include "quantile_sketch.hpp"
+
+#include "v1util/container/array_view.hpp"
+#include "v1util/container/span.hpp"
+
+#include "sltbench/Bench.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+namespace v1util::stats::bench {
+
+namespace {
+std::vector<float> makeTestData(size_t size) {
+  std::vector<float> data(size);
+  std::mt19937 rng(0xBADC0DEU);
+  std::uniform_real_distribution<float> distribution(-0.5f, 0.5f);
+  for(auto& element : data) element = distribution(rng);
+  return data;
+}
+
+class DataFixture {
+ public:
+  using Type = std::vector<float>;
+
+  Type& SetUp(const size_t& size) {
+    mData = makeTestData(size);
+    return mData;
+  }
+  void TearDown() {}
+
+ private:
+  Type mData;
+};
+
+const std::vector<size_t> sDataSizes = {256, 4096, 1U << 16};
+const std::vector<size_t> sLargeDataSizes = {1U << 16, 1U << 20, 1U << 23};
+}  // namespace
+
+void minAvgMaxAggregatorFeed(DataFixture::Type& data, const size_t&) {
+  MinAvgMaxAggregator aggregator;
+  aggregator.feed(make_array_view(data));
+  sltbench::DoNotOptimize(aggregator);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(minAvgMaxAggregatorFeed, DataFixture, sDataSizes);
+
+void minAvgMaxAggregatorFeedSingle(DataFixture::Type& data, const size_t&) {
+  MinAvgMaxAggregator aggregator;
+  for(auto element : data) aggregator.feed(double(element));
+  sltbench::DoNotOptimize(aggregator);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(minAvgMaxAggregatorFeedSingle, DataFixture, sDataSizes);
+
+void minAvgMaxAggregatorFeedLarge(DataFixture::Type& data, const size_t&) {
+  MinAvgMaxAggregator aggregator;
+  aggregator.feed(make_array_view(data));
+  sltbench::DoNotOptimize(aggregator);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(minAvgMaxAggregatorFeedLarge, DataFixture, sLargeDataSizes);
+
+void minAvgMaxAggregatorFeedParallel(DataFixture::Type& data, const size_t&) {
+  MinAvgMaxAggregator aggregator;
+  aggregator.feedParallel(make_array_view(data));
+  sltbench::DoNotOptimize(aggregator);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(
+    minAvgMaxAggregatorFeedParallel, DataFixture, sLargeDataSizes);
+
+void quantileSketchFeed(DataFixture::Type& data, const size_t&) {
+  QuantileSketch sketch;
+  sketch.feed(make_array_view(data));
+  sltbench::DoNotOptimize(sketch.quantile(0.99));
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(quantileSketchFeed, DataFixture, sDataSizes);
+
+//! The exact alternative: copy and partially sort the data
+void exactQuantileNthElement(DataFixture::Type& data, const size_t&) {
+  auto copy = data;
+  const auto iP99 = copy.begin() + ptrdiff_t(0.99 * double(copy.size() - 1));
+  std::nth_element(copy.begin(), iP99, copy.end());
+  sltbench::DoNotOptimize(*iP99);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(exactQuantileNthElement, DataFixture, sDataSizes);
+
+void simpleFloatHistogram(DataFixture::Type& data, const size_t&) {
+  std::array<HistogramBin<float>, 64> bins;
+  makeSimpleFloatHistogram(make_array_view(data), make_span(bins));
+  sltbench::DoNotOptimize(bins);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(simpleFloatHistogram, DataFixture, sDataSizes);
+
+void streamingHistogramLinear(DataFixture::Type& data, const size_t&) {
+  StreamingHistogram histogram(-0.5, 0.5, 64);
+  histogram.feed(make_array_view(data));
+  sltbench::DoNotOptimize(histogram);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(streamingHistogramLinear, DataFixture, sDataSizes);
+
+void streamingHistogramLog(DataFixture::Type& data, const size_t&) {
+  StreamingHistogram histogram(1e-4, 0.5, 64, HistogramScale::kLogarithmic);
+  histogram.feed(make_array_view(data));
+  sltbench::DoNotOptimize(histogram);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(streamingHistogramLog, DataFixture, sDataSizes);
+
+namespace {
+const std::vector<size_t> sNumSeries = {16, 256, 4096};
+
+class SeriesFixture {
+ public:
+  using Type = std::vector<float>;
+
+  //! x and y of one measurement per series
+  Type& SetUp(const size_t& numSeries) {
+    mData = makeTestData(2 * numSeries);
+    return mData;
+  }
+  void TearDown() {}
+
+ private:
+  Type mData;
+};
+}  // namespace
+
+//! One estimator per series, for comparison with the batched ones
+void linearSeriesEstimatorPerSeries(SeriesFixture::Type& data, const size_t& numSeries) {
+  static std::vector<LinearSeriesEstimator<float>> sEstimators;
+  sEstimators.resize(numSeries);
+  for(int step = 0; step < 16; ++step) {
+    for(size_t i = 0; i < numSeries; ++i)
+      sEstimators[i].feed(float(step) + data[i], data[numSeries + i]);
+  }
+  sltbench::DoNotOptimize(sEstimators[0].currentCoefficients());
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(linearSeriesEstimatorPerSeries, SeriesFixture, sNumSeries);
+
+template <LinearSeriesMode kMode>
+void batchedLinearSeriesEstimator(SeriesFixture::Type& data, const size_t& numSeries) {
+  BatchedLinearSeriesEstimator<float> estimator(numSeries, kMode);
+  estimator.setForgettingFactor(0.99f);
+  std::vector<float> dataX(numSeries);
+  const auto dataY = make_array_view(data).skip(numSeries);
+  for(int step = 0; step < 16; ++step) {
+    for(size_t i = 0; i < numSeries; ++i) dataX[i] = float(step) + data[i];
+    estimator.feed(make_array_view(dataX), dataY);
+  }
+  sltbench::DoNotOptimize(estimator.currentCoefficients(0));
+}
+void batchedLinearSeriesEstimatorExpAvg(SeriesFixture::Type& data, const size_t& numSeries) {
+  batchedLinearSeriesEstimator<LinearSeriesMode::kExpAvg>(data, numSeries);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(
+    batchedLinearSeriesEstimatorExpAvg, SeriesFixture, sNumSeries);
+void batchedLinearSeriesEstimatorRls(SeriesFixture::Type& data, const size_t& numSeries) {
+  batchedLinearSeriesEstimator<LinearSeriesMode::kRls>(data, numSeries);
+}
+SLTBENCH_FUNCTION_WITH_FIXTURE_AND_ARGS(batchedLinearSeriesEstimatorRls, SeriesFixture, sNumSeries);
+
+}  // namespace v1util::stats::bench
@@ -1,12 +1,16 @@
 #pragma once
 
+#include "v1util/base/cpppainrelief.hpp"
 #include "v1util/base/debug.hpp"
 #include "v1util/container/array_view.hpp"
-#include "v1util/container/range.hpp"
+#include "v1util/container/range_par.hpp"
 #include "v1util/container/span.hpp"
 
 #include <algorithm>
+#include <cfloat>
 #include <cmath>
+#include <cstdint>
+#include <vector>
 
 namespace v1util { namespace stats {
 
@@ -17,16 +21,23 @@ struct HistogramBin {
   size_t count = 0;
 };
 
+//! With a @p pPool, the range of large inputs is found in parallel
 template <typename T>
-void makeSimpleFloatHistogram(ArrayView<T> in, Span<HistogramBin<T>> outBins) {
+void makeSimpleFloatHistogram(
+    ArrayView<T> in, Span<HistogramBin<T>> outBins, ThreadPool* pPool = nullptr) {
   V1_ASSERT(!outBins.empty());
+  if(in.empty()) {
+    for(auto& bin : outBins) bin = HistogramBin<T>{};
+    return;
+  }
 
-  auto iMinmax = pmrange::minmax_element(in);
+  auto iMinmax = pmrange::par::minmax_element(in, pPool);
   auto min = *iMinmax.first;
   auto max = *iMinmax.second;
 
-  if(outBins.size() == 1) {
-    outBins.front() = HistogramBin<T>{min, max - min, in.size()};
+  if(outBins.size() == 1 || min == max) {
+    for(auto& bin : outBins) bin = HistogramBin<T>{min, max - min, 0};
+    outBins.front().count = in.size();
     return;
   }
 
@@ -38,10 +49,188 @@ void makeSimpleFloatHistogram(ArrayView<T> in, Span<HistogramBin<T>> outBins) {
   for(size_t i = 0; i < outBins.size(); ++i)
     *iBin++ = HistogramBin<T>{min + T(i) * binWidth, binWidth, 0};
 
+  // rounding may put the maximum one past the last bin
+  const auto invBinWidth = T(1) / binWidth;
+  const auto lastBin = outBins.size() - 1;
   for(const auto& datapoint : in) {
-    auto binIdx = size_t(std::floor((datapoint - min) / binWidth));
+    auto binIdx = std::min(size_t((datapoint - min) * invBinWidth), lastBin);
     outBins[binIdx].count++;
   }
 }
 
+
+enum class HistogramScale { kLinear, kLogarithmic };
+
+//! numBins bins between low and high, of equal width or equal ratio
+struct HistogramLayout {
+  double low = 0.;
+  double high = 1.;
+  uint32_t numBins = 1;
+  HistogramScale scale = HistogramScale::kLinear;
+
+  double binStart(uint32_t iBin) const {
+    const auto fraction = double(iBin) / double(numBins);
+    return scale == HistogramScale::kLinear ? low + fraction * (high - low)
+                                            : low * std::pow(high / low, fraction);
+  }
+  double binEnd(uint32_t iBin) const { return binStart(iBin + 1); }
+
+  bool operator==(const HistogramLayout& other) const {
+    return low == other.low && high == other.high && numBins == other.numBins &&
+           scale == other.scale;
+  }
+  bool operator!=(const HistogramLayout& other) const { return !operator==(other); }
+};
+
+//! The counts of a StreamingHistogram at some point in time
+struct HistogramSnapshot {
+  HistogramLayout layout;
+  std::vector<uint64_t> counts;  // per bin
+  uint64_t underflow = 0;        // below layout.low, including non-positive values on a log scale
+  uint64_t overflow = 0;         // above layout.high
+  uint64_t numInvalid = 0;       // NaNs
+
+  uint64_t total() const {
+    uint64_t sum = underflow + overflow;
+    for(auto count : counts) sum += count;
+    return sum;
+  }
+
+  //! false if the layouts differ
+  bool merge(const HistogramSnapshot& other) {
+    if(other.layout != layout) return false;
+    for(size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+    underflow += other.underflow;
+    overflow += other.overflow;
+    numInvalid += other.numInvalid;
+    return true;
+  }
+
+  std::vector<HistogramBin<double>> bins() const {
+    std::vector<HistogramBin<double>> result(counts.size());
+    for(uint32_t i = 0; i < layout.numBins; ++i) {
+      const auto start = layout.binStart(i);
+      result[i] = {start, layout.binEnd(i) - start, size_t(counts[i])};
+    }
+    return result;
+  }
+};
+
+
+/** Histogram with preset bins that is fed continuously, e.g. block by block
+ *
+ * Bins cover [low, high), the last one includes high. Bin indices are computed a block at a time
+ * by a multiply and a truncation, with selects instead of branches, so mixed inputs don't
+ * mispredict; logarithms are taken in a separate pass. The counts are split into interleaved
+ * sub-histograms, so that runs of equal bins don't serialize on store-to-load forwarding;
+ * snapshot() adds them up.
+ *
+ * For several threads, use one histogram per thread and merge their snapshots.
+ */
+class StreamingHistogram {
+ public:
+  StreamingHistogram(
+      double low, double high, uint32_t numBins, HistogramScale scale = HistogramScale::kLinear)
+      : mLayout{low, high, std::max(numBins, 1U), scale},
+        mStride(mLayout.numBins + kNumSpecialSlots),
+        mCounts(kNumSubHistograms * mStride, 0) {
+    V1_ASSERT(high > low);
+    V1_ASSERT(scale == HistogramScale::kLinear || low > 0.);
+    mOffset = scale == HistogramScale::kLinear ? low : std::log(low);
+    const auto range = scale == HistogramScale::kLinear ? high - low : std::log(high / low);
+    mScale = double(mLayout.numBins) / range;
+  }
+  V1_DEFAULT_CP_MV(StreamingHistogram);
+
+  template <typename T>
+  void feed(v1util::ArrayView<T> elements) {
+    constexpr const size_t kBlockSize = 256;
+    double mapped[kBlockSize];
+    uint32_t slots[kBlockSize];
+
+    for(size_t offset = 0; offset < elements.size(); offset += kBlockSize) {
+      const auto* pBlock = elements.data() + offset;
+      const auto blockSize = std::min(kBlockSize, elements.size() - offset);
+
+      if(mLayout.scale == HistogramScale::kLinear) {
+        for(size_t i = 0; i < blockSize; ++i) mapped[i] = double(pBlock[i]);
+      } else {
+        for(size_t i = 0; i < blockSize; ++i) mapped[i] = std::log(std::abs(double(pBlock[i])));
+      }
+      for(size_t i = 0; i < blockSize; ++i) slots[i] = slot(double(pBlock[i]), mapped[i]);
+
+      size_t i = 0;
+      for(; i + kNumSubHistograms <= blockSize; i += kNumSubHistograms) {
+        for(size_t sub = 0; sub < kNumSubHistograms; ++sub)
+          mCounts[sub * mStride + slots[i + sub]]++;
+      }
+      for(; i < blockSize; ++i) mCounts[slots[i]]++;
+    }
+  }
+
+  void feed(double value) {
+    mCounts[slot(value,
+        mLayout.scale == HistogramScale::kLinear ? value : std::log(std::abs(value)))]++;
+  }
+
+  //! false if the layouts differ
+  bool merge(const HistogramSnapshot& snapshot) {
+    if(snapshot.layout != mLayout) return false;
+    for(uint32_t i = 0; i < mLayout.numBins; ++i) mCounts[kFirstBinSlot + i] += snapshot.counts[i];
+    mCounts[kUnderflowSlot] += snapshot.underflow;
+    mCounts[overflowSlot()] += snapshot.overflow;
+    mCounts[invalidSlot()] += snapshot.numInvalid;
+    return true;
+  }
+
+  HistogramSnapshot snapshot() const {
+    HistogramSnapshot result;
+    result.layout = mLayout;
+    result.counts.assign(mLayout.numBins, 0);
+    for(size_t sub = 0; sub < kNumSubHistograms; ++sub) {
+      const auto* pCounts = mCounts.data() + sub * mStride;
+      for(uint32_t i = 0; i < mLayout.numBins; ++i) result.counts[i] += pCounts[kFirstBinSlot + i];
+      result.underflow += pCounts[kUnderflowSlot];
+      result.overflow += pCounts[overflowSlot()];
+      result.numInvalid += pCounts[invalidSlot()];
+    }
+    return result;
+  }
+
+  void clear() { std::fill(mCounts.begin(), mCounts.end(), 0); }
+
+  const HistogramLayout& layout() const { return mLayout; }
+
+ private:
+  static constexpr const size_t kNumSubHistograms = 4;
+  // slots per sub-histogram: underflow, the bins, overflow, invalid
+  static constexpr const uint32_t kNumSpecialSlots = 3;
+  static constexpr const uint32_t kUnderflowSlot = 0;
+  static constexpr const uint32_t kFirstBinSlot = 1;
+  uint32_t overflowSlot() const { return mLayout.numBins + 1; }
+  uint32_t invalidSlot() const { return mLayout.numBins + 2; }
+
+  /** @p mapped is @p value on a linear scale and log(|value|) on a log scale
+   *
+   * Only independent selects, no branches, so that compilers vectorize this; under- and overflow
+   * are decided by @p value, so rounding of @p mapped only moves values between adjacent bins.
+   */
+  inline uint32_t slot(double value, double mapped) const {
+    const auto lastBin = double(mLayout.numBins - 1);
+    auto position = (mapped - mOffset) * mScale;
+    position = position >= 0. ? position : 0.;  // also NaN and -inf
+    position = position <= lastBin ? position : lastBin;  // the last bin includes high
+    auto result = uint32_t(position) + kFirstBinSlot;
+    result = value > mLayout.high ? overflowSlot() : result;
+    result = value >= mLayout.low ? result : kUnderflowSlot;
+    return value == value ? result : invalidSlot();
+  }
+
+  HistogramLayout mLayout;
+  uint32_t mStride;
+  double mOffset = 0.;
+  double mScale = 1.;
+  std::vector<uint64_t> mCounts;  // kNumSubHistograms x mStride
+};
+
 }}  // namespace v1util::stats
@@ -3,10 +3,13 @@
 #include "v1util/base/cpppainrelief.hpp"
 #include "v1util/base/debug.hpp"
 #include "v1util/base/math.hpp"
-#include "v1util/container/range.hpp"
+#include "v1util/container/array_view.hpp"
+#include "v1util/container/range_par.hpp"
 
+#include <algorithm>
 #include <numeric>
 #include <type_traits>
+#include <vector>
 
 
 namespace v1util { namespace stats {
@@ -20,31 +23,32 @@ struct StraitCoefficients {
   T at(T x) const { return a * x + b; }
 
   bool operator==(const StraitCoefficients& o) const { return a == o.a && b == o.b; }
-  bool operator!=(const StraitCoefficients& o) const { return a != o.a && b != o.b; }
+  bool operator!=(const StraitCoefficients& o) const { return !operator==(o); }
   bool operator<(const StraitCoefficients& o) const { return a < o.a || (a == o.a && b < o.b); }
 };
 
-//! Estimate coefficients a, b for y(x) = ax + b
+//! Estimate coefficients a, b for y(x) = ax + b; averages large inputs on @p pPool, if given
 template <typename Container>
-auto linearRegression(const Container& dataX, const Container& dataY) {
+auto linearRegression(
+    const Container& dataX, const Container& dataY, ThreadPool* pPool = nullptr) {
   using T = std::remove_cv_t<typename Container::value_type>;
   V1_ASSERT(dataX.size() == dataY.size());
 
   T avgX;
   T avgY;
   if constexpr(std::is_integral_v<T>) {
-    avgX = roundIntDiv(pmrange::accumulate(dataX, T{0}), T(dataX.size()));
-    avgY = roundIntDiv(pmrange::accumulate(dataY, T{0}), T(dataY.size()));
+    avgX = roundIntDiv(pmrange::par::accumulate(dataX, T{0}, pPool), T(dataX.size()));
+    avgY = roundIntDiv(pmrange::par::accumulate(dataY, T{0}, pPool), T(dataY.size()));
   } else {
-    avgX = pmrange::accumulate(dataX, T{0}) / T(dataX.size());
-    avgY = pmrange::accumulate(dataY, T{0}) / T(dataY.size());
+    avgX = pmrange::par::accumulate(dataX, T{0}, pPool) / T(dataX.size());
+    avgY = pmrange::par::accumulate(dataY, T{0}, pPool) / T(dataY.size());
   }
 
   T deltaXYSum = 0;
   T deltaXSumSq = 0;
   auto iX = dataX.begin();
   auto iY = dataY.begin();
-  for(size_t i = 0; i < dataX.size(); ++i) {
+  for(size_t i = 0; i < dataX.size(); ++i, ++iX, ++iY) {
     auto deltaX = *iX - avgX;
     auto deltaY = *iY - avgY;
     deltaXYSum += deltaX * deltaY;
@@ -119,4 +123,175 @@ class LinearSeriesEstimator {
   T mLastX = {}, mLastY = {};
 };
 
+
+enum class LinearSeriesMode {
+  kExpAvg,  //!< exponential averaging of the coefficients of pairs, like LinearSeriesEstimator
+  kRls      //!< recursive least squares with a forgetting factor
+};
+
+namespace detail {
+// free functions, because compilers only trust __restrict on parameters
+
+template <typename T>
+void batchedExpAvgUpdate(const T* __restrict pX, const T* __restrict pY, T* __restrict pA,
+    T* __restrict pB, T* __restrict pLastX, T* __restrict pLastY, size_t count, T alpha) {
+  for(size_t i = 0; i < count; ++i) {
+    // the line through the last two measurements; series without progress in x keep theirs.
+    // Both selects come before the division, or gcc turns them into a branch around it, which
+    // it doesn't vectorize unless -fno-trapping-math; check with -fopt-info-vec when changing it.
+    const auto deltaX = pX[i] - pLastX[i];
+    const bool isValid = deltaX != T{0};
+    const auto divisor = isValid ? deltaX : T{1};
+    const auto weight = isValid ? alpha : T{0};
+    const auto a = (pY[i] - pLastY[i]) / divisor;
+    const auto b = (pY[i] + pLastY[i]) / 2 - a * (pX[i] + pLastX[i]) / 2;
+    pA[i] += weight * (a - pA[i]);
+    pB[i] += weight * (b - pB[i]);
+    pLastX[i] = pX[i];
+    pLastY[i] = pY[i];
+  }
+}
+
+template <typename T>
+void batchedRlsUpdate(const T* __restrict pX, const T* __restrict pY, T* __restrict pA,
+    T* __restrict pB, T* __restrict pLastX, T* __restrict pP00, T* __restrict pP01,
+    T* __restrict pP11, size_t count, T lambda, T invLambda) {
+  for(size_t i = 0; i < count; ++i) {
+    // move the origin to x: b becomes y(x), the covariance follows
+    const auto shift = pX[i] - pLastX[i];
+    auto a = pA[i];
+    auto b = pB[i] + a * shift;
+    const auto p00 = pP00[i];
+    const auto p01 = pP01[i] + shift * p00;
+    const auto p11 = pP11[i] + shift * (2 * pP01[i] + shift * p00);
+
+    // the regressor is (x - origin, 1) = (0, 1), which simplifies the update a lot
+    const auto denominator = T{1} / (lambda + p11);
+    const auto gainA = p01 * denominator;
+    const auto gainB = p11 * denominator;
+    const auto error = pY[i] - b;
+    a += gainA * error;
+    b += gainB * error;
+    pP00[i] = (p00 - gainA * p01) * invLambda;
+    pP01[i] = (p01 - gainA * p11) * invLambda;
+    pP11[i] = (p11 - gainB * p11) * invLambda;
+
+    pA[i] = a;
+    pB[i] = b;
+    pLastX[i] = pX[i];
+  }
+}
+}  // namespace detail
+
+/** LinearSeriesEstimator for many series at once, e.g. the clocks of many device streams
+ *
+ * Every feed() takes one measurement per series. The state is stored as a structure of arrays
+ * and updated without branches, so the compiler vectorizes the update across series.
+ *
+ * In kRls mode, every series is a least squares fit over all measurements, where older ones are
+ * weighted down by the forgetting factor per measurement. In contrast to averaging coefficients,
+ * this weights measurements by how much they tell about the slope, and noise doesn't bias the
+ * slope. The fit is kept relative to the last x of each series, so large x such as timestamps
+ * don't lose precision.
+ */
+template <typename T>
+class BatchedLinearSeriesEstimator {
+ public:
+  BatchedLinearSeriesEstimator() = default;
+  explicit BatchedLinearSeriesEstimator(
+      size_t numSeries, LinearSeriesMode mode = LinearSeriesMode::kExpAvg)
+      : mMode(mode) {
+    resize(numSeries);
+  }
+  V1_DEFAULT_CP_MV(BatchedLinearSeriesEstimator);
+
+  //! Also resets all series
+  void resize(size_t numSeries) {
+    for(auto* pArray : {&mA, &mB, &mLastX, &mLastY, &mP00, &mP01, &mP11})
+      pArray->assign(numSeries, T{0});
+    reset();
+  }
+
+  void reset() {
+    std::fill(mA.begin(), mA.end(), T{0});
+    std::fill(mB.begin(), mB.end(), T{0});
+    std::fill(mP00.begin(), mP00.end(), mInitialCovariance);
+    std::fill(mP01.begin(), mP01.end(), T{0});
+    std::fill(mP11.begin(), mP11.end(), mInitialCovariance);
+    mNumFed = 0;
+  }
+
+  //! Set alpha as used in exponential smoothing, for kExpAvg
+  void setAlpha(T alpha) { mAlpha = alpha; }
+
+  /** Weight of a measurement after the next one, for kRls
+   *
+   * 1 weights all measurements equally; 1 - 1/N remembers about the last N measurements.
+   */
+  void setForgettingFactor(T lambda) {
+    V1_ASSERT(lambda > T{0} && lambda <= T{1});
+    mLambda = lambda;
+    mInvLambda = T{1} / lambda;
+  }
+
+  //! Uncertainty of the initial coefficients for kRls, applied on reset()
+  void setInitialCovariance(T covariance) { mInitialCovariance = covariance; }
+
+  //! One measurement per series
+  void feed(ArrayView<T> dataX, ArrayView<T> dataY) {
+    V1_ASSERT(dataX.size() == numSeries() && dataY.size() == numSeries());
+    if(mNumFed++ == 0) {
+      pmrange::copy(dataX, mLastX);
+      if(mMode == LinearSeriesMode::kRls)
+        pmrange::copy(dataY, mB);  // fit relative to lastX, so b = y
+      else
+        pmrange::copy(dataY, mLastY);
+      return;
+    }
+
+    if(mMode == LinearSeriesMode::kRls) {
+      detail::batchedRlsUpdate(dataX.data(), dataY.data(), mA.data(), mB.data(), mLastX.data(),
+          mP00.data(), mP01.data(), mP11.data(), numSeries(), mLambda, mInvLambda);
+    } else {
+      detail::batchedExpAvgUpdate(dataX.data(), dataY.data(), mA.data(), mB.data(),
+          mLastX.data(), mLastY.data(), numSeries(), mAlpha);
+    }
+  }
+
+  StraitCoefficients<T> currentCoefficients(size_t series) const {
+    V1_ASSERT(series < numSeries());
+    if(mMode == LinearSeriesMode::kExpAvg) return {mA[series], mB[series]};
+    return {mA[series], mB[series] - mA[series] * mLastX[series]};
+  }
+
+  //! In kRls mode, y at @p x of @p series without the precision loss of currentCoefficients()
+  T estimate(size_t series, T x) const {
+    V1_ASSERT(series < numSeries());
+    if(mMode == LinearSeriesMode::kExpAvg) return mA[series] * x + mB[series];
+    return mA[series] * (x - mLastX[series]) + mB[series];
+  }
+
+  size_t numSeries() const { return mA.size(); }
+  LinearSeriesMode mode() const { return mMode; }
+
+ private:
+  static_assert(std::is_floating_point_v<T>);
+
+  LinearSeriesMode mMode = LinearSeriesMode::kExpAvg;
+  T mAlpha = 1;
+  T mLambda = 1;
+  T mInvLambda = 1;
+  T mInitialCovariance = T(1e6);
+  size_t mNumFed = 0;
+
+  // per series:
+  std::vector<T> mA;
+  std::vector<T> mB;  // kRls: relative to mLastX, i.e. the estimate at mLastX
+  std::vector<T> mLastX;
+  std::vector<T> mLastY;  // kExpAvg only
+  std::vector<T> mP00;    // kRls only: the symmetric covariance of (a, b)
+  std::vector<T> mP01;
+  std::vector<T> mP11;
+};
+
 }}  // namespace v1util::stats
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "v1util/base/cpppainrelief.hpp"
+#include "v1util/base/debug.hpp"
+#include "v1util/container/array_view.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+
+namespace v1util { namespace stats {
+
+namespace detail {
+/** Dense counts of a contiguous range of bin indices, in at most maxNumBins bins
+ *
+ * If a new index doesn't fit, the lowest bins are collapsed into one, so that the error bound
+ * holds for everything but the smallest magnitudes.
+ */
+class QuantileSketchStore {
+ public:
+  QuantileSketchStore() = default;
+  V1_DEFAULT_CP_MV(QuantileSketchStore);
+
+  bool empty() const { return !mTotal; }
+  uint64_t total() const { return mTotal; }
+  int32_t lowIndex() const { return mOffset; }
+  int32_t highIndex() const { return mOffset + int32_t(mCounts.size()) - 1; }
+  uint64_t count(int32_t index) const { return mCounts[size_t(index - mOffset)]; }
+
+  //! Make [minIndex, maxIndex] addressable through add(); indices below lowIndex() collapse
+  void extend(int32_t minIndex, int32_t maxIndex, uint32_t maxNumBins) {
+    const auto maxBins = int64_t(maxNumBins);
+    if(mCounts.empty()) {
+      mOffset = int32_t(std::max(int64_t(minIndex), maxIndex - maxBins + 1));
+      mCounts.assign(size_t(maxIndex - mOffset + 1), 0);
+      return;
+    }
+
+    const auto curLow = lowIndex();
+    const auto curHigh = highIndex();
+    if(minIndex >= curLow && maxIndex <= curHigh) return;
+
+    // grow with some slack, so that slowly drifting inputs don't extend on every call
+    const auto slack = int64_t(mCounts.size() / 2);
+    const auto neededHigh = int64_t(std::max(maxIndex, curHigh));
+    auto low = minIndex < curLow ? int64_t(minIndex) - slack : int64_t(curLow);
+    auto high = maxIndex > curHigh ? neededHigh + slack : int64_t(curHigh);
+    if(high - low + 1 > maxBins) high = std::max(neededHigh, low + maxBins - 1);
+    if(high - low + 1 > maxBins) low = high - maxBins + 1;
+
+    std::vector<uint64_t> counts(size_t(high - low + 1), 0);
+    for(size_t i = 0; i < mCounts.size(); ++i)
+      counts[size_t(std::max(int64_t(mOffset) + int64_t(i), low) - low)] += mCounts[i];
+    mCounts.swap(counts);
+    mOffset = int32_t(low);
+  }
+
+  //! @p index has to be <= highIndex()
+  void add(int32_t index, uint64_t count = 1) {
+    mCounts[size_t(std::max(index, mOffset) - mOffset)] += count;
+    mTotal += count;
+  }
+
+  //! For bulk updates: count into bins()[index - lowIndex()], then call addToTotal()
+  uint64_t* bins() { return mCounts.data(); }
+  void addToTotal(uint64_t count) { mTotal += count; }
+
+  void merge(const QuantileSketchStore& other, uint32_t maxNumBins) {
+    if(other.empty()) return;
+    extend(other.lowIndex(), other.highIndex(), maxNumBins);
+    for(auto index = other.lowIndex(); index <= other.highIndex(); ++index)
+      if(auto otherCount = other.count(index)) add(index, otherCount);
+  }
+
+  void clear() {
+    mCounts.clear();
+    mOffset = 0;
+    mTotal = 0;
+  }
+
+ private:
+  std::vector<uint64_t> mCounts;
+  int32_t mOffset = 0;
+  uint64_t mTotal = 0;
+};
+}  // namespace detail
+
+
+/** Quantiles of an unbounded stream in bounded memory (DDSketch)
+ *
+ * Values are counted in logarithmically spaced bins, so every quantile is returned with a
+ * relative error of at most relativeAccuracy(), independent of the distribution. If more than
+ * maxNumBins bins would be needed per sign, the bins of the smallest magnitudes are merged,
+ * which keeps the bound for all quantiles above them (in particular p50/p99/p999 of latencies).
+ *
+ * Sketches with the same relative accuracy merge losslessly, e.g. per-thread instances.
+ * NaNs are ignored.
+ */
+class QuantileSketch {
+ public:
+  explicit QuantileSketch(double relativeAccuracy = 0.01, uint32_t maxNumBins = 2048)
+      : mRelativeAccuracy(relativeAccuracy),
+        mGamma((1. + relativeAccuracy) / (1. - relativeAccuracy)),
+        mInvLogGamma(1. / std::log(mGamma)),
+        mMaxNumBins(std::max(maxNumBins, 1U)) {
+    V1_ASSERT(relativeAccuracy > 0. && relativeAccuracy < 1.);
+  }
+  V1_DEFAULT_CP_MV(QuantileSketch);
+
+  template <typename T>
+  void feed(v1util::ArrayView<T> elements) {
+    constexpr const size_t kBlockSize = 256;
+    int32_t indices[kBlockSize];
+    uint8_t kinds[kBlockSize];
+
+    for(size_t offset = 0; offset < elements.size(); offset += kBlockSize) {
+      const auto* pBlock = elements.data() + offset;
+      const auto blockSize = std::min(kBlockSize, elements.size() - offset);
+
+      // pass 1: bin indices and their range per kind, without branches on the sign
+      int32_t minIndices[kNumKinds], maxIndices[kNumKinds];
+      std::fill(minIndices, minIndices + kNumKinds, INT32_MAX);
+      std::fill(maxIndices, maxIndices + kNumKinds, INT32_MIN);
+      for(size_t i = 0; i < blockSize; ++i) {
+        const auto value = double(pBlock[i]);
+        const auto magnitude = std::abs(value);
+        const bool isIndexable = magnitude >= kMinIndexableValue;
+        const auto kind = isIndexable ? (value > 0. ? kPositive : kNegative)
+                                      : (value == value ? kZero : kIgnored);
+        const auto binIndex = index(isIndexable ? magnitude : 1.);  // 0 for the others
+        indices[i] = binIndex;
+        kinds[i] = uint8_t(kind);
+        minIndices[kind] = std::min(minIndices[kind], binIndex);
+        maxIndices[kind] = std::max(maxIndices[kind], binIndex);
+        mMin = std::min(mMin, value);  // ignores NaN
+        mMax = std::max(mMax, value);
+      }
+      for(auto kind : {kPositive, kNegative}) {
+        if(minIndices[kind] <= maxIndices[kind])
+          store(kind).extend(minIndices[kind], maxIndices[kind], mMaxNumBins);
+      }
+
+      // pass 2: count, without range checks
+      uint64_t ignored = 0;
+      uint64_t* pBins[kNumKinds] = {
+          mPositive.bins(), mNegative.bins(), &mZeroCount, &ignored};
+      const int32_t lowIndices[kNumKinds] = {mPositive.lowIndex(), mNegative.lowIndex(), 0, 0};
+      uint64_t numPerKind[kNumKinds] = {};
+      for(size_t i = 0; i < blockSize; ++i) {
+        const auto kind = kinds[i];
+        pBins[kind][std::max(indices[i], lowIndices[kind]) - lowIndices[kind]]++;
+        numPerKind[kind]++;
+      }
+      mPositive.addToTotal(numPerKind[kPositive]);
+      mNegative.addToTotal(numPerKind[kNegative]);
+    }
+  }
+
+  void feed(double value) {
+    if(value >= kMinIndexableValue) {
+      const auto i = index(value);
+      mPositive.extend(i, i, mMaxNumBins);
+      mPositive.add(i);
+    } else if(value <= -kMinIndexableValue) {
+      const auto i = index(-value);
+      mNegative.extend(i, i, mMaxNumBins);
+      mNegative.add(i);
+    } else if(value == value)
+      mZeroCount++;
+    else
+      return;
+    mMin = std::min(mMin, value);
+    mMax = std::max(mMax, value);
+  }
+
+  //! Add the values fed to @p other; false if the relative accuracies differ
+  bool merge(const QuantileSketch& other) {
+    if(other.mRelativeAccuracy != mRelativeAccuracy) return false;
+    mPositive.merge(other.mPositive, mMaxNumBins);
+    mNegative.merge(other.mNegative, mMaxNumBins);
+    mZeroCount += other.mZeroCount;
+    mMin = std::min(mMin, other.mMin);
+    mMax = std::max(mMax, other.mMax);
+    return true;
+  }
+
+  void clear() {
+    mPositive.clear();
+    mNegative.clear();
+    mZeroCount = 0;
+    mMin = DBL_MAX;
+    mMax = -DBL_MAX;
+  }
+
+  uint64_t count() const { return mPositive.total() + mNegative.total() + mZeroCount; }
+  bool empty() const { return !count(); }
+  double min() const { return mMin; }
+  double max() const { return mMax; }
+  double relativeAccuracy() const { return mRelativeAccuracy; }
+
+  //! The value at rank @p q * (count() - 1), for @p q in [0, 1]
+  double quantile(double q) const {
+    V1_ASSERT(!empty());
+    if(q <= 0.) return mMin;
+    if(q >= 1.) return mMax;
+
+    const auto rank = uint64_t(q * double(count() - 1));
+    uint64_t cumulative = 0;
+    if(!mNegative.empty()) {
+      for(auto i = mNegative.highIndex(); i >= mNegative.lowIndex(); --i) {
+        cumulative += mNegative.count(i);
+        if(cumulative > rank) return clamp(-value(i));
+      }
+    }
+    cumulative += mZeroCount;
+    if(cumulative > rank) return 0.;
+    if(!mPositive.empty()) {
+      for(auto i = mPositive.lowIndex(); i <= mPositive.highIndex(); ++i) {
+        cumulative += mPositive.count(i);
+        if(cumulative > rank) return clamp(value(i));
+      }
+    }
+    return mMax;
+  }
+
+ private:
+  static constexpr const double kMinIndexableValue = DBL_MIN;
+  enum Kind { kPositive, kNegative, kZero, kIgnored, kNumKinds };
+
+  detail::QuantileSketchStore& store(Kind kind) {
+    return kind == kPositive ? mPositive : mNegative;
+  }
+
+  int32_t index(double magnitude) const {
+    return int32_t(std::ceil(std::log(std::min(magnitude, DBL_MAX)) * mInvLogGamma));
+  }
+  //! The value with the least relative error to all magnitudes in bin @p index
+  double value(int32_t index) const {
+    return 2. * std::pow(mGamma, double(index)) / (mGamma + 1.);
+  }
+  double clamp(double value) const { return std::min(std::max(value, mMin), mMax); }
+
+  double mRelativeAccuracy;
+  double mGamma;
+  double mInvLogGamma;
+  uint32_t mMaxNumBins;
+
+  detail::QuantileSketchStore mPositive;
+  detail::QuantileSketchStore mNegative;  // by magnitude
+  uint64_t mZeroCount = 0;
+  double mMin = DBL_MAX;
+  double mMax = -DBL_MAX;
+};
+
+}}  // namespace v1util::stats
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "v1util/base/debug.hpp"
+#include "v1util/container/array_view.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace v1util { namespace stats {
+
+//! Alternative hypothesis of a rank test, i.e. what a small p-value hints at
+enum class RankTestAlternative {
+  kTwoSided,  //!< x and y are distributed differently
+  kLess,  //!< x tends to be smaller than y
+  kGreater,  //!< x tends to be greater than y
+};
+
+struct MannWhitneyResult {
+  //! U statistic of x: the number of pairs (x_i, y_j) with x_i > y_j, ties counting 1/2
+  double u = 0.;
+  double pValue = 1.;
+};
+
+
+namespace detail {
+//! P(U >= u) for sizes m, n without ties, by counting the arrangements of ranks for each U.
+inline double mannWhitneyExactUpperTail(size_t m, size_t n, double u) {
+  // counts[j][k]: number of arrangements of i x-values and j y-values with U == k. Iterate over i.
+  const auto maxU = m * n;
+  std::vector<std::vector<double>> counts(n + 1);
+  for(size_t j = 0; j <= n; ++j) counts[j].assign(1, 1.);  // i == 0: U is always 0
+
+  for(size_t i = 1; i <= m; ++i) {
+    // Adding the largest value of all i+j values: if it's an x, it contributes j to U.
+    std::vector<std::vector<double>> next(n + 1);
+    next[0].assign(1, 1.);
+    for(size_t j = 1; j <= n; ++j) {
+      next[j].assign(i * j + 1, 0.);
+      for(size_t k = 0; k < counts[j].size(); ++k) next[j][k + j] += counts[j][k];  // x largest
+      for(size_t k = 0; k < next[j - 1].size(); ++k) next[j][k] += next[j - 1][k];  // y largest
+    }
+    counts.swap(next);
+  }
+
+  const auto& distribution = counts[n];
+  V1_ASSERT(distribution.size() == maxU + 1);
+  double total = 0.;
+  double tail = 0.;
+  for(size_t k = 0; k <= maxU; ++k) {
+    total += distribution[k];
+    if(double(k) >= u - 1e-9) tail += distribution[k];
+  }
+  return tail / total;
+}
+
+inline double normalUpperTail(double z) {
+  return 0.5 * std::erfc(z / std::sqrt(2.));
+}
+}  // namespace detail
+
+
+/** Mann-Whitney U test (Wilcoxon rank-sum test) of two independent samples
+ *
+ * Non-parametric, i.e. it makes no assumption about the distributions. That makes it suitable
+ * for timings, which are typically skewed with a long tail towards slower.
+ *
+ * The p-value is exact for small samples without ties (m * n <= kMaxExactProduct) and uses the
+ * normal approximation with tie and continuity correction otherwise.
+ */
+template <typename T>
+MannWhitneyResult mannWhitneyU(ArrayView<T> x, ArrayView<T> y, RankTestAlternative alternative) {
+  constexpr const size_t kMaxExactProduct = 2500;
+
+  const auto m = x.size();
+  const auto n = y.size();
+  if(!m || !n) return {};
+
+  struct Ranked {
+    double value;
+    bool isX;
+  };
+  std::vector<Ranked> all;
+  all.reserve(m + n);
+  for(const auto& value : x) all.push_back({double(value), true});
+  for(const auto& value : y) all.push_back({double(value), false});
+  std::sort(all.begin(), all.end(),
+      [](const Ranked& a, const Ranked& b) { return a.value < b.value; });
+
+  // Sum of ranks of x (1-based), assigning tied values the average of their ranks
+  double rankSumX = 0.;
+  double tieCorrection = 0.;
+  for(size_t iStart = 0; iStart < all.size();) {
+    auto iEnd = iStart + 1;
+    while(iEnd < all.size() && all[iEnd].value == all[iStart].value) ++iEnd;
+
+    const auto tieSize = double(iEnd - iStart);
+    const auto avgRank = double(iStart + iEnd + 1) / 2.;
+    for(auto i = iStart; i < iEnd; ++i)
+      if(all[i].isX) rankSumX += avgRank;
+    tieCorrection += tieSize * tieSize * tieSize - tieSize;
+    iStart = iEnd;
+  }
+
+  MannWhitneyResult result;
+  result.u = rankSumX - double(m) * double(m + 1) / 2.;
+  const auto uOfY = double(m) * double(n) - result.u;
+
+  // P(U >= u) and P(U <= u), the latter by symmetry
+  double pGreater;
+  double pLess;
+  if(tieCorrection == 0. && m * n <= kMaxExactProduct) {
+    pGreater = detail::mannWhitneyExactUpperTail(m, n, result.u);
+    pLess = detail::mannWhitneyExactUpperTail(m, n, uOfY);
+  } else {
+    const auto count = double(m + n);
+    const auto mean = double(m) * double(n) / 2.;
+    const auto variance = double(m) * double(n) / 12.
+                          * ((count + 1.) - tieCorrection / (count * (count - 1.)));
+    if(variance <= 0.) return {result.u, 1.};
+
+    const auto sigma = std::sqrt(variance);
+    pGreater = detail::normalUpperTail((result.u - mean - 0.5) / sigma);
+    pLess = detail::normalUpperTail((mean - result.u - 0.5) / sigma);
+  }
+
+  switch(alternative) {
+  case RankTestAlternative::kTwoSided:
+    result.pValue = std::min(1., 2. * std::min(pGreater, pLess));
+    break;
+  case RankTestAlternative::kLess: result.pValue = pLess; break;
+  case RankTestAlternative::kGreater: result.pValue = pGreater; break;
+  }
+  return result;
+}
+
+
+struct SlowdownVerdict {
+  bool isSlowdown = false;
+  double medianRatio = 1.;  //!< median(current) / median(baseline)
+  double pValue = 1.;
+};
+
+/** Decide whether @p current is significantly slower than @p baseline
+ *
+ * Both contain repeated timings of the same thing. It's a slowdown if the timings are
+ * significantly greater (one-sided Mann-Whitney U test, p < @p alpha) and the medians differ by
+ * at least @p minMedianRatio, so that tiny but consistent differences are not reported.
+ */
+template <typename T>
+SlowdownVerdict detectSlowdown(
+    ArrayView<T> baseline, ArrayView<T> current, double alpha, double minMedianRatio) {
+  SlowdownVerdict verdict;
+  if(baseline.empty() || current.empty()) return verdict;
+
+  const auto median = [](ArrayView<T> view) {
+    std::vector<double> sorted(view.begin(), view.end());
+    std::sort(sorted.begin(), sorted.end());
+    const auto half = sorted.size() / 2;
+    return sorted.size() % 2 ? sorted[half] : (sorted[half - 1] + sorted[half]) / 2.;
+  };
+  const auto baselineMedian = median(baseline);
+  if(baselineMedian > 0.) verdict.medianRatio = median(current) / baselineMedian;
+
+  verdict.pValue = mannWhitneyU(current, baseline, RankTestAlternative::kGreater).pValue;
+  verdict.isSlowdown = verdict.pValue < alpha && verdict.medianRatio >= minMedianRatio;
+  return verdict;
+}
+
+}}  // namespace v1util::stats
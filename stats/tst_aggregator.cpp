@@ -0,0 +1,114 @@
+#include "aggregator.hpp"
+
+#include "v1util/base/thread_pool.hpp"
+#include "v1util/container/array_view.hpp"
+
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace v1util { namespace stats { namespace test {
+
+namespace {
+std::vector<float> makeData(size_t size, float offset) {
+  std::vector<float> data(size);
+  std::mt19937 rng(0x5EEDU);
+  std::uniform_real_distribution<float> distribution(offset, offset + 1.f);
+  for(auto& element : data) element = distribution(rng);
+  return data;
+}
+
+DblMinMaxAvg referenceStats(const std::vector<float>& data) {
+  double sum = 0.;
+  for(auto element : data) sum += element;
+  const auto avg = sum / double(data.size());
+  double m2 = 0.;
+  for(auto element : data) m2 += (element - avg) * (element - avg);
+  return {data.size(), double(*std::min_element(data.begin(), data.end())), avg,
+      double(*std::max_element(data.begin(), data.end())),
+      std::sqrt(m2 / double(data.size() - 1))};
+}
+
+void checkStats(const DblMinMaxAvg& actual, const DblMinMaxAvg& expected) {
+  CHECK(actual.count == expected.count);
+  CHECK(actual.min == expected.min);
+  CHECK(actual.max == expected.max);
+  CHECK(actual.avg == doctest::Approx(expected.avg).epsilon(1e-9));
+  CHECK(actual.stddev == doctest::Approx(expected.stddev).epsilon(1e-9));
+}
+}  // namespace
+
+TEST_CASE("MinAvgMaxAggregator-feed") {
+  MinAvgMaxAggregator aggregator;
+  CHECK(!aggregator.hasStats());
+  aggregator.feed(make_array_view(std::vector<float>()));
+  CHECK(!aggregator.hasStats());
+
+  aggregator.feed(3.);
+  CHECK(aggregator.stats().stddev == 0.);
+
+  const std::vector<double> values = {1., 2., 4.};
+  aggregator.feed(make_array_view(values));
+  const auto stats = aggregator.stats();
+  CHECK(stats.count == 4);
+  CHECK(stats.min == 1.);
+  CHECK(stats.max == 4.);
+  CHECK(stats.avg == doctest::Approx(2.5));
+  CHECK(stats.stddev == doctest::Approx(std::sqrt(5. / 3.)));
+
+  // block boundaries and lane remainders; a large offset tests numerical stability
+  for(size_t size : {1, 7, 8, 1023, 1024, 1025, 5000}) {
+    const auto data = makeData(size, 1e4f);
+    MinAvgMaxAggregator bulk;
+    bulk.feed(make_array_view(data));
+    MinAvgMaxAggregator single;
+    for(auto element : data) single.feed(double(element));
+    if(size > 1) {
+      checkStats(bulk.stats(), referenceStats(data));
+      checkStats(single.stats(), referenceStats(data));
+    }
+  }
+}
+
+TEST_CASE("MinAvgMaxAggregator-merge") {
+  const auto data = makeData(3000, -0.5f);
+  MinAvgMaxAggregator first, second, empty;
+  first.feed(make_array_view(data).first(1000));
+  second.feed(make_array_view(data).skip(1000));
+  first.merge(second);
+  first.merge(empty);
+  checkStats(first.stats(), referenceStats(data));
+
+  empty.merge(first);
+  checkStats(empty.stats(), referenceStats(data));
+
+  // restored stats merge as the aggregator they came from
+  const auto partial = referenceStats(std::vector<float>(data.begin(), data.begin() + 1000));
+  MinAvgMaxAggregator restored;
+  restored._overrideData(partial.count, partial.avg * double(partial.count), partial.max,
+      partial.min, partial.stddev);
+  checkStats(restored.stats(), partial);
+  restored.merge(second);
+  checkStats(restored.stats(), referenceStats(data));
+}
+
+TEST_CASE("MinAvgMaxAggregator-feedParallel") {
+  const auto data = makeData(5 * MinAvgMaxAggregator::kParallelChunkSize + 17, 1.f);
+
+  ThreadPool pool(3);
+  MinAvgMaxAggregator parallel;
+  parallel.feedParallel(make_array_view(data), pool);
+  checkStats(parallel.stats(), referenceStats(data));
+
+  // independent of the number of threads
+  ThreadPool serialPool(0);
+  MinAvgMaxAggregator serial;
+  serial.feedParallel(make_array_view(data), serialPool);
+  CHECK(serial.stats().avg == parallel.stats().avg);
+  CHECK(serial.stats().stddev == parallel.stats().stddev);
+}
+
+}}}  // namespace v1util::stats::test
@@ -0,0 +1,92 @@
+#include "histogram.hpp"
+
+#include "v1util/container/array_view.hpp"
+#include "v1util/container/span.hpp"
+
+#include "doctest/doctest.h"
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace v1util { namespace stats { namespace test {
+
+TEST_CASE("makeSimpleFloatHistogram") {
+  const std::vector<float> data = {0.f, 0.1f, 0.2f, 0.3f, 0.7f, 1.f};
+  std::array<HistogramBin<float>, 11> bins;
+  makeSimpleFloatHistogram(make_array_view(data), make_span(bins));
+  CHECK(bins.front().count == 1);
+  CHECK(bins.back().count == 1);  // the exact maximum
+  size_t total = 0;
+  for(const auto& bin : bins) total += bin.count;
+  CHECK(total == data.size());
+
+  const std::vector<float> constant = {2.f, 2.f};
+  makeSimpleFloatHistogram(make_array_view(constant), make_span(bins));
+  CHECK(bins.front().count == 2);
+  CHECK(bins.front().start == 2.f);
+}
+
+TEST_CASE("StreamingHistogram-linear") {
+  StreamingHistogram histogram(0., 1., 10);
+  const std::vector<float> block = {-0.5f, 0.f, 0.05f, 0.15f, 0.55f, 0.999f, 1.f, 1.5f, NAN};
+  for(int i = 0; i < 3; ++i) histogram.feed(make_array_view(block));
+  histogram.feed(0.25);
+
+  const auto snapshot = histogram.snapshot();
+  CHECK(snapshot.underflow == 3);
+  CHECK(snapshot.overflow == 3);
+  CHECK(snapshot.numInvalid == 3);
+  CHECK(snapshot.counts[0] == 6);
+  CHECK(snapshot.counts[1] == 3);
+  CHECK(snapshot.counts[2] == 1);
+  CHECK(snapshot.counts[5] == 3);
+  CHECK(snapshot.counts[9] == 6);  // 0.999 and the exact high
+  CHECK(snapshot.total() == 25);
+
+  const auto bins = snapshot.bins();
+  CHECK(bins[3].start == doctest::Approx(0.3));
+  CHECK(bins[3].width == doctest::Approx(0.1));
+}
+
+TEST_CASE("StreamingHistogram-log") {
+  // one bin per decade
+  StreamingHistogram histogram(1e-3, 1., 3, HistogramScale::kLogarithmic);
+  const std::vector<double> block = {-1., 0., 5e-4, 1e-3, 2e-3, 0.05, 0.5, 1., 2.};
+  histogram.feed(make_array_view(block));
+
+  const auto snapshot = histogram.snapshot();
+  CHECK(snapshot.underflow == 3);
+  CHECK(snapshot.counts[0] == 2);
+  CHECK(snapshot.counts[1] == 1);
+  CHECK(snapshot.counts[2] == 2);
+  CHECK(snapshot.overflow == 1);
+  CHECK(histogram.layout().binStart(1) == doctest::Approx(1e-2));
+}
+
+TEST_CASE("StreamingHistogram-merge") {
+  std::vector<float> data(1000);
+  for(size_t i = 0; i < data.size(); ++i) data[i] = float(i % 97) / 97.f;
+
+  StreamingHistogram whole(0., 1., 16), first(0., 1., 16), second(0., 1., 16);
+  whole.feed(make_array_view(data));
+  first.feed(make_array_view(data).first(333));
+  second.feed(make_array_view(data).skip(333));
+  CHECK(first.merge(second.snapshot()));
+
+  auto merged = first.snapshot();
+  CHECK(merged.counts == whole.snapshot().counts);
+  CHECK(merged.total() == data.size());
+
+  CHECK(merged.merge(whole.snapshot()));
+  CHECK(merged.total() == 2 * data.size());
+
+  StreamingHistogram other(0., 2., 16);
+  CHECK(!first.merge(other.snapshot()));
+  CHECK(!merged.merge(other.snapshot()));
+
+  first.clear();
+  CHECK(first.snapshot().total() == 0);
+}
+
+}}}  // namespace v1util::stats::test
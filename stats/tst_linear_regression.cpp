@@ -5,6 +5,8 @@
 #include "doctest/doctest.h"
 
 #include <cmath>
+#include <random>
+#include <vector>
 
 namespace v1util { namespace stats { namespace test {
 
@@ -73,5 +75,68 @@ TEST_CASE("linearSeriesEstimator-many") {
   CHECK(coeff2.b == doctest::Approx(7.f).epsilon(1 - targetAmount));
 }
 
+TEST_CASE("linearRegression-unordered") {
+  const auto dataX = {3., -1., 10., 4.};
+  const auto dataY = {8., 0., 22., 10.};  // y = 2x + 2
+  const auto coefficients = linearRegression(make_array_view(dataX), make_array_view(dataY));
+  CHECK(coefficients.a == doctest::Approx(2.));
+  CHECK(coefficients.b == doctest::Approx(2.));
+  CHECK(coefficients != StraitCoefficients<double>{2., 3.});
+}
+
+TEST_CASE("batchedLinearSeriesEstimator-expAvg") {
+  BatchedLinearSeriesEstimator<float> batch(2);
+  const auto targetAmount = 0.9f;
+  batch.setAlpha(alphaForExpAvgFromStepsToAmount(3.f, targetAmount));
+
+  // the first measurement only sets the start, then 3 steps
+  for(int x = 1; x <= 4; ++x) {
+    const std::vector<float> dataX = {float(x), float(x)};
+    const std::vector<float> dataY = {float(5 * x + 2), float(-x)};
+    batch.feed(make_array_view(dataX), make_array_view(dataY));
+  }
+
+  CHECK(batch.currentCoefficients(0).a == doctest::Approx(5.f * targetAmount));
+  CHECK(batch.currentCoefficients(0).b == doctest::Approx(2.f * targetAmount));
+  CHECK(batch.currentCoefficients(1).a == doctest::Approx(-1.f * targetAmount));
+  CHECK(batch.estimate(1, 10.f) == doctest::Approx(-9.f));
+
+  // series without progress in x keep their coefficients
+  const std::vector<float> sameX = {4.f, 5.f};
+  const std::vector<float> newY = {100.f, -5.f};
+  batch.feed(make_array_view(sameX), make_array_view(newY));
+  CHECK(batch.currentCoefficients(0).a == doctest::Approx(5.f * targetAmount));
+}
+
+TEST_CASE("batchedLinearSeriesEstimator-rls") {
+  // clock drift: sample counters against TSC-like timestamps, with jitter
+  constexpr const size_t kNumSeries = 5;
+  BatchedLinearSeriesEstimator<double> rls(kNumSeries, LinearSeriesMode::kRls);
+  rls.setForgettingFactor(0.999);
+  BatchedLinearSeriesEstimator<double> expAvg(kNumSeries);
+  expAvg.setAlpha(0.01);
+
+  std::vector<double> dataX(kNumSeries), dataY(kNumSeries);
+  std::mt19937 rng(0x1234U);
+  std::uniform_real_distribution<double> jitterDistribution(-1e4, 1e4);
+  for(int step = 0; step < 2000; ++step) {
+    for(size_t i = 0; i < kNumSeries; ++i) {
+      const auto jitter = jitterDistribution(rng);
+      dataX[i] = 1e12 + double(step) * 1e6 + jitter;
+      dataY[i] = double(step) * 48. * (1. + 1e-5 * double(i)) + 100. * double(i);
+    }
+    rls.feed(make_array_view(dataX), make_array_view(dataY));
+    expAvg.feed(make_array_view(dataX), make_array_view(dataY));
+  }
+
+  for(size_t i = 0; i < kNumSeries; ++i) {
+    const auto slope = 48e-6 * (1. + 1e-5 * double(i));
+    CHECK(rls.currentCoefficients(i).a == doctest::Approx(slope).epsilon(1e-6));
+    CHECK(std::abs(rls.estimate(i, dataX[i]) - dataY[i]) < 0.5);  // at most the jitter
+    // pairwise slopes suffer from the jitter much more
+    CHECK(std::abs(expAvg.currentCoefficients(i).a - slope)
+          > std::abs(rls.currentCoefficients(i).a - slope));
+  }
+}
 
 }}}  // namespace v1util::stats::test
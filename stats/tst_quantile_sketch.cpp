@@ -0,0 +1,100 @@
+#include "quantile_sketch.hpp"
+
+#include "v1util/container/array_view.hpp"
+
+#include "doctest/doctest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace v1util { namespace stats { namespace test {
+
+namespace {
+//! log-uniform over 6 decades, like latencies
+std::vector<double> makeLatencies(size_t size, uint32_t seed) {
+  std::vector<double> data(size);
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> exponent(-3., 3.);
+  for(auto& element : data) element = std::pow(10., exponent(rng));
+  return data;
+}
+
+double exactQuantile(std::vector<double> data, double q) {
+  const auto rank = size_t(q * double(data.size() - 1));
+  std::nth_element(data.begin(), data.begin() + rank, data.end());
+  return data[rank];
+}
+
+void checkQuantiles(const QuantileSketch& sketch, const std::vector<double>& data,
+    std::initializer_list<double> qs) {
+  for(auto q : qs) {
+    const auto exact = exactQuantile(data, q);
+    CHECK(std::abs(sketch.quantile(q) - exact) <= sketch.relativeAccuracy() * std::abs(exact));
+  }
+}
+}  // namespace
+
+TEST_CASE("QuantileSketch-accuracy") {
+  const auto data = makeLatencies(20000, 0xC0FFEEU);
+
+  QuantileSketch bulk(0.01);
+  CHECK(bulk.empty());
+  bulk.feed(make_array_view(data));
+  CHECK(bulk.count() == data.size());
+  checkQuantiles(bulk, data, {0.01, 0.25, 0.5, 0.9, 0.99, 0.999});
+  CHECK(bulk.quantile(0.) == *std::min_element(data.begin(), data.end()));
+  CHECK(bulk.quantile(1.) == *std::max_element(data.begin(), data.end()));
+
+  QuantileSketch single(0.01);
+  for(auto element : data) single.feed(element);
+  for(auto q : {0.1, 0.5, 0.99}) CHECK(single.quantile(q) == bulk.quantile(q));
+}
+
+TEST_CASE("QuantileSketch-signs") {
+  std::vector<float> data;
+  for(int i = -500; i <= 500; ++i) data.push_back(float(i) * 0.25f);
+  data.push_back(std::nanf(""));
+
+  QuantileSketch sketch(0.02);
+  sketch.feed(make_array_view(data));
+  CHECK(sketch.count() == 1001);
+  CHECK(sketch.quantile(0.5) == 0.);
+  CHECK(sketch.quantile(0.1) == doctest::Approx(-100.).epsilon(0.02));
+  CHECK(sketch.quantile(0.9) == doctest::Approx(100.).epsilon(0.02));
+  CHECK(sketch.min() == -125.);
+  CHECK(sketch.max() == 125.);
+}
+
+TEST_CASE("QuantileSketch-merge") {
+  const auto first = makeLatencies(5000, 1);
+  const auto second = makeLatencies(7000, 2);
+  auto all = first;
+  all.insert(all.end(), second.begin(), second.end());
+
+  QuantileSketch a, b, combined;
+  a.feed(make_array_view(first));
+  b.feed(make_array_view(second));
+  combined.feed(make_array_view(all));
+  CHECK(a.merge(b));
+  CHECK(a.count() == all.size());
+  for(auto q : {0.01, 0.5, 0.99, 0.999}) CHECK(a.quantile(q) == combined.quantile(q));
+
+  QuantileSketch otherAccuracy(0.05);
+  CHECK(!a.merge(otherAccuracy));
+}
+
+TEST_CASE("QuantileSketch-bounded_memory") {
+  // 128 bins at 1% cover about 1.1 decades; the lowest values collapse, the high ones don't
+  const auto data = makeLatencies(20000, 3);
+  QuantileSketch sketch(0.01, 128);
+  sketch.feed(make_array_view(data));
+  checkQuantiles(sketch, data, {0.9, 0.99, 0.999});
+  CHECK(sketch.quantile(0.1) < exactQuantile(data, 0.9));
+
+  sketch.clear();
+  CHECK(sketch.empty());
+}
+
+}}}  // namespace v1util::stats::test
@@ -0,0 +1,94 @@
+#include "rank_test.hpp"
+
+#include "v1util/container/array_view.hpp"
+
+#include "doctest/doctest.h"
+
+#include <random>
+#include <vector>
+
+namespace v1util { namespace stats { namespace test {
+
+TEST_CASE("mannWhitneyU-exact") {
+  const auto small = {1., 2., 3., 4., 5.};
+  const auto big = {6., 7., 8., 9., 10.};
+
+  auto result = mannWhitneyU(
+      make_array_view(small), make_array_view(big), RankTestAlternative::kLess);
+  CHECK(result.u == 0.);
+  CHECK(result.pValue == doctest::Approx(1. / 252.));
+
+  result = mannWhitneyU(
+      make_array_view(small), make_array_view(big), RankTestAlternative::kGreater);
+  CHECK(result.pValue == doctest::Approx(1.));
+
+  result = mannWhitneyU(
+      make_array_view(small), make_array_view(big), RankTestAlternative::kTwoSided);
+  CHECK(result.pValue == doctest::Approx(2. / 252.));
+
+  // Checked by enumerating all 35 arrangements:
+  const auto x = {1, 4, 6};
+  const auto y = {2, 3, 5, 7};
+  result = mannWhitneyU(make_array_view(x), make_array_view(y), RankTestAlternative::kGreater);
+  CHECK(result.u == 5.);
+  CHECK(result.pValue == doctest::Approx(24. / 35.));
+}
+
+TEST_CASE("mannWhitneyU-ties") {
+  const auto same = {3., 3., 3., 3.};
+  auto result = mannWhitneyU(
+      make_array_view(same), make_array_view(same), RankTestAlternative::kTwoSided);
+  CHECK(result.u == 8.);
+  CHECK(result.pValue == doctest::Approx(1.));
+
+  const auto x = {1., 2., 2., 3., 4., 4., 5.};
+  const auto y = {4., 5., 5., 6., 7., 7., 8.};
+  result = mannWhitneyU(make_array_view(x), make_array_view(y), RankTestAlternative::kLess);
+  CHECK(result.u == 3.);
+  CHECK(result.pValue < 0.01);
+}
+
+TEST_CASE("mannWhitneyU-large") {
+  std::vector<double> x;
+  std::vector<double> y;
+  std::mt19937 rng(42U);
+  std::uniform_real_distribution<double> distribution;
+  for(int i = 0; i < 200; ++i) {
+    x.push_back(distribution(rng));
+    y.push_back(distribution(rng));
+  }
+
+  auto result =
+      mannWhitneyU(make_array_view(x), make_array_view(y), RankTestAlternative::kTwoSided);
+  CHECK(result.pValue > 0.05);
+
+  for(auto& value : y) value += 0.1;
+  result = mannWhitneyU(make_array_view(x), make_array_view(y), RankTestAlternative::kLess);
+  CHECK(result.pValue < 0.01);
+  result = mannWhitneyU(make_array_view(x), make_array_view(y), RankTestAlternative::kGreater);
+  CHECK(result.pValue > 0.99);
+}
+
+TEST_CASE("detectSlowdown") {
+  const auto baseline = {100., 102., 99., 101., 100., 103., 100., 98.};
+  const auto sameish = {101., 100., 99., 102., 100., 100., 101., 99.};
+  const auto slower = {110., 112., 109., 111., 110., 113., 110., 108.};
+  const auto slightlySlower = {101., 103., 100., 102., 101., 104., 101., 99.5};
+
+  auto verdict = detectSlowdown(make_array_view(baseline), make_array_view(sameish), 0.01, 1.02);
+  CHECK(!verdict.isSlowdown);
+
+  verdict = detectSlowdown(make_array_view(baseline), make_array_view(slower), 0.01, 1.02);
+  CHECK(verdict.isSlowdown);
+  CHECK(verdict.medianRatio == doctest::Approx(1.1));
+
+  // Speedups are never reported:
+  verdict = detectSlowdown(make_array_view(slower), make_array_view(baseline), 0.01, 1.02);
+  CHECK(!verdict.isSlowdown);
+
+  // Not enough of a slowdown to bother:
+  verdict = detectSlowdown(make_array_view(baseline), make_array_view(slightlySlower), 0.5, 1.02);
+  CHECK(!verdict.isSlowdown);
+}
+
+}}}  // namespace v1util::stats::test